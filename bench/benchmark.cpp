@@ -0,0 +1,97 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "benchmark.h"
+
+//Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QStringList>
+#include <QtCore/QTextStream>
+#include <QtCore/QVector>
+
+//System
+#include <unistd.h>
+
+namespace {
+struct Entry {
+   const char*     name;
+   Bench::Function f   ;
+};
+
+QVector<Entry>& registry()
+{
+   static QVector<Entry> r;
+   return r;
+}
+
+bool failed = false;
+}
+
+Bench::Registrar::Registrar(const char* name, const Function& f)
+{
+   registry() << Entry {name, f};
+}
+
+void Bench::report(const char* name, const char* metric, qint64 value, const char* unit)
+{
+   QTextStream(stdout) << name << ' ' << metric << ' ' << value << ' ' << unit << endl;
+}
+
+qint64 Bench::residentMemory()
+{
+   QFile f("/proc/self/statm");
+
+   if (!f.open(QIODevice::ReadOnly))
+      return -1;
+
+   const QList<QByteArray> fields = f.readAll().split(' ');
+
+   return fields.size() > 1 ? fields[1].toLongLong() * (sysconf(_SC_PAGESIZE) / 1024) : -1;
+}
+
+qint64 Bench::measure(const Function& f)
+{
+   QElapsedTimer t;
+   t.start();
+   f();
+   return t.nsecsElapsed() / 1000;
+}
+
+void Bench::check(const char* name, const char* expectation, bool ok)
+{
+   if (ok)
+      return;
+
+   QTextStream(stderr) << name << ' ' << expectation << " FAILED" << endl;
+   failed = true;
+}
+
+///Run all benchmarks, or only those named on the command line
+int main(int argc, char** argv)
+{
+   QCoreApplication app(argc, argv);
+
+   const QStringList selected = app.arguments().mid(1);
+
+   for (const Entry& e : registry()) {
+      if (selected.isEmpty() || selected.contains(e.name))
+         e.f();
+   }
+
+   return failed ? 1 : 0;
+}
@@ -0,0 +1,59 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QElapsedTimer>
+
+//LibStdC++
+#include <functional>
+
+/**
+ * Minimal benchmark registry for ringclient_bench.
+ *
+ * Each benchmark is a free function declared with the BENCHMARK macro. They
+ * run in the order they are linked, after the QCoreApplication is created.
+ * The results are printed as "name metric value unit", one per line, so they
+ * can be compared between two builds with a simple diff.
+ */
+namespace Bench {
+
+typedef std::function<void()> Function;
+
+struct Registrar {
+   Registrar(const char* name, const Function& f);
+};
+
+///Print a single result line
+void report(const char* name, const char* metric, qint64 value, const char* unit);
+
+///Resident set size of the process, in kilobytes
+qint64 residentMemory();
+
+///Run `f` and return how long it took, in microseconds
+qint64 measure(const Function& f);
+
+///Report a broken expectation, ringclient_bench then exits with an error
+void check(const char* name, const char* expectation, bool ok);
+
+}
+
+#define BENCHMARK(name) \
+   static void bench_##name(); \
+   static Bench::Registrar bench_registrar_##name(#name, bench_##name); \
+   static void bench_##name()
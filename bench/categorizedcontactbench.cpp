@@ -0,0 +1,109 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "benchmark.h"
+
+//Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QStandardPaths>
+
+//Ring
+#include <categorizedcontactmodel.h>
+#include <fallbackpersoncollection.h>
+#include <person.h>
+#include <personmodel.h>
+
+/**
+ * Switch the CategorizedContactModel grouping role back and forth over 10k
+ * contacts. Each switch must be a single layout change, never a reset.
+ *
+ * The files are created in the Qt test mode data directory.
+ */
+BENCHMARK(categorizedcontact)
+{
+   static const int count         = 10000;
+   static const int organizations = 50;
+
+   QStandardPaths::setTestModeEnabled(true);
+
+   const QString dir = QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/categorizedcontactbench/";
+   QDir(dir).removeRecursively();
+   QDir().mkpath(dir);
+
+   for (int i = 0; i < count; i++) {
+      QFile f(dir + QString("bench%1.vcf").arg(i));
+      f.open(QIODevice::WriteOnly);
+      f.write(QString(
+         "BEGIN:VCARD\r\n"
+         "VERSION:2.1\r\n"
+         "UID:categorized%1\r\n"
+         "FN:%2 Person %1\r\n"
+         "ORG:Organization %3\r\n"
+         "TEL;TYPE=HOME:438%1\r\n"
+         "END:VCARD\r\n"
+      ).arg(i, 7, 10, QChar('0')).arg(QChar('A' + i % 26)).arg(i % organizations).toUtf8());
+   }
+
+   const int before = PersonModel::instance().rowCount();
+
+   PersonModel::instance().addCollection<FallbackPersonCollection,QString,FallbackPersonCollection*>(
+      dir, nullptr, LoadOptions::FORCE_ENABLED
+   );
+
+   QElapsedTimer timeout;
+   timeout.start();
+
+   while (PersonModel::instance().rowCount() - before < count && timeout.elapsed() < 60000)
+      QCoreApplication::processEvents();
+
+   CategorizedContactModel& model = CategorizedContactModel::instance();
+
+   //Insert the queued contacts, if the model already existed
+   QCoreApplication::processEvents();
+
+   int transactions = 0, resets = 0;
+   const auto count_tx    = [&transactions]() { transactions++; };
+   const auto count_reset = [&resets      ]() { resets++;       };
+
+   QObject::connect(&model, &QAbstractItemModel::layoutChanged, count_tx   );
+   QObject::connect(&model, &QAbstractItemModel::modelReset   , count_reset);
+
+   static const int rounds = 10;
+   qint64 total = 0, worst = 0;
+
+   for (int i = 0; i < rounds; i++) {
+      for (const int role : {static_cast<int>(Person::Role::Organization), static_cast<int>(Qt::DisplayRole)}) {
+         const qint64 elapsed = Bench::measure([&model, role]() {
+            model.setRole(role);
+         });
+
+         total += elapsed;
+         worst  = qMax(worst, elapsed);
+      }
+   }
+
+   Bench::report("categorizedcontact", "switch_avg", total / (rounds * 2)          , "us"   );
+   Bench::report("categorizedcontact", "switch_max", worst                         , "us"   );
+   Bench::report("categorizedcontact", "layouts"   , transactions                  , "count");
+   Bench::report("categorizedcontact", "resets"    , resets                        , "count");
+   Bench::report("categorizedcontact", "categories", model.rowCount()              , "count");
+
+   QDir(dir).removeRecursively();
+}
@@ -0,0 +1,95 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "benchmark.h"
+
+//Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QStandardPaths>
+
+//Ring
+#include <personmodel.h>
+#include <fallbackpersoncollection.h>
+
+/**
+ * Load 20k vCards from a FallbackPersonCollection. The worker thread queues
+ * the persons in the mediator and the main thread inserts them in chunks,
+ * the longest event loop iteration is the worst UI stall.
+ *
+ * The files are created in the Qt test mode data directory.
+ */
+BENCHMARK(collection)
+{
+   static const int count = 20000;
+
+   QStandardPaths::setTestModeEnabled(true);
+
+   const QString dir = QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/collectionbench/";
+   QDir(dir).removeRecursively();
+   QDir().mkpath(dir);
+
+   for (int i = 0; i < count; i++) {
+      QFile f(dir + QString("bench%1.vcf").arg(i));
+      f.open(QIODevice::WriteOnly);
+      f.write(QString(
+         "BEGIN:VCARD\r\n"
+         "VERSION:2.1\r\n"
+         "UID:bench%1\r\n"
+         "FN:Bench Person %1\r\n"
+         "TEL;TYPE=HOME:514%2\r\n"
+         "END:VCARD\r\n"
+      ).arg(i).arg(i, 7, 10, QChar('0')).toUtf8());
+   }
+
+   const qint64 memory = Bench::residentMemory();
+   const int    before = PersonModel::instance().rowCount();
+
+   int transactions = 0;
+   const auto conn = QObject::connect(&PersonModel::instance(), &QAbstractItemModel::rowsInserted,
+      [&transactions]() { transactions++; });
+
+   qint64 worst = 0;
+   QElapsedTimer total;
+   total.start();
+
+   PersonModel::instance().addCollection<FallbackPersonCollection,QString,FallbackPersonCollection*>(
+      dir, nullptr, LoadOptions::FORCE_ENABLED
+   );
+
+   //Give up after a minute rather than hang when some files are rejected
+   while (PersonModel::instance().rowCount() - before < count && total.elapsed() < 60000) {
+      const qint64 elapsed = Bench::measure([]() {
+         QCoreApplication::processEvents();
+      });
+      worst = qMax(worst, elapsed);
+   }
+
+   const qint64 load = total.nsecsElapsed() / 1000;
+
+   QObject::disconnect(conn);
+
+   Bench::report("collection", "load_all"           , load                                       , "us"   );
+   Bench::report("collection", "worst_iteration"    , worst                                      , "us"   );
+   Bench::report("collection", "insert_transactions", transactions                               , "count");
+   Bench::report("collection", "persons"            , PersonModel::instance().rowCount() - before, "count");
+   Bench::report("collection", "memory"             , Bench::residentMemory() - memory           , "kB"   );
+
+   QDir(dir).removeRecursively();
+}
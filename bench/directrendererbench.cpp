@@ -0,0 +1,73 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "benchmark.h"
+
+//Qt
+#include <QtCore/QSize>
+
+//Ring
+#include <private/directrenderer.h>
+
+/**
+ * Push frames through a DirectRenderer like the daemon does while a client
+ * holds the previous frame handle. Once the pool is warm, no frame buffer
+ * may be allocated anymore.
+ */
+BENCHMARK(directrenderer)
+{
+   static const int         warmup = 10;
+   static const int         count  = 1000;
+   static const QSize       res(1920, 1080);
+   static const std::size_t bytes  = res.width() * res.height() * 4;
+
+   Video::DirectRenderer renderer("bench", res);
+   renderer.startRendering();
+
+   const DRing::SinkTarget& target = renderer.target();
+
+   QSharedPointer<const Video::Frame> held;
+
+   const auto deliver = [&target, &renderer, &held]() {
+      auto buf = target.pull(bytes);
+      buf->ptr[0] = 0;
+      target.push(std::move(buf));
+
+      //The client paints the new frame and drops the previous one
+      held = renderer.sharedFrame();
+   };
+
+   for (int i = 0; i < warmup; i++)
+      deliver();
+
+   const quint64 allocations = renderer.frameAllocationCount();
+
+   const qint64 elapsed = Bench::measure([&deliver]() {
+      for (int i = 0; i < count; i++)
+         deliver();
+   });
+
+   const qint64 steady = renderer.frameAllocationCount() - allocations;
+
+   held.clear();
+   renderer.stopRendering();
+
+   Bench::report("directrenderer", "frame_avg"              , elapsed * 1000 / count          , "ns"   );
+   Bench::report("directrenderer", "steady_allocations"     , steady                          , "count");
+   Bench::report("directrenderer", "pool_allocations"       , renderer.frameAllocationCount() , "count");
+   Bench::check ("directrenderer", "steady_allocations == 0", steady == 0                            );
+}
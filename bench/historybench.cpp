@@ -0,0 +1,84 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "benchmark.h"
+
+//Qt
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QTextStream>
+
+//Ring
+#include <call.h>
+#include <categorizedhistorymodel.h>
+#include <localhistorycollection.h>
+
+/**
+ * Load a 100k calls history. The legacy history.ini is imported into the
+ * journal, then the first window and finally every call are created.
+ *
+ * The files are created in the Qt test mode data directory.
+ */
+BENCHMARK(history)
+{
+   static const int count  = 100000;
+   static const int window = 50;
+
+   QStandardPaths::setTestModeEnabled(true);
+
+   const QString dir = QStandardPaths::writableLocation(QStandardPaths::DataLocation);
+   QDir().mkpath(dir);
+   QFile::remove(dir + "/history.journal");
+
+   {
+      QFile ini(dir + "/history.ini");
+      ini.open(QIODevice::WriteOnly | QIODevice::Text);
+      QTextStream stream(&ini);
+
+      const qint64 start = 1420070400;
+
+      for (int i = 0; i < count; i++) {
+         stream << Call::HistoryMapFields::CALLID          << '=' << QString::number(i, 16)                      << '\n'
+                << Call::HistoryMapFields::TIMESTAMP_START << '=' << start + i * 60                              << '\n'
+                << Call::HistoryMapFields::TIMESTAMP_STOP  << '=' << start + i * 60 + 30                         << '\n'
+                << Call::HistoryMapFields::PEER_NUMBER     << '=' << QString("514%1").arg(i % 5000, 7, 10, QChar('0')) << '\n'
+                << Call::HistoryMapFields::DIRECTION       << '=' << Call::HistoryStateName::OUTGOING            << '\n'
+                << Call::HistoryMapFields::MISSED          << '=' << 0                                           << "\n\n";
+      }
+   }
+
+   const qint64 memory = Bench::residentMemory();
+
+   CategorizedHistoryModel::instance().setHistoryEnabled(true);
+   CategorizedHistoryModel::instance().setHistoryWindow(window);
+
+   const qint64 load = Bench::measure([]() {
+      CategorizedHistoryModel::instance().addCollection<LocalHistoryCollection>(LoadOptions::FORCE_ENABLED);
+   });
+
+   //Scroll to the end of the history, one window at a time
+   const qint64 all = Bench::measure([]() {
+      while (CategorizedHistoryModel::instance().canFetchMore({}))
+         CategorizedHistoryModel::instance().fetchMore({});
+   });
+
+   Bench::report("history", "import_and_first_window", load                                 , "us");
+   Bench::report("history", "load_all"               , all                                  , "us");
+   Bench::report("history", "memory"                 , Bench::residentMemory() - memory     , "kB");
+   Bench::report("history", "journal_size"           , QFile(dir + "/history.journal").size(), "B" );
+}
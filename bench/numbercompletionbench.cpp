@@ -0,0 +1,90 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "benchmark.h"
+
+//Qt
+#include <QtCore/QDebug>
+
+//Ring
+#include <call.h>
+#include <callmodel.h>
+#include <contactmethod.h>
+#include <numbercompletionmodel.h>
+#include <phonedirectorymodel.h>
+
+/**
+ * Type a number one character at a time in a dialing call and measure each
+ * NumberCompletionModel refresh, with a 10k, 50k and 100k entries directory.
+ * Every keystroke must produce few structural model transactions.
+ */
+BENCHMARK(numbercompletion)
+{
+   Call* call = CallModel::instance().dialingCall();
+
+   if (!call) {
+      qWarning() << "numbercompletion: no account available to dial, skipped";
+      return;
+   }
+
+   static const QString number = "5145559999";
+   int created = 0;
+
+   for (const int count : {10000, 50000, 100000}) {
+      //The directory only grows, add what the previous round didn't create
+      for (; created < count; created++)
+         PhoneDirectoryModel::instance().getNumber(QString("514%1").arg(created * 7919 % 10000000, 7, 10, QChar('0')));
+
+      NumberCompletionModel model;
+
+      int transactions = 0;
+      const auto count_tx = [&transactions]() { transactions++; };
+
+      QObject::connect(&model, &QAbstractItemModel::rowsInserted , count_tx);
+      QObject::connect(&model, &QAbstractItemModel::rowsRemoved  , count_tx);
+      QObject::connect(&model, &QAbstractItemModel::rowsMoved    , count_tx);
+      QObject::connect(&model, &QAbstractItemModel::layoutChanged, count_tx);
+
+      call->setDialNumber(QString());
+      model.setCall(call);
+
+      qint64 total = 0, worst = 0;
+      int    worstTx = 0;
+
+      for (int i = 1; i <= number.size(); i++) {
+         transactions = 0;
+
+         const qint64 elapsed = Bench::measure([call, i]() {
+            call->setDialNumber(number.left(i));
+         });
+
+         total   += elapsed;
+         worst    = qMax(worst, elapsed);
+         worstTx  = qMax(worstTx, transactions);
+      }
+
+      const QByteArray suffix = '_' + QByteArray::number(count / 1000) + 'k';
+
+      Bench::report("numbercompletion", ("keystroke_avg"        + suffix).constData(), total / number.size(), "us" );
+      Bench::report("numbercompletion", ("keystroke_max"        + suffix).constData(), worst                , "us" );
+      Bench::report("numbercompletion", ("transactions_per_key" + suffix).constData(), worstTx              , "max");
+
+      model.setCall(nullptr);
+   }
+
+   call << Call::Action::REFUSE;
+}
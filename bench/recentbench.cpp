@@ -0,0 +1,57 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "benchmark.h"
+
+//Ring
+#include <contactmethod.h>
+#include <phonedirectorymodel.h>
+#include <recentmodel.h>
+
+/**
+ * Fill RecentModel with 10k contact methods, then move old entries back to
+ * the top, as a new call or message to an old contact does.
+ */
+BENCHMARK(recent)
+{
+   static const int count = 10000;
+   static const int moves = 1000;
+
+   RecentModel::instance();
+
+   QVector<ContactMethod*> numbers;
+   numbers.reserve(count);
+
+   for (int i = 0; i < count; i++)
+      numbers << PhoneDirectoryModel::instance().getNumber(QString("438%1").arg(i, 7, 10, QChar('0')));
+
+   const time_t start = 1420070400;
+
+   const qint64 fill = Bench::measure([&numbers, start]() {
+      for (int i = 0; i < count; i++)
+         numbers[i]->setLastUsed(start + i);
+   });
+
+   const qint64 move = Bench::measure([&numbers, start]() {
+      for (int i = 0; i < moves; i++)
+         numbers[(i * 7919) % count]->setLastUsed(start + count + i);
+   });
+
+   Bench::report("recent", "insert_avg", fill * 1000 / count, "ns");
+   Bench::report("recent", "move_avg"  , move * 1000 / moves, "ns");
+   Bench::report("recent", "rows"      , RecentModel::instance().rowCount(), "rows");
+}
@@ -0,0 +1,201 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "benchmark.h"
+
+//Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QEventLoop>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QVector>
+
+//Ring
+#include <accountmodel.h>
+#include <call.h>
+#include <callmodel.h>
+#include <categorizedhistorymodel.h>
+#include <contactmethod.h>
+#include <localhistorycollection.h>
+#include <phonedirectorymodel.h>
+#include <recentmodel.h>
+#include "private/videorenderermanager.h"
+#include "qtwrapper/standin/standin.h"
+
+namespace {
+
+struct Latency {
+   qint64 total;
+   qint64 worst;
+   int    count;
+
+   void add(qint64 elapsed) {
+      total += elapsed;
+      worst  = qMax(worst, elapsed);
+      count++;
+   }
+
+   void report(const char* event) const {
+      Bench::report("standin", (QByteArray(event) + "_avg").constData(), count ? total / count : 0, "us");
+      Bench::report("standin", (QByteArray(event) + "_max").constData(), worst                    , "us");
+   }
+};
+
+///Upper bound, in milliseconds, of the time spent delivering one event
+static const int DELIVERY_DEADLINE = 1000;
+
+/**
+ * Run the event loop until nothing is left to process. The callbacks post
+ * more events (the queued collection items, the call details replies), so
+ * posted events alone are not enough.
+ */
+void flush()
+{
+   QCoreApplication::processEvents(QEventLoop::AllEvents, DELIVERY_DEADLINE);
+}
+
+///Trigger a daemon event and deliver the callbacks it dispatched
+qint64 deliver(const Bench::Function& f)
+{
+   return Bench::measure([&f]() {
+      f();
+      flush();
+   });
+}
+
+}
+
+/**
+ * Load CallModel, PhoneDirectoryModel, CategorizedHistoryModel, RecentModel
+ * and the renderers through the stand-in daemon, without a real daemon.
+ *
+ * The event latency is the time between the daemon callback and the end of
+ * the model update. Run it alone ("ringclient_bench standin") for the
+ * startup time to include the model creation.
+ */
+BENCHMARK(standin)
+{
+   static const int calls    = 1000;
+   static const int messages = 1000;
+   static const int presence = 1000;
+   static const int frames   = 300;
+
+   const std::string account = "standin";
+
+   QStandardPaths::setTestModeEnabled(true);
+
+   const qint64 memory = Bench::residentMemory();
+
+   const qint64 startup = Bench::measure([]() {
+      AccountModel           ::instance();
+      CallModel              ::instance();
+      PhoneDirectoryModel    ::instance();
+      RecentModel            ::instance();
+      VideoRendererManager   ::instance();
+
+      if (!CategorizedHistoryModel::instance().hasCollections())
+         CategorizedHistoryModel::instance().addCollection<LocalHistoryCollection>(LoadOptions::FORCE_ENABLED);
+
+      flush();
+   });
+
+   Bench::report("standin", "startup"       , startup                           , "us");
+   Bench::report("standin", "startup_memory", Bench::residentMemory() - memory  , "kB");
+
+   //Incoming calls, their details come from the stand-in daemon
+   Latency incoming {0, 0, 0};
+   QVector<std::string> ids;
+   ids.reserve(calls);
+
+   for (int i = 0; i < calls; i++) {
+      incoming.add(deliver([&ids, &account, i]() {
+         ids << StandIn::incomingCall(account, "sip:" + std::to_string(5140000000LL + i) + "@localhost");
+      }));
+   }
+
+   int withDetails = 0;
+
+   for (const std::string& id : ids) {
+      const Call* c = CallModel::instance().getCall(QString::fromStdString(id));
+
+      if (c && c->peerContactMethod() && !c->peerContactMethod()->uri().isEmpty())
+         withDetails++;
+   }
+
+   //Answer, hold, resume and hang up every call
+   static const char* sequence[] = { "CURRENT", "HOLD", "CURRENT", "HUNGUP", "OVER" };
+
+   Latency transitions {0, 0, 0};
+   const int history = CategorizedHistoryModel::instance().getHistoryCalls().size();
+
+   for (const char* state : sequence) {
+      for (const std::string& id : ids) {
+         transitions.add(deliver([&id, state]() {
+            StandIn::setCallState(id, state);
+         }));
+      }
+   }
+
+   Latency message {0, 0, 0};
+
+   for (int i = 0; i < messages; i++) {
+      message.add(deliver([&account, i]() {
+         StandIn::accountMessage(account, "sip:" + std::to_string(5140000000LL + i % 100) + "@localhost",
+            {{ "text/plain", "Stand-in message " + std::to_string(i) }}
+         );
+      }));
+   }
+
+   Latency buddy {0, 0, 0};
+
+   for (int i = 0; i < presence; i++) {
+      buddy.add(deliver([&account, i]() {
+         StandIn::buddyNotification(account, "sip:" + std::to_string(5140000000LL + i % 100) + "@localhost", i % 2, std::string());
+      }));
+   }
+
+   //A decoder, the renderer register its sink when the decoding starts
+   const qint64 decoding = deliver([]() {
+      StandIn::startDecoding("standin-video", 640, 480);
+   });
+
+   Latency frame {0, 0, 0};
+   int rendered = 0;
+
+   for (int i = 0; i < frames; i++) {
+      frame.add(deliver([&rendered]() {
+         rendered += StandIn::pushFrame("standin-video");
+      }));
+   }
+
+   deliver([]() {
+      StandIn::stopDecoding("standin-video");
+   });
+
+   incoming   .report("incoming_call");
+   transitions.report("state_change" );
+   message    .report("message"      );
+   buddy      .report("presence"     );
+   frame      .report("frame"        );
+
+   Bench::report("standin", "decoding_start"  , decoding                                                          , "us"   );
+   Bench::report("standin", "calls_with_details", withDetails                                                     , "calls");
+   Bench::report("standin", "history_calls"   , CategorizedHistoryModel::instance().getHistoryCalls().size() - history, "calls");
+   Bench::report("standin", "recent_rows"     , RecentModel::instance().rowCount()                                , "rows" );
+   Bench::report("standin", "numbers"         , PhoneDirectoryModel::instance().count()                           , "numbers");
+   Bench::report("standin", "frames_rendered" , rendered                                                          , "frames");
+   Bench::report("standin", "memory"          , Bench::residentMemory() - memory                                  , "kB"   );
+}
@@ -0,0 +1,108 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "benchmark.h"
+
+//Ring
+#include <call.h>
+#include <private/call_p.h>
+
+namespace {
+
+typedef CallPrivate::DaemonState DS;
+
+///A user action or a daemon state change
+struct Step {
+   bool         isAction;
+   Call::Action action  ;
+   DS           dcs     ;
+};
+
+#define ACTION(a) Step { true , Call::Action::a, DS::COUNT__ }
+#define DAEMON(s) Step { false, Call::Action::COUNT__, DS::s }
+
+///An outgoing call placed, held, resumed and hung up
+static const Step outgoing[] = {
+   ACTION(ACCEPT), DAEMON(RINGING), DAEMON(CURRENT), ACTION(HOLD   ), DAEMON(HOLD   ),
+   ACTION(HOLD  ), DAEMON(CURRENT), ACTION(REFUSE ), DAEMON(HUNG_UP), DAEMON(OVER   ),
+};
+
+///An incoming call answered, recorded and hung up by the peer
+static const Step incoming[] = {
+   DAEMON(RINGING), ACTION(ACCEPT ), DAEMON(CURRENT), ACTION(RECORD_AUDIO),
+   ACTION(RECORD_AUDIO), DAEMON(HUNG_UP), DAEMON(OVER),
+};
+
+#undef ACTION
+#undef DAEMON
+
+/**
+ * Perform the lookups of Call::performAction() or CallPrivate::stateChanged()
+ * for each step. The callbacks need the daemon, the ones that would do
+ * something are counted instead of called.
+ */
+template<int N>
+Call::State dispatch(Call::State state, const Step (&steps)[N], qint64& callbacks, qint64& rejected)
+{
+   for (const Step& s : steps) {
+      if (s.isAction) {
+         callbacks += CallPrivate::actionPerformedFunctionMap[state][s.action] != &CallPrivate::nothing;
+         state      = CallPrivate::actionPerformedStateMap   [state][s.action];
+         continue;
+      }
+
+      const Call::State next = CallPrivate::stateChangedStateMap[state][s.dcs];
+
+      if (!CallPrivate::metaStateTransitionValidationMap[next][CallPrivate::metaStateMap[state]]) {
+         rejected++;
+         continue;
+      }
+
+      callbacks += CallPrivate::stateChangedFunctionMap[state][s.dcs] != &CallPrivate::nothing;
+      state      = next;
+   }
+
+   return state;
+}
+
+}
+
+/**
+ * Dispatch the call state transitions through the real CallPrivate tables,
+ * an outgoing and an incoming call at a time.
+ */
+BENCHMARK(statemachine)
+{
+   static const int count = 1000000;
+   static const int steps = count * static_cast<int>(
+      sizeof(outgoing) / sizeof(outgoing[0]) + sizeof(incoming) / sizeof(incoming[0])
+   );
+
+   qint64 callbacks = 0, rejected = 0, over = 0;
+
+   const qint64 elapsed = Bench::measure([&callbacks, &rejected, &over]() {
+      for (int i = 0; i < count; i++) {
+         over += dispatch(Call::State::DIALING , outgoing, callbacks, rejected) == Call::State::OVER;
+         over += dispatch(Call::State::INCOMING, incoming, callbacks, rejected) == Call::State::OVER;
+      }
+   });
+
+   Bench::report("statemachine", "transition_avg", elapsed * 1000000 / steps, "ps"         );
+   Bench::report("statemachine", "callbacks"     , callbacks                , "transitions");
+   Bench::report("statemachine", "rejected"      , rejected                 , "transitions");
+   Bench::report("statemachine", "calls_over"    , over                     , "calls"      );
+}
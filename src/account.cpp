@@ -73,9 +73,9 @@
 #define EA Account::EditAction
 #define ES Account::EditState
 
-static EnumClassReordering<Account::EditAction> co =
+static constexpr EnumClassReordering<Account::EditAction> co =
 {                                 EA::NOTHING,  EA::EDIT  , EA::RELOAD ,  EA::SAVE  , EA::REMOVE , EA::MODIFY   , EA::CANCEL     };
-const Matrix2D<Account::EditState, Account::EditAction, account_function> AccountPrivate::stateMachineActionsOnState = {
+constexpr Matrix2D<Account::EditState, Account::EditAction, account_function> AccountPrivate::stateMachineActionsOnState = {
 {ES::READY               ,{{co, { AP::nothing, AP::edit   , AP::reload , AP::nothing, AP::remove , AP::modify   , AP::nothing }}}},
 {ES::EDITING             ,{{co, { AP::nothing, AP::nothing, AP::outdate, AP::nothing, AP::remove , AP::modify   , AP::cancel  }}}},
 {ES::OUTDATED            ,{{co, { AP::nothing, AP::nothing, AP::nothing, AP::nothing, AP::remove , AP::reloadMod, AP::reload  }}}},
@@ -99,7 +99,7 @@ m_pAccountNumber(nullptr),m_pKeyExchangeModel(nullptr),m_pSecurityEvaluationMode
 m_pCaCert(nullptr),m_pTlsCert(nullptr),m_isLoaded(true),m_pCipherModel(nullptr),
 m_pStatusModel(nullptr),m_LastTransportCode(0),m_RegistrationState(Account::RegistrationState::UNREGISTERED),
 m_UseDefaultPort(false),m_pProtocolModel(nullptr),m_pBootstrapModel(nullptr),m_RemoteEnabledState(false),
-m_HaveCalled(false),m_TotalCount(0),m_LastWeekCount(0),m_LastTrimCount(0),m_LastUsed(0),m_pKnownCertificates(nullptr),
+m_HaveCalled(false),m_TotalCount(0),m_LastUsed(0),m_pKnownCertificates(nullptr),
 m_pBannedCertificates(nullptr), m_pAllowedCertificates(nullptr),m_InternalId(++p_sAutoIncrementId),
 m_pNetworkInterfaceModel(nullptr),m_pAllowedCerts(nullptr),m_pBannedCerts(nullptr),m_pPendingTrustRequestModel(nullptr)
 {
@@ -583,12 +583,12 @@ uint Account::totalCallCount() const
 
 uint Account::weekCallCount() const
 {
-   return d_ptr->m_LastWeekCount;
+   return d_ptr->m_Usage.weekCount();
 }
 
 uint Account::trimesterCallCount() const
 {
-   return d_ptr->m_LastTrimCount;
+   return d_ptr->m_Usage.trimCount();
 }
 
 time_t Account::lastUsed() const
@@ -2287,7 +2287,7 @@ Account::RoleState Account::roleState(Account::Role role) const
    constexpr static const Account::RoleState un = Account::RoleState::UNAVAILABLE;
 
    //Matrix used to define if a field is enabled
-   static const Matrix2D<KeyExchangeModel::Type, Fields, Account::RoleState>
+   static constexpr Matrix2D<KeyExchangeModel::Type, Fields, Account::RoleState>
    enabledFields={{
       /*                     ______________________> SDES_FALLBACK_RTP        */
       /*                    /      ________________> ZRTP_ASK_USER            */
@@ -353,6 +353,23 @@ void AccountModelPrivate::slotSupportedProtocolsChanged()
     emit q_ptr->supportedProtocolsChanged();
 }
 
+///Move the accounts usage statistics to the new day, see PhoneDirectoryModelPrivate::slotRollover()
+void AccountModelPrivate::rolloverUsage()
+{
+   int first = -1, last = -1;
+
+   for (int i = 0; i < m_lAccounts.size(); i++) {
+      if (m_lAccounts[i]->d_ptr->m_Usage.rollover()) {
+         if (first == -1)
+            first = i;
+         last = i;
+      }
+   }
+
+   if (first != -1)
+      emit q_ptr->dataChanged(q_ptr->index(first, 0), q_ptr->index(last, 0));
+}
+
 ///Tell the model something changed
 void AccountModelPrivate::slotAccountChanged(Account* a)
 {
@@ -52,6 +52,7 @@ public:
    friend class AccountPrivate;
    friend class AvailableAccountModel;
    friend class AvailableAccountModelPrivate;
+   friend class PhoneDirectoryModelPrivate;
 
    /// @enum Global saving state to be used when using a single saving mechanism for all accounts at once
    enum class EditState {
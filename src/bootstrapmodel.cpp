@@ -63,7 +63,7 @@ public:
    QVector<Lines*>            m_lines    ;
    BootstrapModel*            q_ptr      ;
    BootstrapModel::EditState  m_EditState;
-   static Matrix2D<BootstrapModel::EditState, BootstrapModel::EditAction, BootstrapModelPrivateFct> m_mStateMachine;
+   static const Matrix2D<BootstrapModel::EditState, BootstrapModel::EditAction, BootstrapModelPrivateFct> m_mStateMachine;
 };
 
 BootstrapModelPrivate::BootstrapModelPrivate(BootstrapModel* q,Account* a) : q_ptr(q),m_pAccount(a)
@@ -72,7 +72,7 @@ BootstrapModelPrivate::BootstrapModelPrivate(BootstrapModel* q,Account* a) : q_p
 }
 
 #define BMP &BootstrapModelPrivate
-Matrix2D<BootstrapModel::EditState, BootstrapModel::EditAction, BootstrapModelPrivateFct> BootstrapModelPrivate::m_mStateMachine ={{
+constexpr Matrix2D<BootstrapModel::EditState, BootstrapModel::EditAction, BootstrapModelPrivateFct> BootstrapModelPrivate::m_mStateMachine ={{
    /*                     SAVE         MODIFY        RELOAD        CLEAR           RESET      */
    /* LOADING   */ {{ BMP::nothing, BMP::nothing, BMP::reload , BMP::nothing , BMP::nothing }},
    /* READY     */ {{ BMP::nothing, BMP::modify , BMP::reload , BMP::clear,    BMP::reset   }},
@@ -60,6 +60,8 @@
 #include "audio/settings.h"
 #include "personmodel.h"
 #include "private/contactmethod_p.h"
+#include "private/calldetailscache.h"
+#include "private/searchindex.h"
 
 #include "media/audio.h"
 #include "media/video.h"
@@ -86,7 +88,7 @@
 #include "private/call_p.h"
 #include "private/textrecording_p.h"
 
-const TypedStateMachine< TypedStateMachine< Call::State , Call::Action> , Call::State> CallPrivate::actionPerformedStateMap =
+constexpr TypedStateMachine< TypedStateMachine< Call::State , Call::Action> , Call::State> CallPrivate::actionPerformedStateMap =
 {{
 //                           ACCEPT                      REFUSE                  TRANSFER                       HOLD                           RECORD              /**/
 /*NEW          */  {{Call::State::DIALING       , Call::State::ABORTED     , Call::State::ERROR        , Call::State::ERROR        ,  Call::State::ERROR        }},/**/
@@ -109,7 +111,7 @@ const TypedStateMachine< TypedStateMachine< Call::State , Call::Action> , Call::
 }};//                                                                                                                                                                */
 
 #define CP &CallPrivate
-const TypedStateMachine< TypedStateMachine< function , Call::Action > , Call::State > CallPrivate::actionPerformedFunctionMap =
+constexpr TypedStateMachine< TypedStateMachine< function , Call::Action > , Call::State > CallPrivate::actionPerformedFunctionMap =
 {{
 //                      ACCEPT             REFUSE         TRANSFER             HOLD                  AUDIO_RECORD              VIDEO_RECORD        TEXT_RECORD     /**/
 /*NEW            */  {{CP::nothing    , CP::abort    , CP::nothing        , CP::nothing     ,  CP::nothing            ,  CP::nothing            ,  CP::nothing  }},/**/
@@ -132,7 +134,7 @@ const TypedStateMachine< TypedStateMachine< function , Call::Action > , Call::St
 }};//                                                                                                                                                                */
 
 
-const TypedStateMachine< TypedStateMachine< Call::State , CallPrivate::DaemonState> , Call::State> CallPrivate::stateChangedStateMap =
+constexpr TypedStateMachine< TypedStateMachine< Call::State , CallPrivate::DaemonState> , Call::State> CallPrivate::stateChangedStateMap =
 {{
 //                        RINGING                   CONNECTING                 CURRENT                   BUSY                  HOLD                        HUNGUP              FAILURE               OVER                      INACTIVE              /**/
 /*NEW          */ {{Call::State::ERROR       , Call::State::ERROR     , Call::State::ERROR      , Call::State::ERROR  , Call::State::ERROR       , Call::State::ERROR , Call::State::ERROR   , Call::State::ERROR    , Call::State::INITIALIZATION}},/**/
@@ -154,7 +156,7 @@ const TypedStateMachine< TypedStateMachine< Call::State , CallPrivate::DaemonSta
 /*CONNECTED    */ {{Call::State::RINGING     , Call::State::CONNECTED , Call::State::CURRENT    , Call::State::BUSY   , Call::State::HOLD        , Call::State::OVER  , Call::State::FAILURE , Call::State::OVER     , Call::State::CONNECTED     }},/**/
 }};//                                                                                                                                                                                                                                                  */
 
-const TypedStateMachine< TypedStateMachine< function , CallPrivate::DaemonState > , Call::State > CallPrivate::stateChangedFunctionMap =
+constexpr TypedStateMachine< TypedStateMachine< function , CallPrivate::DaemonState > , Call::State > CallPrivate::stateChangedFunctionMap =
 {{
 //                      RINGING          CONNECTING      CURRENT            BUSY               HOLD               HUNGUP         FAILURE          OVER        INACTIVE     /**/
 /*NEW            */  {{CP::nothing    , CP::nothing   , CP::nothing   , CP::nothing      , CP::nothing      , CP::nothing    , CP::nothing  , CP::nothing , CP::nothing}}, /**/
@@ -177,7 +179,7 @@ const TypedStateMachine< TypedStateMachine< function , CallPrivate::DaemonState
 }};//                                                                                                                                                                        */
 
 //There is no point to have a 2D matrix, only one transition per state is possible
-const Matrix1D<Call::LifeCycleState,function> CallPrivate::m_mLifeCycleStateChanges = {{
+constexpr Matrix1D<Call::LifeCycleState,function> CallPrivate::m_mLifeCycleStateChanges = {{
 /* CREATION       */ CP::nothing       ,
 /* INITIALIZATION */ CP::nothing       ,
 /* PROGRESS       */ CP::initMedia     ,
@@ -185,7 +187,7 @@ const Matrix1D<Call::LifeCycleState,function> CallPrivate::m_mLifeCycleStateChan
 }};
 #undef CP
 
-const TypedStateMachine< Call::LifeCycleState , Call::State > CallPrivate::metaStateMap =
+constexpr TypedStateMachine< Call::LifeCycleState , Call::State > CallPrivate::metaStateMap =
 {{
 /*               *        Life cycle meta-state              **/
 /*NEW            */   Call::LifeCycleState::CREATION       ,/**/
@@ -207,7 +209,7 @@ const TypedStateMachine< Call::LifeCycleState , Call::State > CallPrivate::metaS
 /*CONNECTED      */   Call::LifeCycleState::INITIALIZATION ,/**/
 }};/*                                                        **/
 
-const TypedStateMachine< TypedStateMachine< bool , Call::LifeCycleState > , Call::State > CallPrivate::metaStateTransitionValidationMap =
+constexpr TypedStateMachine< TypedStateMachine< bool , Call::LifeCycleState > , Call::State > CallPrivate::metaStateTransitionValidationMap =
 {{
 /*               *        CREATION    INITIALIZATION    PROGRESS      FINISHED   **/
 /*NEW            */  {{     true     ,     true     ,    false    ,    false }},/**/
@@ -416,31 +418,25 @@ void CallPrivate::updateOutgoingMedia(const MapStringString& details)
 
 MapStringString CallPrivate::getCallDetailsCommon(const QString& callId)
 {
-   CallManagerInterface& callManager = CallManager::instance();
-
-   MapStringString details = callManager.getCallDetails(callId);
-
-   const QString account = details[ DRing::Call::Details::ACCOUNTID ];
+   return CallDetailsCache::instance().details(callId);
+}
 
-   if (account.isEmpty())
-      return details;
+///Update the parts of the call that can change with each daemon state
+void CallPrivate::applyDetails(const MapStringString& details)
+{
+   if (m_CurrentState == Call::State::OVER || details[DRing::Call::Details::ACCOUNTID].isEmpty())
+      return;
 
-   Account* acc = AccountModel::instance().getById(account.toLatin1());
+   updateOutgoingMedia(details);
 
-   //Only keep the useful part of the URI
-   if (acc && acc->protocol() == Account::Protocol::RING)
-      details[DRing::Call::Details::PEER_NUMBER] = URI(details[DRing::Call::Details::PEER_NUMBER]).format(
-         URI::Section::SCHEME    |
-         URI::Section::USER_INFO
-      );
-   else
-      details[DRing::Call::Details::PEER_NUMBER] = URI(details[DRing::Call::Details::PEER_NUMBER]).format(
-         URI::Section::SCHEME    |
-         URI::Section::USER_INFO |
-         URI::Section::HOSTNAME
-      );
+   if (!details[DRing::Call::Details::DISPLAY_NAME].isEmpty()
+       and ( details[DRing::Call::Details::DISPLAY_NAME] != m_PeerName) )
+      q_ptr->setPeerName(details[DRing::Call::Details::DISPLAY_NAME]);
 
-   return details;
+   //Load the certificate if it's now available
+   if (!q_ptr->certificate() && !details[DRing::TlsTransport::TLS_PEER_CERT].isEmpty()) {
+      m_pCertificate = CertificateModel::instance().getCertificateFromId(details[DRing::TlsTransport::TLS_PEER_CERT], q_ptr->account());
+   }
 }
 
 ///Build a call from a dbus event
@@ -1302,17 +1298,8 @@ Call::State CallPrivate::stateChanged(const QString& newStateName)
          return m_CurrentState;
       }
 
-      MapStringString details = getCallDetailsCommon(m_DringId);
-      updateOutgoingMedia(details);
-
-      if (!details[DRing::Call::Details::DISPLAY_NAME].isEmpty()
-          and ( details[DRing::Call::Details::DISPLAY_NAME] != m_PeerName) )
-         q_ptr->setPeerName(details[DRing::Call::Details::DISPLAY_NAME]);
-
-      //Load the certificate if it's now available
-      if (!q_ptr->certificate() && !details[DRing::TlsTransport::TLS_PEER_CERT].isEmpty()) {
-         m_pCertificate = CertificateModel::instance().getCertificateFromId(details[DRing::TlsTransport::TLS_PEER_CERT], q_ptr->account());
-      }
+      //The media, peer name and certificate are updated when the details arrive
+      CallDetailsCache::instance().refresh(m_DringId);
 
       try {
          (this->*(stateChangedFunctionMap[previousState][dcs]))();
@@ -2194,15 +2181,10 @@ QVariant Call::roleData(int role) const
       case static_cast<int>(Call::Role::IsAVRecording):
          return d_ptr->m_mIsRecording[Media::Media::Type::AUDIO][Media::Media::Direction::IN]
             || d_ptr->m_mIsRecording[Media::Media::Type::AUDIO][Media::Media::Direction::IN];
-      case static_cast<int>(Call::Role::Filter): {
-         QString normStripppedC;
-         foreach(QChar char2,(static_cast<int>(direction())+'\n'+roleData(Call::Role::Name).toString()+'\n'+
-            roleData(Call::Role::Number).toString()).toLower().normalized(QString::NormalizationForm_KD) ) {
-            if (!char2.combiningClass())
-               normStripppedC += char2;
-         }
-         return normStripppedC;
-         }
+      case static_cast<int>(Call::Role::Filter):
+         //The normalization is only done again when the string changes
+         return SearchIndex::instance().update(this, static_cast<int>(direction())+'\n'+
+            roleData(Call::Role::Name).toString()+'\n'+roleData(Call::Role::Number).toString());
       case static_cast<int>(Call::Role::FuzzyDate):
          return QVariant::fromValue(d_ptr->m_HistoryConst);
       case static_cast<int>(Call::Role::IsBookmark):
@@ -2270,7 +2252,7 @@ QVariant Call::roleData(int role) const
          return GlobalInstances::pixmapManipulator().securityLevelIcon(account()->securityEvaluationModel()->securityLevel());
       case static_cast<int>(Ring::Role::UnreadTextMessageCount):
          if (peerContactMethod() && peerContactMethod()->textRecording())
-            return peerContactMethod()->textRecording()->unreadInstantTextMessagingModel()->rowCount();
+            return peerContactMethod()->textRecording()->unreadCount();
          else
             return 0;
          break;
@@ -95,6 +95,7 @@ public:
    friend class Media::Text;
    friend class MediaTypeInference;
    friend class IMConversationManagerPrivate;
+   friend class CallDetailsCache;
    friend QMimeData* RingMimes::payload(const Call*, const ContactMethod*, const Person*);
 
    //Enum
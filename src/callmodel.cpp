@@ -39,6 +39,7 @@
 #include "dbus/instancemanager.h"
 #include "private/videorenderermanager.h"
 #include "private/imconversationmanagerprivate.h"
+#include "private/calldetailscache.h"
 #include "mime.h"
 #include "typedefs.h"
 #include "collectioninterface.h"
@@ -97,7 +98,10 @@ public:
       bool isPartOf(const QModelIndex& confIdx, Call* call);
       void removeConference       ( Call* conf                    );
       void removeInternal(InternalStruct* internal);
-      static QStringList getCallList();
+      static void getCallList(const std::function<void(const QStringList&)>& callback);
+      void checkConferences(const QStringList& callList, const QHash<QString,MapStringString>& details);
+      void applyConferenceChange(const QString& confID, const QString& state, const QStringList& participants,
+                                 const QStringList& callList, const QHash<QString,MapStringString>& details);
 
    private:
       CallModel* q_ptr;
@@ -167,6 +171,9 @@ void CallModelPrivate::init()
     VideoManager::instance();
 #endif
 
+    //Must be connected first to invalidate the details before the slots below
+    CallDetailsCache::instance();
+
     //SLOTS
     /*             SENDER                          SIGNAL                     RECEIVER                    SLOT                   */
     /**/connect(&callManager, SIGNAL(callStateChanged(QString,QString,int))  , this , SLOT(slotCallStateChanged(QString,QString,int)));
@@ -185,17 +192,19 @@ void CallModelPrivate::init()
 
     registerCommTypes();
 
-    const QStringList callList = getCallList();
-    foreach (const QString& callId, callList) {
-        Call* tmpCall = CallPrivate::buildExistingCall(callId);
-        addCall2(tmpCall);
-    }
-
-    const QStringList confList = callManager.getConferenceList();
-    foreach (const QString& confId, confList) {
-        Call* conf = addConference(confId);
-        emit q_ptr->conferenceCreated(conf);
-    }
+    //The conferences are added once their participants exist
+    getCallList([this](const QStringList& callList) {
+        foreach (const QString& callId, callList) {
+            Call* tmpCall = CallPrivate::buildExistingCall(callId);
+            addCall2(tmpCall);
+        }
+
+        const QStringList confList = CallManager::instance().getConferenceList();
+        foreach (const QString& confId, confList) {
+            Call* conf = addConference(confId);
+            emit q_ptr->conferenceCreated(conf);
+        }
+    });
 }
 
 ///Destructor
@@ -603,22 +612,23 @@ void CallModelPrivate::removeInternal(InternalStruct* internal)
  * LibRingClient doesn't [need to] handle INACTIVE calls
  * This method make sure they never get into the system.
  *
- * It's not very efficient, but do the job. This method isn't
- * called very often anyway.
+ * `callback` receives the other calls once the details of all of them
+ * arrived, it doesn't block.
  */
-QStringList CallModelPrivate::getCallList()
+void CallModelPrivate::getCallList(const std::function<void(const QStringList&)>& callback)
 {
-   CallManagerInterface& callManager = CallManager::instance();
-   const QStringList callList = callManager.getCallList();
-   QStringList ret;
+   const QStringList callList = CallManager::instance().getCallList();
 
-   for (const QString& callId : callList) {
-      QMap<QString, QString> details = callManager.getCallDetails(callId);
-      if (details[DRing::Call::Details::CALL_STATE] != DRing::Call::StateEvent::INACTIVE)
-         ret << callId;
-   }
+   CallDetailsCache::instance().details(callList, [callList, callback](const QHash<QString,MapStringString>& details) {
+      QStringList ret;
 
-   return ret;
+      for (const QString& callId : callList) {
+         if (details[callId][DRing::Call::Details::CALL_STATE] != DRing::Call::StateEvent::INACTIVE)
+            ret << callId;
+      }
+
+      callback(ret);
+   });
 }
 
 ///Remove a call and update the internal structure
@@ -1233,22 +1243,45 @@ void CallModelPrivate::slotIncomingConference(const QString& confID)
 ///When a conference change
 void CallModelPrivate::slotChangingConference(const QString &confID, const QString& state)
 {
-   InternalStruct* confInt = m_shDringId[confID];
+   InternalStruct* confInt = m_shDringId.value(confID);
    if (!confInt) {
       qDebug() << "Error: conference not found";
       return;
    }
-   Call* conf = confInt->call_real;
+
+   CallManagerInterface& callManager = CallManager::instance();
+   const QStringList participants   = callManager.getParticipantList(confID);
+   const QStringList deamonCallList = callManager.getCallList();
+
+   //The participants details are applied before the state transition
+   CallDetailsCache::instance().details(deamonCallList, [this, confID, state, participants, deamonCallList](const QHash<QString,MapStringString>& details) {
+      applyConferenceChange(confID, state, participants, deamonCallList, details);
+   });
+}
+
+/**
+ * Move the participants to the conference once the details of every call
+ * arrived. The whole change is notified by a single layoutChanged().
+ */
+void CallModelPrivate::applyConferenceChange(const QString& confID, const QString& state, const QStringList& participants,
+                                             const QStringList& callList, const QHash<QString,MapStringString>& details)
+{
+   //It may have been removed while the details were fetched
+   InternalStruct* confInt = m_shDringId.value(confID);
+   Call* conf = confInt ? confInt->call_real : nullptr;
    qDebug() << "Changing conference state" << conf << confID;
-   if (conf && conf) { //Prevent a race condition between call and conference
+   if (conf) { //Prevent a race condition between call and conference
       if (!q_ptr->getIndex(conf).isValid()) {
          qWarning() << "The conference item does not exist";
          return;
       }
 
+      foreach(const QString& callId, participants) {
+         if (InternalStruct* callInt = m_shDringId.value(callId))
+            callInt->call_real->d_ptr->applyDetails(details[callId]);
+      }
+
       conf->d_ptr->stateChanged(state);
-      CallManagerInterface& callManager = CallManager::instance();
-      const QStringList participants = callManager.getParticipantList(confID);
 
       qDebug() << "The conf has" << confInt->m_lChildren.size() << "calls, daemon has" <<participants.size();
 
@@ -1264,12 +1297,14 @@ void CallModelPrivate::slotChangingConference(const QString &confID, const QStri
       }
 
       auto confIdx = q_ptr->index(m_lInternalModel.indexOf(confInt),0,QModelIndex());
-      q_ptr->beginRemoveRows(confIdx,0,confInt->m_lChildren.size());
-      confInt->m_lChildren.clear();
-      q_ptr->endRemoveRows();
+      if (confInt->m_lChildren.size()) {
+         q_ptr->beginRemoveRows(confIdx,0,confInt->m_lChildren.size()-1);
+         confInt->m_lChildren.clear();
+         q_ptr->endRemoveRows();
+      }
 
       foreach(const QString& callId,participants) {
-         InternalStruct* callInt = m_shDringId[callId];
+         InternalStruct* callInt = m_shDringId.value(callId);
          if (callInt) {
             if (callInt->m_pParent && callInt->m_pParent != confInt)
                callInt->m_pParent->m_lChildren.removeAll(callInt);
@@ -1292,51 +1327,70 @@ void CallModelPrivate::slotChangingConference(const QString &confID, const QStri
       }
 
       //Test if there is no inconsistencies between the daemon and the client
-      const QStringList deamonCallList = getCallList();
-      foreach(const QString& callId, deamonCallList) {
-         const QMap<QString,QString> callDetails = callManager.getCallDetails(callId);
-         InternalStruct* callInt = m_shDringId[callId];
-         if (callInt) {
-            const QString confId = callDetails[DRing::Call::Details::CONF_ID];
-            if (callInt->m_pParent) {
-               if (!confId.isEmpty()  && callInt->m_pParent->call_real->dringId() != confId) {
-                  qWarning() << "Conference parent mismatch";
-               }
-               else if (confId.isEmpty() ){
-                  qWarning() << "Call:" << callId << "should not be part of a conference";
-                  callInt->m_pParent = nullptr;
-               }
-            }
-            else if (!confId.isEmpty()) {
-               qWarning() << "Found an orphan call";
-               InternalStruct* confInt2 = m_shDringId[confId];
-               if (confInt2 && confInt2->call_real->type() == Call::Type::CONFERENCE
-                && (callInt->call_real->type() != Call::Type::CONFERENCE)) {
-                  removeInternal(callInt);
-                  if (confInt2->m_lChildren.indexOf(callInt) == -1) {
-                     auto confIdx2 = q_ptr->index(m_lInternalModel.indexOf(confInt2), 0, QModelIndex());
-                     q_ptr->beginInsertRows(confIdx2, confInt2->m_lChildren.size(), confInt2->m_lChildren.size());
-                     confInt2->m_lChildren << callInt;
-                     q_ptr->endInsertRows();
-                  }
-               }
-            }
-            callInt->call_real->setProperty("dropState",0);
-         }
-         else
-            qWarning() << "Conference: Call from call list not found in internal list";
-      }
+      checkConferences(callList, details);
 
       //TODO force reload all conferences too
 
       emit q_ptr->layoutChanged();
-      emit q_ptr->dataChanged(confIdx, confIdx);
+
+      //The conference itself may have been removed by the cleanup
+      confIdx = q_ptr->getIndex(conf);
+      if (confIdx.isValid())
+         emit q_ptr->dataChanged(confIdx, confIdx);
+
       emit q_ptr->conferenceChanged(conf);
    }
    else {
       qDebug() << "Trying to affect a conference that does not exist (anymore)";
    }
-} //slotChangingConference
+} //applyConferenceChange
+
+/**
+ * Fix the conference participants when they differ from the daemon ones.
+ * It runs once the details of all calls were received, the caller notifies
+ * the new layout.
+ */
+void CallModelPrivate::checkConferences(const QStringList& callList, const QHash<QString,MapStringString>& details)
+{
+   foreach(const QString& callId, callList) {
+      const QMap<QString,QString> callDetails = details[callId];
+
+      //LibRingClient doesn't handle INACTIVE calls, see getCallList()
+      if (callDetails[DRing::Call::Details::CALL_STATE] == DRing::Call::StateEvent::INACTIVE)
+         continue;
+
+      InternalStruct* callInt = m_shDringId[callId];
+      if (callInt) {
+         const QString confId = callDetails[DRing::Call::Details::CONF_ID];
+         if (callInt->m_pParent) {
+            if (!confId.isEmpty()  && callInt->m_pParent->call_real->dringId() != confId) {
+               qWarning() << "Conference parent mismatch";
+            }
+            else if (confId.isEmpty() ){
+               qWarning() << "Call:" << callId << "should not be part of a conference";
+               callInt->m_pParent = nullptr;
+            }
+         }
+         else if (!confId.isEmpty()) {
+            qWarning() << "Found an orphan call";
+            InternalStruct* confInt2 = m_shDringId[confId];
+            if (confInt2 && confInt2->call_real->type() == Call::Type::CONFERENCE
+             && (callInt->call_real->type() != Call::Type::CONFERENCE)) {
+               removeInternal(callInt);
+               if (confInt2->m_lChildren.indexOf(callInt) == -1) {
+                  auto confIdx2 = q_ptr->index(m_lInternalModel.indexOf(confInt2), 0, QModelIndex());
+                  q_ptr->beginInsertRows(confIdx2, confInt2->m_lChildren.size(), confInt2->m_lChildren.size());
+                  confInt2->m_lChildren << callInt;
+                  q_ptr->endInsertRows();
+               }
+            }
+         }
+         callInt->call_real->setProperty("dropState",0);
+      }
+      else
+         qWarning() << "Conference: Call from call list not found in internal list";
+   }
+}
 
 ///When a conference is removed
 void CallModelPrivate::slotConferenceRemoved(const QString &confId)
@@ -21,6 +21,7 @@
 #include <QtCore/QMimeData>
 #include <QtCore/QCoreApplication>
 #include <QtCore/QAbstractItemModel>
+#include <QtCore/QSet>
 
 //Ring
 #include "categorizedhistorymodel.h"
@@ -49,11 +50,20 @@ public:
    QHash<QString,NumberTreeBackend*>             m_hCategories      ;
    QStringList                                   m_lMimes           ;
    QHash<ContactMethod*,QMetaObject::Connection> m_Tracked          ;
+   QHash<ContactMethod*,NumberTreeBackend*>      m_hBookmarks       ;
+   bool                                          m_PopularReset     ;
 
    //Helpers
    QString                 category             ( NumberTreeBackend* number ) const;
    bool                    displayFrequentlyUsed(                           ) const;
    QVector<ContactMethod*> bookmarkList         (                           ) const;
+   QModelIndex             mostPopularIndex     (                           ) const;
+   NumberTreeBackend*      categoryNode         ( const QString& name       );
+   void                    attach               ( NumberTreeBackend* bm     );
+   void                    detach               ( NumberTreeBackend* bm     );
+   void                    insertBookmark       ( ContactMethod* number     );
+   bool                    removeBookmark       ( ContactMethod* number     );
+   void                    trackPopularModel    (                           );
 
 public Q_SLOTS:
    void slotIndexChanged( const QModelIndex& idx );
@@ -89,7 +99,7 @@ public:
 };
 
 CategorizedBookmarkModelPrivate::CategorizedBookmarkModelPrivate(CategorizedBookmarkModel* parent) :
-QObject(parent), q_ptr(parent)
+QObject(parent), m_PopularReset(false), q_ptr(parent)
 {}
 
 NumberTreeBackend::NumberTreeBackend(ContactMethod* number):
@@ -113,12 +123,21 @@ CategorizedBookmarkModel::CategorizedBookmarkModel(QObject* parent) : QAbstractI
 d_ptr(new CategorizedBookmarkModelPrivate(this))
 {
    setObjectName("CategorizedBookmarkModel");
-   reloadCategories();
    d_ptr->m_lMimes << RingMimes::PLAIN_TEXT << RingMimes::PHONENUMBER;
 
+   //Load most used contacts
    if (d_ptr->displayFrequentlyUsed()) {
-      connect(PhoneDirectoryModel::instance().mostPopularNumberModel(),&QAbstractItemModel::rowsInserted,this,&CategorizedBookmarkModel::reloadCategories);
+                                                      //: Most popular contacts
+      NumberTreeBackend* item = new NumberTreeBackend(tr("Most popular"));
+      d_ptr->m_hCategories["mp"] = item;
+      item->m_Index = d_ptr->m_lCategoryCounter.size();
+      item->m_MostPopular = true;
+      d_ptr->m_lCategoryCounter << item;
+
+      d_ptr->trackPopularModel();
    }
+
+   reloadCategories();
 }
 
 CategorizedBookmarkModel::~CategorizedBookmarkModel()
@@ -153,90 +172,23 @@ QHash<int,QByteArray> CategorizedBookmarkModel::roleNames() const
    return roles;
 }
 
-///Reload bookmark cateogries
+/**
+ * Synchronize the tree with the bookmark collection. Only the missing and
+ * removed bookmarks are updated, the tracking connections are kept.
+ */
 void CategorizedBookmarkModel::reloadCategories()
 {
-   d_ptr->m_hCategories.clear();
-
-   beginRemoveRows(QModelIndex(), 0, d_ptr->m_lCategoryCounter.size()-1);
-
-   //TODO this is not efficient, nor necessary
-   foreach(NumberTreeBackend* item, d_ptr->m_lCategoryCounter) {
-      foreach (NumberTreeBackend* child, item->m_lChildren) {
-         auto l = d_ptr->m_Tracked[child->m_pNumber];
-         if (l) {
-            disconnect(l);
-         }
-         delete child;
-      }
-      delete item;
-   }
-   d_ptr->m_Tracked.clear();
-   d_ptr->m_lCategoryCounter.clear();
-   endRemoveRows();
-
-   //Load most used contacts
-   if (d_ptr->displayFrequentlyUsed()) {
-                                                      //: Most popular contacts
-      NumberTreeBackend* item = new NumberTreeBackend(tr("Most popular"));
-      d_ptr->m_hCategories["mp"] = item;
-      item->m_Index = d_ptr->m_lCategoryCounter.size();
-      item->m_MostPopular = true;
-      beginInsertRows(QModelIndex(), d_ptr->m_lCategoryCounter.size(),d_ptr->m_lCategoryCounter.size());
-      d_ptr->m_lCategoryCounter << item;
-      endInsertRows();
-
-      //This a proxy, so the items already exist elsewhere
-      beginInsertRows(index(item->m_Index,0), item->m_lChildren.size(), item->m_lChildren.size());
-      endInsertRows();
+   const QVector<ContactMethod*> bookmarks = d_ptr->bookmarkList();
 
-      const QVector<ContactMethod*> cl = PhoneDirectoryModel::instance().getNumbersByPopularity();
-   }
-
-   foreach(ContactMethod* bookmark, d_ptr->bookmarkList()) {
-      NumberTreeBackend* bm = new NumberTreeBackend(bookmark);
-      const QString val = d_ptr->category(bm);
-      if (!d_ptr->m_hCategories[val]) {
-         NumberTreeBackend* item = new NumberTreeBackend(val);
-         d_ptr->m_hCategories[val] = item;
-         item->m_Index = d_ptr->m_lCategoryCounter.size();
-         beginInsertRows(QModelIndex(), d_ptr->m_lCategoryCounter.size(),d_ptr->m_lCategoryCounter.size());
-         d_ptr->m_lCategoryCounter << item;
-         endInsertRows();
-      }
-      NumberTreeBackend* item = d_ptr->m_hCategories[val];
-      if (item) {
-         bookmark->setBookmarked(true);
-         bm->m_pParent = item;
-         bm->m_Index = item->m_lChildren.size();
-         bm->m_Conn = connect(bookmark, &ContactMethod::changed, [this,bm]() {
-            d_ptr->slotIndexChanged(index(bm->m_Index,0,index(bm->m_pParent->m_Index,0)));
-         });
-
-         beginInsertRows(index(item->m_Index,0), item->m_lChildren.size(), item->m_lChildren.size());
-         item->m_lChildren << bm;
-         endInsertRows();
-
-         if (!d_ptr->m_Tracked[bookmark]) {
-            const QString displayName = bm->m_pNumber->roleData(Qt::DisplayRole).toString();
-
-            QMetaObject::Connection conn = connect(bookmark, &ContactMethod::primaryNameChanged, [this,displayName,bm]() {
-               //If a contact arrive later, reload
-               if (displayName != bm->m_pNumber->roleData(Qt::DisplayRole)) {
-                  reloadCategories();
-               }
-            });
+   const QSet<ContactMethod*> current = QSet<ContactMethod*>::fromList(bookmarks.toList());
 
-            d_ptr->m_Tracked[bookmark] = conn;
-         }
-      }
-      else
-         qDebug() << "ERROR count";
+   for (ContactMethod* cm : d_ptr->m_hBookmarks.keys()) {
+      if (!current.contains(cm))
+         d_ptr->removeBookmark(cm);
    }
 
-
-   emit layoutAboutToBeChanged();
-   emit layoutChanged();
+   for (ContactMethod* cm : bookmarks)
+      d_ptr->insertBookmark(cm);
 } //reloadCategories
 
 //Do nothing
@@ -315,8 +267,7 @@ int CategorizedBookmarkModel::rowCount( const QModelIndex& parent ) const
    switch (modelItem->m_Type) {
       case NumberTreeBackend::Type::CATEGORY:
          if (modelItem->m_MostPopular) {
-            static auto& index = PhoneDirectoryModel::instance().d_ptr->m_lPopularityIndex;
-            return index.size();
+            return PhoneDirectoryModel::instance().mostPopularNumberModel()->rowCount();
          }
          else
             return modelItem->m_lChildren.size();
@@ -465,6 +416,164 @@ ContactMethod* CategorizedBookmarkModel::getNumber(const QModelIndex& idx)
    return nullptr;
 }
 
+///The "Most popular" category is a proxy of the popularity index model
+QModelIndex CategorizedBookmarkModelPrivate::mostPopularIndex() const
+{
+   NumberTreeBackend* item = m_hCategories.value("mp");
+   return item ? q_ptr->index(item->m_Index,0) : QModelIndex();
+}
+
+///Forward the popularity index changes to the "Most popular" category
+void CategorizedBookmarkModelPrivate::trackPopularModel()
+{
+   QAbstractItemModel* m = PhoneDirectoryModel::instance().mostPopularNumberModel();
+
+   connect(m, &QAbstractItemModel::rowsAboutToBeInserted, this, [this](const QModelIndex&, int first, int last) {
+      q_ptr->beginInsertRows(mostPopularIndex(), first, last);
+   });
+   connect(m, &QAbstractItemModel::rowsInserted, this, [this]() {
+      q_ptr->endInsertRows();
+   });
+   connect(m, &QAbstractItemModel::rowsAboutToBeRemoved, this, [this](const QModelIndex&, int first, int last) {
+      q_ptr->beginRemoveRows(mostPopularIndex(), first, last);
+   });
+   connect(m, &QAbstractItemModel::rowsRemoved, this, [this]() {
+      q_ptr->endRemoveRows();
+   });
+   connect(m, &QAbstractItemModel::rowsAboutToBeMoved, this, [this](const QModelIndex&, int start, int end, const QModelIndex&, int dest) {
+      const QModelIndex mp = mostPopularIndex();
+      q_ptr->beginMoveRows(mp, start, end, mp, dest);
+   });
+   connect(m, &QAbstractItemModel::rowsMoved, this, [this]() {
+      q_ptr->endMoveRows();
+   });
+   connect(m, &QAbstractItemModel::dataChanged, this, [this](const QModelIndex& tl, const QModelIndex& br) {
+      const QModelIndex mp = mostPopularIndex();
+      emit q_ptr->dataChanged(q_ptr->index(tl.row(),0,mp), q_ptr->index(br.row(),0,mp));
+   });
+
+   //Only the category children are reset, not the bookmarks
+   connect(m, &QAbstractItemModel::modelAboutToBeReset, this, [this, m]() {
+      m_PopularReset = m->rowCount() > 0;
+      if (m_PopularReset)
+         q_ptr->beginRemoveRows(mostPopularIndex(), 0, m->rowCount()-1);
+   });
+   connect(m, &QAbstractItemModel::modelReset, this, [this, m]() {
+      if (m_PopularReset)
+         q_ptr->endRemoveRows();
+
+      m_PopularReset = false;
+
+      if (m->rowCount()) {
+         q_ptr->beginInsertRows(mostPopularIndex(), 0, m->rowCount()-1);
+         q_ptr->endInsertRows();
+      }
+   });
+}
+
+///Get or create a bookmark category
+NumberTreeBackend* CategorizedBookmarkModelPrivate::categoryNode(const QString& name)
+{
+   if (NumberTreeBackend* item = m_hCategories.value(name))
+      return item;
+
+   NumberTreeBackend* item = new NumberTreeBackend(name);
+   m_hCategories[name] = item;
+   item->m_Index = m_lCategoryCounter.size();
+
+   q_ptr->beginInsertRows(QModelIndex(), m_lCategoryCounter.size(),m_lCategoryCounter.size());
+   m_lCategoryCounter << item;
+   q_ptr->endInsertRows();
+
+   return item;
+}
+
+///Insert an existing node in the category matching its current name
+void CategorizedBookmarkModelPrivate::attach(NumberTreeBackend* bm)
+{
+   NumberTreeBackend* item = categoryNode(category(bm));
+
+   bm->m_pParent = item;
+   bm->m_Index   = item->m_lChildren.size();
+
+   q_ptr->beginInsertRows(q_ptr->index(item->m_Index,0), item->m_lChildren.size(), item->m_lChildren.size());
+   item->m_lChildren << bm;
+   q_ptr->endInsertRows();
+}
+
+///Remove the node from its category, the empty categories are removed
+void CategorizedBookmarkModelPrivate::detach(NumberTreeBackend* bm)
+{
+   NumberTreeBackend* item = bm->m_pParent;
+
+   if (!item)
+      return;
+
+   q_ptr->beginRemoveRows(q_ptr->index(item->m_Index,0), bm->m_Index, bm->m_Index);
+   item->m_lChildren.removeAt(bm->m_Index);
+   for (int i = bm->m_Index; i < item->m_lChildren.size(); i++)
+      item->m_lChildren[i]->m_Index = i;
+   q_ptr->endRemoveRows();
+
+   bm->m_pParent = nullptr;
+   bm->m_Index   = -1;
+
+   if (item->m_lChildren.isEmpty() && !item->m_MostPopular) {
+      q_ptr->beginRemoveRows(QModelIndex(), item->m_Index, item->m_Index);
+      m_lCategoryCounter.removeAt(item->m_Index);
+      for (int i = item->m_Index; i < m_lCategoryCounter.size(); i++)
+         m_lCategoryCounter[i]->m_Index = i;
+      m_hCategories.remove(item->m_Name);
+      q_ptr->endRemoveRows();
+
+      delete item;
+   }
+}
+
+void CategorizedBookmarkModelPrivate::insertBookmark(ContactMethod* number)
+{
+   if (!number || m_hBookmarks.contains(number))
+      return;
+
+   number->setBookmarked(true);
+
+   NumberTreeBackend* bm = new NumberTreeBackend(number);
+   m_hBookmarks[number] = bm;
+
+   bm->m_Conn = connect(number, &ContactMethod::changed, [this,bm]() {
+      slotIndexChanged(q_ptr->index(bm->m_Index,0,q_ptr->index(bm->m_pParent->m_Index,0)));
+   });
+
+   attach(bm);
+
+   //If a contact arrive later, move the bookmark to its new category
+   if (!m_Tracked[number]) {
+      m_Tracked[number] = connect(number, &ContactMethod::primaryNameChanged, [this,number]() {
+         NumberTreeBackend* node = m_hBookmarks.value(number);
+
+         if (node && node->m_pParent && category(node) != node->m_pParent->m_Name) {
+            detach(node);
+            attach(node);
+         }
+      });
+   }
+}
+
+bool CategorizedBookmarkModelPrivate::removeBookmark(ContactMethod* number)
+{
+   NumberTreeBackend* bm = m_hBookmarks.take(number);
+
+   if (!bm)
+      return false;
+
+   detach(bm);
+   delete bm;
+
+   disconnect(m_Tracked.take(number));
+
+   return true;
+}
+
 ///Callback when an item change
 void CategorizedBookmarkModelPrivate::slotIndexChanged(const QModelIndex& idx)
 {
@@ -473,15 +582,13 @@ void CategorizedBookmarkModelPrivate::slotIndexChanged(const QModelIndex& idx)
 
 bool CategorizedBookmarkModel::addItemCallback(const ContactMethod* item)
 {
-   Q_UNUSED(item)
-   reloadCategories(); //TODO this is far from optimal
+   d_ptr->insertBookmark(const_cast<ContactMethod*>(item));
    return true;
 }
 
 bool CategorizedBookmarkModel::removeItemCallback(const ContactMethod* item)
 {
-   Q_UNUSED(item)
-   return false;
+   return d_ptr->removeBookmark(const_cast<ContactMethod*>(item));
 }
 
 void CategorizedBookmarkModel::collectionAddedCallback(CollectionInterface* backend)
@@ -22,6 +22,8 @@
 #include <QtCore/QDate>
 #include <QtCore/QMimeData>
 #include <QtCore/QCoreApplication>
+#include <QtCore/QPointer>
+#include <QtCore/QSet>
 
 //Ring
 #include "callmodel.h"
@@ -101,18 +103,25 @@ public:
    bool                                 m_UnreachableHidden;
    SortingCategory::ModelTuple*         m_pSortedProxy {nullptr};
    CategorizedContactModel::SortedProxy m_pProxies         ;
+   QVector< QPointer<Person> >          m_lPendingContacts ;
+   bool                                 m_FlushQueued      ;
+   bool                                 m_RegroupQueued    ;
 
    //Helper
    ContactTreeNode* getContactTopLevelItem(const QString& category);
    QModelIndex getIndex(int row, int column, ContactTreeNode* parent);
    void reloadTreeVisibility               (ContactTreeNode*);
+   void addContacts                        (const QVector<const Person*>& contacts);
+   void regroup                            ();
+   void scheduleRegroup                    ();
 
 private:
    CategorizedContactModel* q_ptr;
 
 public Q_SLOTS:
-   void reloadCategories();
    void slotContactAdded(const Person* c);
+   void slotFlush();
+   void slotRegroup();
 };
 
 ContactTreeNode::ContactTreeNode(const Person* ct, CategorizedContactModel* parent) :
@@ -233,7 +242,8 @@ void ContactTreeNode::setVisible(bool v)
 }
 
 CategorizedContactModelPrivate::CategorizedContactModelPrivate(CategorizedContactModel* parent) : QObject(parent), q_ptr(parent),
-m_lCategoryCounter(),m_Role(Qt::DisplayRole),m_SortAlphabetical(true),m_UnreachableHidden(false),m_pSortedProxy(nullptr)
+m_lCategoryCounter(),m_Role(Qt::DisplayRole),m_SortAlphabetical(true),m_UnreachableHidden(false),m_pSortedProxy(nullptr),
+m_FlushQueued(false),m_RegroupQueued(false)
 {
 
 }
@@ -248,11 +258,13 @@ CategorizedContactModel::CategorizedContactModel(int role) : QAbstractItemModel(
 
    connect(&PersonModel::instance(),&PersonModel::newPersonAdded,d_ptr.data(),&CategorizedContactModelPrivate::slotContactAdded);
 
-   for(int i=0; i < PersonModel::instance().rowCount();i++) {
-      Person* p = qvariant_cast<Person*>(PersonModel::instance().index(i,0).data((int)Person::Role::Object));
-      d_ptr->slotContactAdded(p);
-   }
+   QVector<const Person*> persons;
+   persons.reserve(PersonModel::instance().rowCount());
+
+   for(int i=0; i < PersonModel::instance().rowCount();i++)
+      persons << qvariant_cast<Person*>(PersonModel::instance().index(i,0).data((int)Person::Role::Object));
 
+   d_ptr->addContacts(persons);
 }
 
 CategorizedContactModel::~CategorizedContactModel()
@@ -306,50 +318,232 @@ ContactTreeNode* CategorizedContactModelPrivate::getContactTopLevelItem(const QS
    return item;
 }
 
-void CategorizedContactModelPrivate::reloadCategories()
+/**
+ * Move the contacts whose category changed to their new bucket. The nodes
+ * are kept: the consecutive contacts going to the same category are moved
+ * with a single row move, the new categories are inserted first and the
+ * empty ones are removed last.
+ */
+void CategorizedContactModelPrivate::regroup()
 {
-   emit q_ptr->layoutAboutToBeChanged(); //FIXME far from optimal
-   m_hCategories.clear();
-   q_ptr->beginRemoveRows(QModelIndex(),0,m_lCategoryCounter.size()-1);
-   foreach(ContactTreeNode* item,m_lCategoryCounter) {
+   m_RegroupQueued = false;
+
+   //Most contacts keep their category when only the default one changed
+   QHash<ContactTreeNode*, QString> moved;
+
+   for (ContactTreeNode* item : m_lCategoryCounter) {
+      for (ContactTreeNode* n : item->m_lChildren) {
+         const QString val = category(n->m_pContact);
+
+         if (val != item->m_Name)
+            moved[n] = val;
+      }
+   }
+
+   if (moved.isEmpty())
+      return;
+
+   //Insert the new categories before the moves can target them
+   QSet<ContactTreeNode*> changed;
+
+   for (const QString& val : moved)
+      changed << getContactTopLevelItem(val);
+
+   //Move the runs from the last one, so the previous rows stay valid
+   const QVector<ContactTreeNode*> sources = m_lCategoryCounter;
+
+   for (ContactTreeNode* item : sources) {
+      int last = item->m_lChildren.size() - 1;
+
+      while (last >= 0) {
+         if (!moved.contains(item->m_lChildren[last])) {
+            last--;
+            continue;
+         }
+
+         const QString val = moved[item->m_lChildren[last]];
+         int first = last;
+
+         while (first > 0) {
+            const auto it = moved.constFind(item->m_lChildren[first - 1]);
+
+            if (it == moved.constEnd() || *it != val)
+               break;
+
+            first--;
+         }
+
+         ContactTreeNode* target = m_hCategories[val];
+         const int dest = target->m_lChildren.size();
+
+         q_ptr->beginMoveRows(
+            q_ptr->index(item->m_Index, 0), first, last, q_ptr->index(target->m_Index, 0), dest
+         );
+
+         for (int i = first; i <= last; i++) {
+            ContactTreeNode* n = item->m_lChildren[i];
+
+            if (n->m_Visible) {
+               item  ->m_VisibleCounter--;
+               target->m_VisibleCounter++;
+            }
+
+            n->m_Index   = target->m_lChildren.size();
+            n->m_pParent = target;
+            target->m_lChildren << n;
+
+            //Already in place when the target category is reached
+            moved.remove(n);
+         }
+
+         item->m_lChildren.remove(first, last - first + 1);
+
+         for (int i = first; i < item->m_lChildren.size(); i++)
+            item->m_lChildren[i]->m_Index = i;
+
+         q_ptr->endMoveRows();
+
+         changed << item;
+         last = first - 1;
+      }
+   }
+
+   //Remove the empty categories
+   for (int row = m_lCategoryCounter.size() - 1; row >= 0; row--) {
+      ContactTreeNode* item = m_lCategoryCounter[row];
+
+      if (!item->m_lChildren.isEmpty())
+         continue;
+
+      q_ptr->beginRemoveRows(QModelIndex(), row, row);
+
+      m_lCategoryCounter.remove(row);
+      m_hCategories.remove(item->m_Name);
+
+      for (int i = row; i < m_lCategoryCounter.size(); i++)
+         m_lCategoryCounter[i]->m_Index = i;
+
+      q_ptr->endRemoveRows();
+
+      changed.remove(item);
       delete item;
    }
-   q_ptr->endRemoveRows();
-   m_lCategoryCounter.clear();
-   for(int i=0; i < PersonModel::instance().rowCount();i++) {
-      Person* cont = qvariant_cast<Person*>(PersonModel::instance().index(i,0).data((int)Person::Role::Object));
-      slotContactAdded(cont);
+
+   //Notify the categories whose visibility changed
+   for (ContactTreeNode* item : changed) {
+      const bool visible = item->m_VisibleCounter > 0;
+
+      if (visible != item->m_Visible) {
+         item->m_Visible = visible;
+
+         const QModelIndex idx = q_ptr->index(item->m_Index, 0);
+         emit q_ptr->dataChanged(idx, idx);
+      }
    }
-   emit q_ptr->layoutChanged();
 }
 
+///Regroup once the category related properties are all set
+void CategorizedContactModelPrivate::scheduleRegroup()
+{
+   if (!m_RegroupQueued) {
+      m_RegroupQueued = true;
+      QMetaObject::invokeMethod(this, "slotRegroup", Qt::QueuedConnection);
+   }
+}
+
+void CategorizedContactModelPrivate::slotRegroup()
+{
+   //It may have been done by setRole() in the meantime
+   if (m_RegroupQueued)
+      regroup();
+}
+
+/**
+ * Insert the contacts, grouped by category, with one insertion per
+ * category. The contact method rows are part of the same insertion.
+ */
+void CategorizedContactModelPrivate::addContacts(const QVector<const Person*>& contacts)
+{
+   QHash<QString, QVector<const Person*> > groups;
+   QStringList order;
+
+   for (const Person* c : contacts) {
+      if (!c) continue;
+
+      const QString val = category(c);
+      QVector<const Person*>& group = groups[val];
+
+      if (group.isEmpty())
+         order << val;
+
+      group << c;
+   }
+
+   for (const QString& val : order) {
+      const QVector<const Person*>& group = groups[val];
+      ContactTreeNode* item = getContactTopLevelItem(val);
+      const int  first      = item->m_lChildren.size();
+      const bool wasVisible = item->m_Visible;
+
+      q_ptr->beginInsertRows(q_ptr->index(item->m_Index,0,QModelIndex()),first,first + group.size() - 1); {
+         for (const Person* c : group) {
+            ContactTreeNode* contactNode = new ContactTreeNode(c,q_ptr);
+            contactNode->m_Index   = item->m_lChildren.size();
+            contactNode->m_pParent = item;
+            item->m_lChildren << contactNode;
+
+            if (contactNode->m_Visible)
+               item->m_VisibleCounter++;
+
+            if (c->phoneNumbers().size() > 1) {
+               for (ContactMethod* m : c->phoneNumbers() ) { //TODO check if this can be merged with slotContactMethodCountChanged
+                  ContactTreeNode* n2 = new ContactTreeNode(m,q_ptr);
+                  n2->m_Index = contactNode->m_lChildren.size();
+                  n2->setParent(contactNode);
+                  contactNode->m_lChildren << n2;
+               }
+            }
+         }
+         item->m_Visible = item->m_VisibleCounter > 0;
+      } q_ptr->endInsertRows();
+
+      //The nodes are complete for rowsInserted, only notify the category
+      if (item->m_Visible != wasVisible) {
+         const QModelIndex idx = q_ptr->index(item->m_Index,0);
+         emit q_ptr->dataChanged(idx,idx);
+      }
+   }
+}
+
+///Contacts often come in bursts, insert them once per event loop iteration
 void CategorizedContactModelPrivate::slotContactAdded(const Person* c)
 {
    if (!c) return;
 
-   const QString val = category(c);
-   ContactTreeNode* item = getContactTopLevelItem(val);
-   ContactTreeNode* contactNode = new ContactTreeNode(c,q_ptr);
-   contactNode->setParent(item);
-   contactNode->m_Index = item->m_lChildren.size();
-   //emit layoutAboutToBeChanged();
-   q_ptr->beginInsertRows(q_ptr->index(item->m_Index,0,QModelIndex()),item->m_lChildren.size(),item->m_lChildren.size()); {
-      item->m_lChildren << contactNode;
-   } q_ptr->endInsertRows();
-   reloadTreeVisibility(item);
-
-   if (c->phoneNumbers().size() > 1) {
-      q_ptr->beginInsertRows(q_ptr->createIndex(contactNode->m_Index,0,contactNode),0,c->phoneNumbers().size() - 1);
-      foreach (ContactMethod* m, c->phoneNumbers() ) { //TODO check if this can be merged with slotContactMethodCountChanged
-         ContactTreeNode* n2 = new ContactTreeNode(m,q_ptr);
-         n2->m_Index = contactNode->m_lChildren.size();
-         n2->setParent(contactNode);
-         contactNode->m_lChildren << n2;
-      }
-      q_ptr->endInsertRows();
+   //The person may be deleted before the flush
+   m_lPendingContacts << QPointer<Person>(const_cast<Person*>(c));
+
+   if (!m_FlushQueued) {
+      m_FlushQueued = true;
+      QMetaObject::invokeMethod(this, "slotFlush", Qt::QueuedConnection);
+   }
+}
+
+void CategorizedContactModelPrivate::slotFlush()
+{
+   m_FlushQueued = false;
+
+   QVector<const Person*> pending;
+   pending.reserve(m_lPendingContacts.size());
+
+   for (const QPointer<Person>& c : m_lPendingContacts) {
+      if (c)
+         pending << c.data();
    }
 
-   //emit layoutChanged();
+   m_lPendingContacts.clear();
+
+   addContacts(pending);
 }
 
 bool CategorizedContactModel::setData( const QModelIndex& index, const QVariant &value, int role)
@@ -568,13 +762,16 @@ void CategorizedContactModel::setRole(int role)
 {
    if (role != d_ptr->m_Role) {
       d_ptr->m_Role = role;
-      d_ptr->reloadCategories();
+      d_ptr->regroup();
    }
 }
 
 void CategorizedContactModel::setSortAlphabetical(bool alpha)
 {
-   d_ptr->m_SortAlphabetical = alpha;
+   if (alpha != d_ptr->m_SortAlphabetical) {
+      d_ptr->m_SortAlphabetical = alpha;
+      d_ptr->scheduleRegroup();
+   }
 }
 
 bool CategorizedContactModel::isSortAlphabetical() const
@@ -584,7 +781,10 @@ bool CategorizedContactModel::isSortAlphabetical() const
 
 void CategorizedContactModel::setDefaultCategory(const QString& cat)
 {
-   d_ptr->m_DefaultCategory = cat;
+   if (cat != d_ptr->m_DefaultCategory) {
+      d_ptr->m_DefaultCategory = cat;
+      d_ptr->scheduleRegroup();
+   }
 }
 
 QString CategorizedContactModel::defaultCategory() const
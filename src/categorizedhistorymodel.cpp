@@ -37,6 +37,7 @@
 #include "historytimecategorymodel.h"
 #include "lastusednumbermodel.h"
 #include "collectioninterface.h"
+#include "localhistorycollection.h"
 
 /*****************************************************************************
  *                                                                           *
@@ -55,6 +56,9 @@ public:
    //Helpers
    HistoryNode* getCategory(const Call* call);
 
+   //Constants
+   constexpr static const int DEFAULT_HISTORY_WINDOW = 100;
+
    //Attributes
    static CallMap m_sHistoryCalls;
 
@@ -64,6 +68,7 @@ public:
    QHash<QString,HistoryNode*>  m_hCategoryByName  ;
    SortingCategory::ModelTuple* m_pSortedProxy {nullptr};
    int                          m_Role             ;
+   int                          m_HistoryWindow    ;
    QStringList                  m_lMimes           ;
    CategorizedHistoryModel::SortedProxy m_pProxies;
 
@@ -107,7 +112,7 @@ CallMap CategorizedHistoryModelPrivate::m_sHistoryCalls;
  ****************************************************************************/
 
 CategorizedHistoryModelPrivate::CategorizedHistoryModelPrivate(CategorizedHistoryModel* parent) : QObject(parent), q_ptr(parent),
-m_Role(static_cast<int>(Call::Role::FuzzyDate)),m_pSortedProxy(nullptr)
+m_Role(static_cast<int>(Call::Role::FuzzyDate)),m_HistoryWindow(DEFAULT_HISTORY_WINDOW),m_pSortedProxy(nullptr)
 {
 }
 
@@ -226,6 +231,11 @@ HistoryNode* CategorizedHistoryModelPrivate::getCategory(const Call* call)
 }
 
 
+/**
+ * Return the loaded history calls
+ *
+ * @note The older calls are only created once fetchMore() reach them
+ */
 const CallMap CategorizedHistoryModel::getHistoryCalls() const
 {
    return d_ptr->m_sHistoryCalls;
@@ -315,6 +325,24 @@ bool CategorizedHistoryModel::isHistoryEnabled() const
    return ConfigurationManager::instance().getHistoryLimit() >= 0;
 }
 
+/**
+ * Number of calls created when the history is loaded and by every fetchMore(),
+ * the older ones are kept as compact journal records until then. 0 loads all
+ * of them at once.
+ *
+ * @note The ContactMethod statistics only account for the loaded calls.
+ * @note It has to be set before the history collections are loaded.
+ */
+void CategorizedHistoryModel::setHistoryWindow(int calls)
+{
+   d_ptr->m_HistoryWindow = calls;
+}
+
+int CategorizedHistoryModel::historyWindow() const
+{
+   return d_ptr->m_HistoryWindow;
+}
+
 
 /*****************************************************************************
  *                                                                           *
@@ -499,6 +527,34 @@ bool CategorizedHistoryModel::insertRows( int row, int count, const QModelIndex
    return false;
 }
 
+///Is there calls not yet loaded, they are appended to the existing categories
+bool CategorizedHistoryModel::canFetchMore(const QModelIndex& parent) const
+{
+   if (parent.isValid())
+      return false;
+
+   for (CollectionInterface* col : collections()) {
+      if (auto lazy = dynamic_cast<LocalHistoryCollection*>(col)) {
+         if (lazy->pendingCount())
+            return true;
+      }
+   }
+
+   return false;
+}
+
+///Load the next window of older calls
+void CategorizedHistoryModel::fetchMore(const QModelIndex& parent)
+{
+   if (parent.isValid() || d_ptr->m_HistoryWindow <= 0)
+      return;
+
+   for (CollectionInterface* col : collections()) {
+      if (auto lazy = dynamic_cast<LocalHistoryCollection*>(col))
+         lazy->fetchMore(d_ptr->m_HistoryWindow);
+   }
+}
+
 QStringList CategorizedHistoryModel::mimeTypes() const
 {
    return d_ptr->m_lMimes;
@@ -64,6 +64,7 @@ public:
    bool isHistoryLimited           () const;
    bool isHistoryEnabled           () const;
    int  historyLimit               () const;
+   int  historyWindow              () const;
    const CallMap getHistoryCalls   () const;
 
    //Backend model implementation
@@ -74,6 +75,7 @@ public:
    void setHistoryLimited(bool isLimited);
    void setHistoryLimit(int numberOfDays);
    void setHistoryEnabled(bool isEnabled);
+   void setHistoryWindow(int calls);
 
    //Model implementation
    virtual bool          setData     ( const QModelIndex& index, const QVariant &value, int role   ) override;
@@ -88,6 +90,8 @@ public:
    virtual QMimeData*    mimeData    ( const QModelIndexList &indexes                              ) const override;
    virtual bool          dropMimeData( const QMimeData*, Qt::DropAction, int, int, const QModelIndex& ) override;
    virtual bool          insertRows  ( int row, int count, const QModelIndex & parent = QModelIndex() ) override;
+   virtual bool          canFetchMore( const QModelIndex& parent                                   ) const override;
+   virtual void          fetchMore   ( const QModelIndex& parent                                   ) override;
    virtual QHash<int,QByteArray> roleNames() const override;
 
    struct LIB_EXPORT SortedProxy {
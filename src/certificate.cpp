@@ -35,6 +35,7 @@
 #include "private/account_p.h"
 #include "private/certificatemodel_p.h"
 #include "private/certificate_p.h"
+#include "private/certificatevalidator.h"
 #include <account.h>
 #include <chainoftrustmodel.h>
 #include "contactmethod.h"
@@ -204,41 +205,71 @@ ChecksCache::ChecksCache(const MapStringString& checks)
    m_NotActivated                        = CertificatePrivate::toBool(checks[DRing::Certificate::ChecksNames::NOT_ACTIVATED                    ]);
 }
 
+///Use the disk cache unless a reload is requested
 void CertificatePrivate::loadDetails(bool reload)
 {
    if (!m_pDetailsCache || reload) {
+      //The key is still needed to replace the stale entry
+      const QByteArray key = CertificateValidator::key(this);
+
       MapStringString d;
-      switch(m_LoadingType) {
-         case LoadingType::FROM_PATH:
-            d = ConfigurationManager::instance().getCertificateDetailsPath(m_Path, m_PrivateKey, m_PrivateKeyPassword);
-            break;
-         case LoadingType::FROM_ID:
-            d = ConfigurationManager::instance().getCertificateDetails(m_Id);
-            break;
+
+      if (reload || !CertificateValidator::instance().lookup(key, CertificateValidator::Section::DETAILS, d)) {
+         switch(m_LoadingType) {
+            case LoadingType::FROM_PATH:
+               d = ConfigurationManager::instance().getCertificateDetailsPath(m_Path, m_PrivateKey, m_PrivateKeyPassword);
+               break;
+            case LoadingType::FROM_ID:
+               d = ConfigurationManager::instance().getCertificateDetails(m_Id);
+               break;
+         }
+         CertificateValidator::instance().store(key, CertificateValidator::Section::DETAILS, d);
       }
-      m_pDetailsCache = new DetailsCache(d);
+
+      setDetails(d);
    }
 }
 
 void CertificatePrivate::loadChecks(bool reload)
 {
    if ((!m_pCheckCache) || reload) {
+      const QByteArray key = CertificateValidator::key(this);
+
       MapStringString checks;
-      switch(m_LoadingType) {
-         case LoadingType::FROM_PATH:
-            checks = ConfigurationManager::instance().validateCertificatePath(QString(),m_Path,m_PrivateKey, m_PrivateKeyPassword, {});
-            break;
-         case LoadingType::FROM_ID:
-            checks = ConfigurationManager::instance().validateCertificate(QString(),m_Id);
-            break;
+
+      if (reload || !CertificateValidator::instance().lookup(key, CertificateValidator::Section::CHECKS, checks)) {
+         switch(m_LoadingType) {
+            case LoadingType::FROM_PATH:
+               checks = ConfigurationManager::instance().validateCertificatePath(QString(),m_Path,m_PrivateKey, m_PrivateKeyPassword, {});
+               break;
+            case LoadingType::FROM_ID:
+               checks = ConfigurationManager::instance().validateCertificate(QString(),m_Id);
+               break;
+         }
+         CertificateValidator::instance().store(key, CertificateValidator::Section::CHECKS, checks);
       }
-      if (reload && m_pCheckCache)
-         delete m_pCheckCache;
-      m_pCheckCache = new ChecksCache(checks);
-      CertificateModel::instance().d_ptr->regenChecks(q_ptr);
+
+      setChecks(checks);
    }
 }
 
+void CertificatePrivate::setDetails(const MapStringString& details)
+{
+   if (m_pDetailsCache)
+      delete m_pDetailsCache;
+
+   m_pDetailsCache = new DetailsCache(details);
+}
+
+void CertificatePrivate::setChecks(const MapStringString& checks)
+{
+   if (m_pCheckCache)
+      delete m_pCheckCache;
+
+   m_pCheckCache = new ChecksCache(checks);
+   CertificateModel::instance().d_ptr->regenChecks(q_ptr);
+}
+
 Certificate::Certificate(const QString& path, Type type, const QString& privateKey) : ItemBase(nullptr),d_ptr(new CertificatePrivate(this,LoadingType::FROM_PATH))
 {
    Q_UNUSED(privateKey)
@@ -39,6 +39,7 @@ class LIB_EXPORT Certificate : public ItemBase
    friend class CertificateModelPrivate;
    friend class SecurityEvaluationModel;
    friend class SecurityEvaluationModelPrivate;
+   friend class CertificateValidator;
 public:
 
    //Properties
@@ -41,6 +41,7 @@
 #include "daemoncertificatecollection.h"
 #include "private/matrixutils.h"
 #include "private/certificatemodel_p.h"
+#include "private/certificatevalidator.h"
 
 /*
  * This data structure is a graph wrapping the certificates in different contexts.
@@ -590,6 +591,8 @@ Certificate* CertificateModel::getCertificateFromPath(const QString& path, Accou
 
       //Add it to the model
       d_ptr->addToTree(cert,a);
+
+      CertificateValidator::instance().validate(cert);
    }
 
    CertificateNode* node = d_ptr->m_hNodes[cert];
@@ -617,6 +620,8 @@ Certificate* CertificateModel::getCertificateFromPath(const QString& path, Certi
 
       //Add it to the model
       d_ptr->addToTree(cert);
+
+      CertificateValidator::instance().validate(cert);
    }
 
    return cert;
@@ -65,7 +65,7 @@ public:
    QStringList            m_lMimes         ;
    QItemSelectionModel*   m_pSelectionModel;
    CodecModel::EditState  m_EditState      ;
-   static Matrix2D<CodecModel::EditState, CodecModel::EditAction,CodecModelFct> m_mStateMachine;
+   static const Matrix2D<CodecModel::EditState, CodecModel::EditAction,CodecModelFct> m_mStateMachine;
 
    //Callbacks
    QModelIndex add         (                        );
@@ -86,7 +86,7 @@ private:
 };
 
 #define CMP &CodecModelPrivate
-Matrix2D<CodecModel::EditState, CodecModel::EditAction,CodecModelFct> CodecModelPrivate::m_mStateMachine ={{
+constexpr Matrix2D<CodecModel::EditState, CodecModel::EditAction,CodecModelFct> CodecModelPrivate::m_mStateMachine ={{
    /*                     SAVE         MODIFY        RELOAD        CLEAR      */
    /* LOADING   */ {{ CMP::nothing, CMP::nothing, CMP::reload , CMP::nothing  }},
    /* READY     */ {{ CMP::nothing, CMP::modify , CMP::reload , CMP::clear    }},
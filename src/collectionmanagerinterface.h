@@ -97,6 +97,7 @@ class CollectionManagerInterfacePrivate;
  */
 template <class T> class LIB_EXPORT CollectionManagerInterface  : public CollectionManagerInterfaceBase {
    friend class CollectionMediator<T>;
+   friend class CollectionMediatorPrivate<T>;
 
 public:
    /**
@@ -166,6 +167,14 @@ public:
     */
    bool deleteItem(T* item);
 
+protected:
+   /**
+    * Set how the items queued by the collections loaded in other threads are
+    * added. By default, addItemCallback() is called for each of them, models
+    * able to insert them in a single transaction should set this.
+    */
+   void setAddItemsCallback(const std::function<void(const QVector<const T*>&)>& callback);
+
 private:
    /**
     * This method is called when a new collection is added. Some models
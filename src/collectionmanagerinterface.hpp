@@ -31,6 +31,7 @@ public:
    mutable CollectionMediator<T>*  m_pMediator;
    QAbstractItemModel*             q_ptr;
    CollectionManagerInterface<T>*  i_ptr;
+   std::function<void(const QVector<const T*>&)> m_fAddItems;
 
    CollectionMediator<T>* itemMediator() const;
    inline const QVector< CollectionInterface* > filterCollections(QVector< CollectionInterface* > in, FlagPack<CollectionInterface::SupportedFeatures> features) const;
@@ -198,6 +199,12 @@ void CollectionManagerInterface<T>::collectionAddedCallback(CollectionInterface*
    Q_UNUSED(collection)
 }
 
+template<class T>
+void CollectionManagerInterface<T>::setAddItemsCallback(const std::function<void(const QVector<const T*>&)>& callback)
+{
+   d_ptr->m_fAddItems = callback;
+}
+
 template<class T>
 bool CollectionManagerInterface<T>::deleteItem(T* item)
 {
@@ -16,22 +16,241 @@
  *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
  ***************************************************************************/
 
+//Qt
+#include <QtCore/QAbstractItemModel>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEvent>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+
+//Std
+#include <atomic>
+
 #include <collectionmanagerinterface.h>
+#include "private/mpscqueue.h"
 
+/**
+ * The items added from other threads are pushed into a lock-free multiple
+ * producers, single consumer queue (MpscQueue). It is drained in the model thread, one
+ * chunk per event loop iteration, so the views can be repainted between the
+ * chunks. The chunk size is adjusted to fit in INGESTION_BUDGET milliseconds.
+ *
+ * The removals from other threads go through the same queue, so they are
+ * applied after the additions queued before them. An item removed before
+ * its addition was drained is never inserted, the model doesn't see it.
+ *
+ * This object has no Q_OBJECT (it is a template), it only uses a posted
+ * event to wake the model thread.
+ */
 template<class T>
-class CollectionMediatorPrivate
+class CollectionMediatorPrivate final : public QObject
 {
 public:
-   CollectionManagerInterface<T>* m_pParent;
-   QAbstractItemModel* m_pModel;
+   constexpr static const int INGESTION_BUDGET = 8   ;
+   constexpr static const int MIN_CHUNK_SIZE   = 16  ;
+   constexpr static const int MAX_CHUNK_SIZE   = 4096;
+
+   CollectionMediatorPrivate(QAbstractItemModel* m);
+   virtual ~CollectionMediatorPrivate();
+
+   struct Node {
+      std::atomic<Node*> next  ;
+      const T*           item  ;
+      bool               remove;
+   };
+
+   //Attributes
+   CollectionManagerInterface<T>* m_pParent   ;
+   QAbstractItemModel*            m_pModel    ;
+   MpscQueue<Node>                m_Queue     ;
+   std::atomic<bool>              m_Scheduled ;
+   int                            m_ChunkSize ;
+   QMutex                         m_RemovalMutex;
+   QHash<const T*, int>           m_hRemovals ; ///< Removals still in the queue
+   QHash<const T*, int>           m_hSkipped  ; ///< Additions cancelled by them
+
+   //Helpers
+   static QEvent::Type ingestionEvent();
+   void     wake (                     );
+   bool     drain(int max              );
+   void     flush(                     );
+   void     insert(const QVector<const T*>& batch);
+   bool     isCancelled(const T* item  );
+   bool     isInserted (const T* item  );
+
+protected:
+   virtual bool event(QEvent* e) override;
 };
 
+template<class T>
+CollectionMediatorPrivate<T>::CollectionMediatorPrivate(QAbstractItemModel* m) : QObject(),
+m_pParent(nullptr), m_pModel(m), m_Scheduled(false), m_ChunkSize(MIN_CHUNK_SIZE)
+{
+   //The mediator can be created by a loader thread
+   if (m)
+      moveToThread(m->thread());
+}
+
+template<class T>
+CollectionMediatorPrivate<T>::~CollectionMediatorPrivate()
+{
+   while (Node* n = m_Queue.pop())
+      delete n;
+}
+
+template<class T>
+QEvent::Type CollectionMediatorPrivate<T>::ingestionEvent()
+{
+   static const QEvent::Type type = static_cast<QEvent::Type>(QEvent::registerEventType());
+   return type;
+}
+
+///Only post an event when the queue wasn't already scheduled to be drained
+template<class T>
+void CollectionMediatorPrivate<T>::wake()
+{
+   if (!m_Scheduled.exchange(true, std::memory_order_acq_rel))
+      QCoreApplication::postEvent(this, new QEvent(ingestionEvent()));
+}
+
+template<class T>
+void CollectionMediatorPrivate<T>::insert(const QVector<const T*>& batch)
+{
+   if (batch.isEmpty())
+      return;
+
+   QMutexLocker l(&m_pParent->m_InsertionMutex);
+
+   if (m_pParent->d_ptr->m_fAddItems) {
+      m_pParent->d_ptr->m_fAddItems(batch);
+      return;
+   }
+
+   for (const T* item : batch)
+      m_pParent->addItemCallback(item);
+}
+
+///If the item will be removed later, its addition is dropped
+template<class T>
+bool CollectionMediatorPrivate<T>::isCancelled(const T* item)
+{
+   QMutexLocker l(&m_RemovalMutex);
+
+   if (!m_hRemovals.value(item))
+      return false;
+
+   m_hSkipped[item]++;
+
+   return true;
+}
+
+///Consume a queued removal, return false if the addition was cancelled
+template<class T>
+bool CollectionMediatorPrivate<T>::isInserted(const T* item)
+{
+   QMutexLocker l(&m_RemovalMutex);
+
+   if (!--m_hRemovals[item])
+      m_hRemovals.remove(item);
+
+   auto it = m_hSkipped.find(item);
+
+   if (it == m_hSkipped.end())
+      return true;
+
+   if (!--(*it))
+      m_hSkipped.erase(it);
+
+   return false;
+}
+
+/**
+ * Apply up to "max" pending operations. The consecutive additions are
+ * inserted in a single model transaction.
+ *
+ * @return if there is still items left
+ */
+template<class T>
+bool CollectionMediatorPrivate<T>::drain(int max)
+{
+   QVector<const T*> batch;
+   batch.reserve(qMin(max, static_cast<int>(MAX_CHUNK_SIZE)));
+
+   for (int i = 0; i < max; i++) {
+      Node* n = m_Queue.pop();
+
+      if (!n)
+         break;
+
+      const T*   item     = n->item;
+      const bool isRemove = n->remove;
+      delete n;
+
+      if (!isRemove) {
+         if (!isCancelled(item))
+            batch << item;
+      }
+      else if (isInserted(item)) {
+         //Keep the order, the additions queued before are inserted first
+         insert(batch);
+         batch.clear();
+
+         QMutexLocker l(&m_pParent->m_InsertionMutex);
+         m_pParent->removeItemCallback(item);
+      }
+   }
+
+   insert(batch);
+
+   //Also true when a producer was interrupted in the middle of push()
+   return !m_Queue.isEmpty();
+}
+
+///Insert everything, used before the synchronous operations to keep the order
+template<class T>
+void CollectionMediatorPrivate<T>::flush()
+{
+   while (drain(MAX_CHUNK_SIZE));
+}
+
+template<class T>
+bool CollectionMediatorPrivate<T>::event(QEvent* e)
+{
+   if (e->type() != ingestionEvent())
+      return QObject::event(e);
+
+   //Reset first, anything pushed from now on will wake the loop again
+   m_Scheduled.store(false, std::memory_order_release);
+
+   QElapsedTimer t;
+   t.start();
+
+   const int  count   = m_ChunkSize;
+   const bool hasMore = drain(count);
+
+   //Adjust the next chunk to the time this one took
+   const qint64 elapsed = t.elapsed();
+
+   if (elapsed * 2 < INGESTION_BUDGET)
+      m_ChunkSize = qMin(m_ChunkSize * 2, static_cast<int>(MAX_CHUNK_SIZE));
+   else if (elapsed > INGESTION_BUDGET)
+      m_ChunkSize = qMax(m_ChunkSize / 2, static_cast<int>(MIN_CHUNK_SIZE));
+
+   //Let the pending events (including the repaints) run before the next chunk
+   if (hasMore)
+      wake();
+
+   return true;
+}
+
 template<typename T>
 CollectionMediator<T>::CollectionMediator(CollectionManagerInterface<T>* parentManager, QAbstractItemModel* m) :
-   d_ptr(new CollectionMediatorPrivate<T>())
+   d_ptr(new CollectionMediatorPrivate<T>(m))
 {
    d_ptr->m_pParent = parentManager;
-   d_ptr->m_pModel  = m;
 }
 
 template<typename T>
@@ -40,16 +259,59 @@ CollectionMediator<T>::~CollectionMediator()
    delete d_ptr;
 }
 
+/**
+ * Add an item to the model. When called from another thread, the item is
+ * queued and inserted later by the model thread, the return value is then
+ * always true.
+ */
 template<typename T>
 bool CollectionMediator<T>::addItem(const T* item)
 {
+   if (d_ptr->m_pModel && QThread::currentThread() != d_ptr->m_pModel->thread()) {
+      auto n    = new typename CollectionMediatorPrivate<T>::Node();
+      n->item   = item;
+      n->remove = false;
+
+      d_ptr->m_Queue.push(n);
+      d_ptr->wake();
+
+      return true;
+   }
+
+   d_ptr->flush();
+
    QMutexLocker l(&d_ptr->m_pParent->m_InsertionMutex);
    return d_ptr->m_pParent->addItemCallback(item);
 }
 
+/**
+ * Remove an item from the model. When called from another thread, the
+ * removal is queued after the pending additions and the return value is
+ * always true. If the item was not inserted yet, it never will be,
+ * otherwise it has to stay valid until the model thread removed it.
+ */
 template<typename T>
 bool CollectionMediator<T>::removeItem(const T* item)
 {
+   if (d_ptr->m_pModel && QThread::currentThread() != d_ptr->m_pModel->thread()) {
+      {
+         QMutexLocker l(&d_ptr->m_RemovalMutex);
+         d_ptr->m_hRemovals[item]++;
+      }
+
+      auto n    = new typename CollectionMediatorPrivate<T>::Node();
+      n->item   = item;
+      n->remove = true;
+
+      d_ptr->m_Queue.push(n);
+      d_ptr->wake();
+
+      return true;
+   }
+
+   //The item may still be in the queue
+   d_ptr->flush();
+
    QMutexLocker l(&d_ptr->m_pParent->m_InsertionMutex);
    return d_ptr->m_pParent->removeItemCallback(item);
 }
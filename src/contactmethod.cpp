@@ -106,7 +106,7 @@ const ContactMethod* ContactMethod::BLANK()
 ContactMethodPrivate::ContactMethodPrivate(const URI& uri, NumberCategory* cat, ContactMethod::Type st, ContactMethod* q) :
    m_Uri(uri),m_pCategory(cat),m_Tracked(false),m_Present(false),m_LastUsed(0),
    m_Type(st),m_PopularityIndex(-1),m_pPerson(nullptr),m_pAccount(nullptr),
-   m_LastWeekCount(0),m_LastTrimCount(0),m_HaveCalled(false),m_IsBookmark(false),m_TotalSeconds(0),
+   m_HaveCalled(false),m_IsBookmark(false),m_TotalSeconds(0),
    m_Index(-1),m_hasType(false),m_pTextRecording(nullptr), m_pCertificate(nullptr), q_ptr(q)
 {}
 
@@ -196,8 +196,7 @@ void ContactMethod::setAccount(Account* account)
    if (account && !d_ptr->m_pAccount) {
       account->d_ptr->m_HaveCalled    += d_ptr->m_HaveCalled    ;
       account->d_ptr->m_TotalCount    += callCount()            ;
-      account->d_ptr->m_LastWeekCount += d_ptr->m_LastWeekCount ;
-      account->d_ptr->m_LastTrimCount += d_ptr->m_LastTrimCount ;
+      account->d_ptr->m_Usage         += d_ptr->m_Usage         ;
 
       if (d_ptr->m_LastUsed > account->d_ptr->m_LastUsed)
          account->d_ptr->m_LastUsed = d_ptr->m_LastUsed;
@@ -352,12 +351,12 @@ int ContactMethod::callCount() const
 
 uint ContactMethod::weekCount() const
 {
-   return d_ptr->m_LastWeekCount;
+   return d_ptr->m_Usage.weekCount();
 }
 
 uint ContactMethod::trimCount() const
 {
-   return d_ptr->m_LastTrimCount;
+   return d_ptr->m_Usage.trimCount();
 }
 
 bool ContactMethod::haveCalled() const
@@ -555,7 +554,7 @@ QVariant ContactMethod::roleData(int role) const
          return QVariant::fromValue(Call::LifeCycleState::FINISHED);
       case static_cast<int>(Ring::Role::UnreadTextMessageCount):
          if (auto rec = textRecording())
-            cat = rec->unreadInstantTextMessagingModel()->rowCount();
+            cat = rec->unreadCount();
          else
             cat = 0;
          break;
@@ -577,20 +576,9 @@ void ContactMethod::addCall(Call* call)
    d_ptr->m_Type = ContactMethod::Type::USED;
    d_ptr->m_lCalls << call;
    d_ptr->m_TotalSeconds += call->stopTimeStamp() - call->startTimeStamp();
-   time_t now;
-   ::time ( &now );
-
-   if (now - 3600*24*7 < call->stopTimeStamp()) {
-      d_ptr->m_LastWeekCount++;
-      if (d_ptr->m_pAccount)
-         d_ptr->m_pAccount->d_ptr->m_LastWeekCount++;
-   }
-
-   if (now - 3600*24*7*15 < call->stopTimeStamp()) {
-      d_ptr->m_LastTrimCount++;
-      if (d_ptr->m_pAccount)
-         d_ptr->m_pAccount->d_ptr->m_LastTrimCount++;
-   }
+   d_ptr->m_Usage.add(call->stopTimeStamp());
+   if (d_ptr->m_pAccount)
+      d_ptr->m_pAccount->d_ptr->m_Usage.add(call->stopTimeStamp());
 
    if (call->direction() == Call::Direction::OUTGOING) {
       d_ptr->m_HaveCalled = true;
@@ -54,6 +54,7 @@ public:
    friend class PhoneDirectoryModelPrivate;
    friend class LocalTextRecordingCollection;
    friend class CallPrivate;
+   friend class PopularityIndex;
 
    enum class Role {
       Uri          = static_cast<int>(Ring::Role::UserRole) + 1000,
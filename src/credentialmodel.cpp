@@ -84,7 +84,7 @@ public:
    CredentialModel::EditState m_EditState    ;
    CredentialModel*           q_ptr          ;
    uint                       m_TopLevelCount = {3};
-   static Matrix2D<CredentialModel::EditState, CredentialModel::EditAction,CredModelFct> m_mStateMachine;
+   static const Matrix2D<CredentialModel::EditState, CredentialModel::EditAction,CredModelFct> m_mStateMachine;
    CredentialNode* m_pSipCat   {nullptr};
    CredentialNode* m_pTurnCat  {nullptr};
    CredentialNode* m_pStunCat  {nullptr};
@@ -104,7 +104,7 @@ public:
 };
 
 #define CMP &CredentialModelPrivate
-Matrix2D<CredentialModel::EditState, CredentialModel::EditAction,CredModelFct> CredentialModelPrivate::m_mStateMachine ={{
+constexpr Matrix2D<CredentialModel::EditState, CredentialModel::EditAction,CredModelFct> CredentialModelPrivate::m_mStateMachine ={{
    /*                                              SAVE         MODIFY        RELOAD        CLEAR       */
    { CredentialModel::EditState::LOADING  , {{ CMP::nothing, CMP::nothing, CMP::reload, CMP::nothing  }}},
    { CredentialModel::EditState::READY    , {{ CMP::nothing, CMP::modify , CMP::reload, CMP::clear    }}},
@@ -549,7 +549,7 @@ Credential* CredentialModel::primaryCredential(Credential::Type type)
  */
 
 ///Is a credential type available for an account protocol
-const Matrix2D<Credential::Type, Account::Protocol, bool> NewCredentialTypeModel::m_smAvailableInProtocol = {
+constexpr Matrix2D<Credential::Type, Account::Protocol, bool> NewCredentialTypeModel::m_smAvailableInProtocol = {
    /*                          SIP   IAX    RING */
    { Credential::Type::SIP , {{true, false, false}}},
    { Credential::Type::STUN, {{true, false, true }}},
@@ -557,7 +557,7 @@ const Matrix2D<Credential::Type, Account::Protocol, bool> NewCredentialTypeModel
 };
 
 ///The maximum number of credentials (-1 = inf), this could be protocol dependent
-const Matrix1D<Credential::Type, int> NewCredentialTypeModel::m_smMaximumCount = {
+constexpr Matrix1D<Credential::Type, int> NewCredentialTypeModel::m_smMaximumCount = {
    { Credential::Type::SIP , -1 },
    { Credential::Type::STUN,  1 },
    { Credential::Type::TURN,  1 },
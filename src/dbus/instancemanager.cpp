@@ -24,6 +24,11 @@
 #include "../globalinstances.h"
 #include "../interfaces/dbuserrorhandleri.h"
 
+#ifdef ENABLE_STANDIN_DAEMON
+ #include <QtCore/QTimer>
+ #include "../private/standindaemon.h"
+#endif
+
 InstanceManagerInterface& InstanceManager::instance()
 {
 #ifdef ENABLE_LIBWRAP
@@ -56,5 +61,19 @@ InstanceManagerInterface& InstanceManager::instance()
      */
 
 #endif
+
+#ifdef ENABLE_STANDIN_DAEMON
+    static bool standIn = false;
+    if (!standIn && qEnvironmentVariableIsSet("RING_STANDIN_SCRIPT")) {
+        standIn = true;
+
+        //Wait until the other interfaces exist
+        QTimer::singleShot(0, [] {
+            if (StandInDaemon::instance().load(QString::fromLocal8Bit(qgetenv("RING_STANDIN_SCRIPT"))))
+                StandInDaemon::instance().start();
+        });
+    }
+#endif
+
     return *interface;
 }
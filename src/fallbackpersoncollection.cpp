@@ -206,11 +206,12 @@ bool FallbackPersonCollection::load()
    new ThreadWorker([this]() {
       bool ok;
       Q_UNUSED(ok)
-      QList< Person* > ret =  VCardUtils::loadDir(QUrl(d_ptr->m_Path),ok,static_cast<FallbackPersonBackendEditor*>(editor<Person>())->m_hPaths);
-      for(Person* p : ret) {
-         p->setCollection(this);
-         editor<Person>()->addExisting(p);
-      }
+      VCardUtils::loadDir(QUrl(d_ptr->m_Path),ok,static_cast<FallbackPersonBackendEditor*>(editor<Person>())->m_hPaths, [this](const QList<Person*>& batch) {
+         for(Person* p : batch) {
+            p->setCollection(this);
+            editor<Person>()->addExisting(p);
+         }
+      });
    });
 
    //Add all sub directories as new backends
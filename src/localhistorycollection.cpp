@@ -20,12 +20,17 @@
 
 //Qt
 #include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/QDataStream>
 #include <QtCore/QDir>
 #include <QtCore/QHash>
 #include <QtCore/QStandardPaths>
-#include <QtCore/QStandardPaths>
 #include <QtCore/QUrl>
 
+//Std
+#include <algorithm>
+#include <type_traits>
+
 //Ring
 #include "call.h"
 #include "media/media.h"
@@ -39,8 +44,24 @@
 #include "globalinstances.h"
 #include "interfaces/pixmapmanipulatori.h"
 
+//Private
+#include "private/phonedirectorymodel_p.h"
+
+/**
+ * The history is stored in an append-only journal of length prefixed
+ * records. Saving a call appends a new version of it, the last one wins,
+ * and removing it appends a tombstone. The journal is rewritten only when
+ * the obsolete records outnumber the live ones.
+ *
+ * The records are not in chronological order (the ini import and the
+ * compaction don't preserve it), the call records carry their start time
+ * before the fields so the pending calls can be sorted without parsing them.
+ *
+ * The old "history.ini" file is imported when no journal exists.
+ */
 class LocalHistoryEditor final : public CollectionEditor<Call>
 {
+   friend class LocalHistoryCollection;
 public:
    LocalHistoryEditor(CollectionMediator<Call>* m, LocalHistoryCollection* parent);
    virtual bool save       ( const Call* item ) override;
@@ -52,17 +73,51 @@ public:
 private:
    virtual QVector<Call*> items() const override;
 
+   enum class RecordType : quint8 {
+      CALL      = 0,
+      TOMBSTONE = 1,
+   };
+
+   //Constants
+   constexpr static const quint32 MAGIC          = 0x52484A31; // "RHJ1"
+   constexpr static const quint32 VERSION        = 1;
+   constexpr static const int     COMPACTION_MIN = 1024;
+
+   ///A call not created yet, its fields are parsed from the journal on demand
+   struct HistoryRecord {
+      qint64  offset; ///< Of the record payload in the journal
+      quint32 size  ;
+      qint64  start ;
+   };
+   static_assert(std::is_trivially_copyable<HistoryRecord>::value, "The records are stored by value");
+
    //Helpers
-   void saveCall(QTextStream& stream, const Call* call);
-   bool regenFile(const Call* toIgnore);
+   static QString filePath(const QString& name);
+   static QMap<QString,QString> toMap(const Call* call);
+   static QByteArray record(RecordType type, const QString& id, const QMap<QString,QString>& fields);
+   static bool readIni    (QVector< QMap<QString,QString> >& calls);
+   static bool writeJournal(const QVector< QMap<QString,QString> >& calls, QVector<qint64>* offsets = nullptr);
+   bool readJournal();
+   QMap<QString,QString> readPending(const HistoryRecord& pending) const;
+   bool mapJournal    ();
+   void unmapJournal  ();
+   void releaseJournal();
+   bool append (const QByteArray& rec);
+   bool compact(const Call* toIgnore);
 
    //Attributes
    QVector<Call*> m_lItems;
    LocalHistoryCollection* m_pCollection;
+   int m_RecordCount;
+
+   //Lazy loading, the pending calls are ordered from the oldest to the newest
+   QVector<HistoryRecord> m_lPending ;
+   QFile*               m_pJournal ;
+   QByteArray           m_Content  ;
 };
 
 LocalHistoryEditor::LocalHistoryEditor(CollectionMediator<Call>* m, LocalHistoryCollection* parent) :
-CollectionEditor<Call>(m),m_pCollection(parent)
+CollectionEditor<Call>(m),m_pCollection(parent),m_RecordCount(0),m_pJournal(nullptr)
 {
 
 }
@@ -75,61 +130,351 @@ CollectionInterface(new LocalHistoryEditor(mediator,this)),m_pMediator(mediator)
 
 LocalHistoryCollection::~LocalHistoryCollection()
 {
+   static_cast<LocalHistoryEditor*>(editor<Call>())->releaseJournal();
+}
 
+QString LocalHistoryEditor::filePath(const QString& name)
+{
+   return QStandardPaths::writableLocation(QStandardPaths::DataLocation) + QLatin1Char('/') + name;
 }
 
-void LocalHistoryEditor::saveCall(QTextStream& stream, const Call* call)
+QMap<QString,QString> LocalHistoryEditor::toMap(const Call* call)
 {
-   if (!CategorizedHistoryModel::instance().isHistoryEnabled())
-      return;
+   QMap<QString,QString> hc;
 
-   stream.setCodec("UTF-8");
    const QString direction = (call->direction()==Call::Direction::INCOMING)?
       Call::HistoryStateName::INCOMING : Call::HistoryStateName::OUTGOING;
 
    const Account* a = call->account();
-   stream << QString("%1=%2\n").arg(Call::HistoryMapFields::CALLID          ).arg(call->historyId()                     );
-   stream << QString("%1=%2\n").arg(Call::HistoryMapFields::TIMESTAMP_START ).arg(call->startTimeStamp()         );
-   stream << QString("%1=%2\n").arg(Call::HistoryMapFields::TIMESTAMP_STOP  ).arg(call->stopTimeStamp()          );
-   stream << QString("%1=%2\n").arg(Call::HistoryMapFields::ACCOUNT_ID      ).arg(a?QString(a->id()):""          );
-   stream << QString("%1=%2\n").arg(Call::HistoryMapFields::DISPLAY_NAME    ).arg(call->peerName()               );
-   stream << QString("%1=%2\n").arg(Call::HistoryMapFields::PEER_NUMBER     ).arg(call->peerContactMethod()->uri() );
-   stream << QString("%1=%2\n").arg(Call::HistoryMapFields::DIRECTION       ).arg(direction                      );
-   stream << QString("%1=%2\n").arg(Call::HistoryMapFields::MISSED          ).arg(call->isMissed()               );
-   stream << QString("%1=%2\n").arg(Call::HistoryMapFields::CONTACT_USED    ).arg(false                          );//TODO
+   hc[ Call::HistoryMapFields::CALLID          ] = call->historyId()                         ;
+   hc[ Call::HistoryMapFields::TIMESTAMP_START ] = QString::number(call->startTimeStamp())   ;
+   hc[ Call::HistoryMapFields::TIMESTAMP_STOP  ] = QString::number(call->stopTimeStamp())    ;
+   hc[ Call::HistoryMapFields::ACCOUNT_ID      ] = a?QString(a->id()):QString()              ;
+   hc[ Call::HistoryMapFields::DISPLAY_NAME    ] = call->peerName()                          ;
+   hc[ Call::HistoryMapFields::PEER_NUMBER     ] = call->peerContactMethod()->uri()          ;
+   hc[ Call::HistoryMapFields::DIRECTION       ] = direction                                 ;
+   hc[ Call::HistoryMapFields::MISSED          ] = QString::number(call->isMissed())         ;
+   hc[ Call::HistoryMapFields::CONTACT_USED    ] = QString::number(false)                    ;//TODO
 
    //TODO handle more than one recording
    if (call->hasRecording(Media::Media::Type::AUDIO,Media::Media::Direction::IN)) {
-      stream << QString("%1=%2\n").arg(Call::HistoryMapFields::RECORDING_PATH  ).arg(((Media::AVRecording*)call->recordings(Media::Media::Type::AUDIO,Media::Media::Direction::IN)[0])->path().path());
+      hc[ Call::HistoryMapFields::RECORDING_PATH ] = ((Media::AVRecording*)call->recordings(Media::Media::Type::AUDIO,Media::Media::Direction::IN)[0])->path().path();
    }
 
-   if (call->peerContactMethod()->contact()) {
-      stream << QString("%1=%2\n").arg(Call::HistoryMapFields::CONTACT_UID  ).arg(
-         QString(call->peerContactMethod()->contact()->uid())
-      );
-   }
+   if (call->peerContactMethod()->contact())
+      hc[ Call::HistoryMapFields::CONTACT_UID ] = QString(call->peerContactMethod()->contact()->uid());
+
    if (call->certificate())
-      stream << QString("%1=%2\n").arg(Call::HistoryMapFields::CERT_PATH).arg(call->certificate()->path());
-   stream << "\n";
-   stream.flush();
+      hc[ Call::HistoryMapFields::CERT_PATH ] = call->certificate()->path();
+
+   return hc;
+}
+
+///Serialize a record, it is prefixed by its size
+QByteArray LocalHistoryEditor::record(RecordType type, const QString& id, const QMap<QString,QString>& fields)
+{
+   QByteArray payload;
+   {
+      QDataStream stream(&payload, QIODevice::WriteOnly);
+      stream.setVersion(QDataStream::Qt_5_0);
+      stream << static_cast<quint8>(type) << id;
+
+      if (type == RecordType::CALL)
+         stream << fields[Call::HistoryMapFields::TIMESTAMP_START].toLongLong() << fields;
+   }
+
+   QByteArray rec;
+   {
+      QDataStream stream(&rec, QIODevice::WriteOnly);
+      stream.setVersion(QDataStream::Qt_5_0);
+      stream << static_cast<quint32>(payload.size());
+   }
+
+   return rec + payload;
+}
+
+/**
+ * Replay the journal to locate the latest version of every live call. The
+ * calls are only parsed once they are needed, the journal stays mapped
+ * until then.
+ *
+ * A truncated or unreadable record (for example after a crash during a write)
+ * ends the journal, the file is truncated there so the next records are
+ * appended after the last valid one. A journal with an invalid header is
+ * moved aside and replaced by an empty one, it is never silently overwritten.
+ */
+bool LocalHistoryEditor::readJournal()
+{
+   releaseJournal();
+
+   if (!mapJournal())
+      return false;
+
+   QDataStream stream(m_Content);
+   stream.setVersion(QDataStream::Qt_5_0);
+
+   quint32 magic(0), version(0);
+   stream >> magic >> version;
+
+   if (magic != MAGIC || version != VERSION) {
+      const QString path = m_pJournal->fileName();
+      const QString copy = QString("%1.%2.corrupted").arg(path).arg(time(nullptr));
+
+      qWarning() << "Invalid history journal" << path << ", it was moved to" << copy;
+      releaseJournal();
+
+      return QFile::rename(path, copy) && writeJournal({});
+   }
+
+   QHash<QString, int> indexes;
+   m_RecordCount = 0;
+
+   qint64 validEnd = stream.device()->pos();
+
+   while (!stream.atEnd()) {
+      quint32 size(0);
+      stream >> size;
+
+      if (stream.status() != QDataStream::Ok || stream.device()->bytesAvailable() < size)
+         break;
+
+      HistoryRecord pending { stream.device()->pos(), size, 0 };
+
+      QDataStream rec(QByteArray::fromRawData(m_Content.constData() + pending.offset, size));
+      rec.setVersion(QDataStream::Qt_5_0);
+      stream.skipRawData(size);
+
+      quint8  type(0);
+      QString id;
+      rec >> type >> id;
+
+      if (static_cast<RecordType>(type) == RecordType::CALL)
+         rec >> pending.start;
+
+      if (rec.status() != QDataStream::Ok || type > static_cast<quint8>(RecordType::TOMBSTONE))
+         break;
+
+      validEnd = pending.offset + size;
+      m_RecordCount++;
+
+      const auto idx = indexes.constFind(id);
+
+      switch(static_cast<RecordType>(type)) {
+         case RecordType::CALL:
+            if (idx == indexes.constEnd()) {
+               indexes[id] = m_lPending.size();
+               m_lPending << pending;
+            }
+            else
+               m_lPending[*idx] = pending;
+            break;
+         case RecordType::TOMBSTONE:
+            if (idx != indexes.constEnd())
+               m_lPending[*idx].size = 0;
+            break;
+      }
+   }
+
+   //Keep what was read so far, drop the rest of the file
+   if (validEnd < m_Content.size()) {
+      qWarning() << "The history journal is damaged, truncating it after" << m_RecordCount << "records";
+
+      if (!QFile::resize(m_pJournal->fileName(), validEnd))
+         qWarning() << "Unable to truncate the history journal";
+   }
+
+   //Drop the removed calls
+   m_lPending.erase(std::remove_if(m_lPending.begin(), m_lPending.end(), [](const HistoryRecord& p) {
+      return !p.size;
+   }), m_lPending.end());
+
+   //fetchMore() takes the most recent calls from the end
+   std::stable_sort(m_lPending.begin(), m_lPending.end(), [](const HistoryRecord& a, const HistoryRecord& b) {
+      return a.start < b.start;
+   });
+
+   if (m_lPending.isEmpty())
+      releaseJournal();
+
+   return true;
+}
+
+QMap<QString,QString> LocalHistoryEditor::readPending(const HistoryRecord& pending) const
+{
+   QDataStream rec(QByteArray::fromRawData(m_Content.constData() + pending.offset, pending.size));
+   rec.setVersion(QDataStream::Qt_5_0);
+
+   quint8                type(0);
+   QString               id;
+   qint64                start(0);
+   QMap<QString,QString> hc;
+
+   rec >> type >> id >> start >> hc;
+
+   return hc;
+}
+
+///Map the journal, it is read in memory when it can't be mapped
+bool LocalHistoryEditor::mapJournal()
+{
+   unmapJournal();
+
+   m_pJournal = new QFile(filePath("history.journal"));
+
+   if (!m_pJournal->open(QIODevice::ReadOnly)) {
+      unmapJournal();
+      return false;
+   }
+
+   if (uchar* data = m_pJournal->size() ? m_pJournal->map(0, m_pJournal->size()) : nullptr)
+      m_Content = QByteArray::fromRawData(reinterpret_cast<const char*>(data), m_pJournal->size());
+   else
+      m_Content = m_pJournal->readAll();
+
+   return true;
+}
+
+void LocalHistoryEditor::unmapJournal()
+{
+   m_Content.clear();
+
+   //Also unmap the file
+   delete m_pJournal;
+   m_pJournal = nullptr;
 }
 
-bool LocalHistoryEditor::regenFile(const Call* toIgnore)
+void LocalHistoryEditor::releaseJournal()
+{
+   m_lPending.clear();
+   unmapJournal();
+}
+
+///Parse the legacy "history.ini" file
+bool LocalHistoryEditor::readIni(QVector< QMap<QString,QString> >& calls)
+{
+   QFile file(filePath("history.ini"));
+
+   if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+      return false;
+
+   QMap<QString,QString> hc;
+
+   while (!file.atEnd()) {
+      const QString line = QString::fromUtf8(file.readLine()).trimmed();
+
+      //The item is complete
+      if (line.isEmpty() && hc.size()) {
+         calls << hc;
+         hc.clear();
+      }
+      // Add to the current set
+      else {
+         const int idx = line.indexOf('=');
+         if (idx >= 0)
+            hc[line.left(idx)] = line.mid(idx+1);
+      }
+   }
+
+   if (hc.size())
+      calls << hc;
+
+   return true;
+}
+
+/**
+ * Atomically replace the journal with a compacted version
+ *
+ * @param offsets receive the payload offset of each call record
+ */
+bool LocalHistoryEditor::writeJournal(const QVector< QMap<QString,QString> >& calls, QVector<qint64>* offsets)
 {
    QDir dir(QString('/'));
    dir.mkpath(QStandardPaths::writableLocation(QStandardPaths::DataLocation) + QLatin1Char('/') + QString());
 
-   QFile file(QStandardPaths::writableLocation(QStandardPaths::DataLocation) + QLatin1Char('/') +"history.ini");
-   if ( file.open(QIODevice::WriteOnly | QIODevice::Text) ) {
-      QTextStream stream(&file);
-      for (const Call* c : CategorizedHistoryModel::instance().getHistoryCalls()) {
-         if (c != toIgnore)
-            saveCall(stream, c);
-      }
-      file.close();
-      return true;
+   QSaveFile file(filePath("history.journal"));
+
+   if (!file.open(QIODevice::WriteOnly))
+      return false;
+
+   {
+      QDataStream stream(&file);
+      stream.setVersion(QDataStream::Qt_5_0);
+      stream << MAGIC << VERSION;
    }
-   return false;
+
+   for (const QMap<QString,QString>& hc : calls) {
+      if (offsets)
+         *offsets << file.pos() + static_cast<qint64>(sizeof(quint32));
+
+      if (!hc.isEmpty())
+         file.write(record(RecordType::CALL, hc[Call::HistoryMapFields::CALLID], hc));
+   }
+
+   return file.commit();
+}
+
+bool LocalHistoryEditor::append(const QByteArray& rec)
+{
+   QFile file(filePath("history.journal"));
+
+   //Create the journal header the first time
+   if (!file.exists() && !writeJournal({}))
+      return false;
+
+   if (!file.open(QIODevice::Append)) {
+      qWarning() << "Unable to save history";
+      return false;
+   }
+
+   const bool ret = file.write(rec) == rec.size();
+   file.close();
+
+   m_RecordCount++;
+
+   if (m_RecordCount > COMPACTION_MIN && m_RecordCount > 2 * (m_lItems.size() + m_lPending.size()))
+      compact(nullptr);
+
+   return ret;
+}
+
+/**
+ * Rewrite the journal with only the latest version of the live calls
+ *
+ * The pending calls are copied out of the mapping first, the file is unmapped
+ * before being replaced and the new one is mapped afterward.
+ */
+bool LocalHistoryEditor::compact(const Call* toIgnore)
+{
+   QVector< QMap<QString,QString> > calls;
+   calls.reserve(m_lPending.size() + m_lItems.size());
+
+   for (const HistoryRecord& pending : m_lPending)
+      calls << readPending(pending);
+
+   for (const Call* c : m_lItems) {
+      if (c != toIgnore)
+         calls << toMap(c);
+   }
+
+   unmapJournal();
+
+   QVector<qint64> offsets;
+   const bool ret = writeJournal(calls, &offsets);
+
+   if (ret) {
+      m_RecordCount = calls.size();
+
+      //The records are written in the same order with the same size
+      for (int i = 0; i < m_lPending.size(); i++)
+         m_lPending[i].offset = offsets[i];
+   }
+
+   if (!m_lPending.isEmpty() && !mapJournal()) {
+      qWarning() << "Unable to map the compacted history journal";
+      m_lPending.clear();
+   }
+
+   return ret;
 }
 
 bool LocalHistoryEditor::save(const Call* call)
@@ -137,12 +482,16 @@ bool LocalHistoryEditor::save(const Call* call)
    if (call->collection()->editor<Call>() != this)
       return addNew(const_cast<Call*>(call));
 
-   return regenFile(nullptr);
+   if (!CategorizedHistoryModel::instance().isHistoryEnabled())
+      return false;
+
+   return append(record(RecordType::CALL, call->historyId(), toMap(call)));
 }
 
 bool LocalHistoryEditor::remove(const Call* item)
 {
-   if (regenFile(item)) {
+   if (append(record(RecordType::TOMBSTONE, item->historyId(), {}))) {
+      m_lItems.removeAll(const_cast<Call*>(item));
       mediator()->removeItem(item);
       return true;
    }
@@ -157,24 +506,17 @@ bool LocalHistoryEditor::edit( Call* item)
 
 bool LocalHistoryEditor::addNew( Call* call)
 {
-   QDir dir(QString('/'));
-   dir.mkpath(QStandardPaths::writableLocation(QStandardPaths::DataLocation) + QLatin1Char('/') + QString());
-
    if ((call->collection() && call->collection()->editor<Call>() == this)  || call->historyId().isEmpty()) return false;
-   //TODO support \r and \n\r end of line
-   QFile file(QStandardPaths::writableLocation(QStandardPaths::DataLocation) + QLatin1Char('/')+"history.ini");
 
-   if ( file.open(QIODevice::Append | QIODevice::Text) ) {
-      QTextStream streamFileOut(&file);
-      saveCall(streamFileOut, call);
-      file.close();
+   if (!CategorizedHistoryModel::instance().isHistoryEnabled())
+      return false;
 
+   if (append(record(RecordType::CALL, call->historyId(), toMap(call)))) {
       const_cast<Call*>(call)->setCollection(m_pCollection);
       addExisting(call);
       return true;
    }
-   else
-      qWarning() << "Unable to save history";
+
    return false;
 }
 
@@ -215,44 +557,84 @@ bool LocalHistoryCollection::load()
    if (!CategorizedHistoryModel::instance().isHistoryEnabled())
       return false;
 
-   QFile file(QStandardPaths::writableLocation(QStandardPaths::DataLocation) + QLatin1Char('/') +"history.ini");
-   if ( file.open(QIODevice::ReadOnly | QIODevice::Text) ) {
-      QMap<QString,QString> hc;
-      QStringList lines;
+   LocalHistoryEditor* e = static_cast<LocalHistoryEditor*>(editor<Call>());
 
-      while (!file.atEnd())
-         lines << file.readLine().trimmed();
-      file.close();
+   //Import the legacy history, it is kept in case of a downgrade
+   if (!QFile::exists(LocalHistoryEditor::filePath("history.journal"))) {
+      QVector< QMap<QString,QString> > calls;
 
-      const bool      isLimited = CategorizedHistoryModel::instance().isHistoryLimited();
-      const long long dayLimit  = CategorizedHistoryModel::instance().historyLimit() * 24 * 3600;
+      if (!LocalHistoryEditor::readIni(calls)) {
+         qWarning() << "History doesn't exist or is not readable";
+         return false;
+      }
+
+      if (!LocalHistoryEditor::writeJournal(calls)) {
+         qWarning() << "Unable to import the history";
+         return false;
+      }
+   }
 
-      time_t now = time(0); // get time now
+   if (!e->readJournal()) {
+      qWarning() << "Unable to read the history journal";
+      return false;
+   }
 
-      for (const QString& line : lines) {
-         //The item is complete
-         if ((line.isEmpty() || !line.size()) && hc.size()) {
-            Call* pastCall = Call::buildHistoryCall(hc);
+   //Only create the most recent calls, the model will request the others
+   const int window = CategorizedHistoryModel::instance().historyWindow();
 
-            if (!isLimited || ( (now - pastCall->startTimeStamp()) < dayLimit) ) {
-               pastCall->setCollection(this);
-               editor<Call>()->addExisting(pastCall);
-            }
+   fetchMore(window > 0 ? window : pendingCount());
 
-            hc.clear();
-         }
-         // Add to the current set
-         else {
-            const int idx = line.indexOf("=");
-            if (idx >= 0)
-               hc[line.left(idx)] = line.right(line.size()-idx-1);
-         }
+   return true;
+}
+
+///Number of calls not yet loaded
+int LocalHistoryCollection::pendingCount() const
+{
+   return static_cast<LocalHistoryEditor*>(editor<Call>())->m_lPending.size();
+}
+
+/**
+ * Create the next "count" most recent calls that were not loaded yet. The
+ * calls older than the history limit are dropped without being created.
+ *
+ * @return the number of calls added to the collection
+ */
+int LocalHistoryCollection::fetchMore(int count)
+{
+   LocalHistoryEditor* e = static_cast<LocalHistoryEditor*>(editor<Call>());
+
+   if (e->m_lPending.isEmpty())
+      return 0;
+
+   //Notify the new numbers once the whole batch is loaded
+   PhoneDirectoryModelPrivate::BulkInsertion guard;
+
+   const bool      isLimited = CategorizedHistoryModel::instance().isHistoryLimited();
+   const long long dayLimit  = CategorizedHistoryModel::instance().historyLimit() * 24 * 3600;
+
+   time_t now = time(0); // get time now
+
+   int added = 0;
+
+   while (added < count && !e->m_lPending.isEmpty()) {
+      const LocalHistoryEditor::HistoryRecord rec = e->m_lPending.takeLast();
+
+      //The remaining records are older
+      if (isLimited && (now - rec.start) >= dayLimit) {
+         e->m_lPending.clear();
+         break;
       }
-      return true;
+
+      Call* pastCall = Call::buildHistoryCall(e->readPending(rec));
+      pastCall->setCollection(this);
+      e->addExisting(pastCall);
+      added++;
    }
-   else
-      qWarning() << "History doesn't exist or is not readable";
-   return false;
+
+   if (e->m_lPending.isEmpty())
+      e->releaseJournal();
+
+   return added;
 }
 
 bool LocalHistoryCollection::reload()
@@ -273,7 +655,12 @@ FlagPack<CollectionInterface::SupportedFeatures> LocalHistoryCollection::support
 
 bool LocalHistoryCollection::clear()
 {
-   QFile::remove(QStandardPaths::writableLocation(QStandardPaths::DataLocation) + QLatin1Char('/') +"history.ini");
+   LocalHistoryEditor* e = static_cast<LocalHistoryEditor*>(editor<Call>());
+   e->releaseJournal();
+   e->m_RecordCount = 0;
+
+   QFile::remove(LocalHistoryEditor::filePath("history.journal"));
+   QFile::remove(LocalHistoryEditor::filePath("history.ini"    ));
    return true;
 }
 
@@ -43,6 +43,10 @@ public:
 
    virtual FlagPack<SupportedFeatures> supportedFeatures() const override;
 
+   //Lazy loading
+   int pendingCount() const;
+   int fetchMore(int count);
+
 private:
    CollectionMediator<Call>*  m_pMediator;
 };
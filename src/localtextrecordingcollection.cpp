@@ -19,10 +19,16 @@
 
 //Qt
 #include <QtCore/QDir>
+#include <QtCore/QDateTime>
 #include <QtCore/QFile>
+#include <QtCore/QSaveFile>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
+#include <QtCore/QJsonArray>
+
+//Std
+#include <algorithm>
 
 //Ring
 #include <globalinstances.h>
@@ -32,6 +38,7 @@
 #include <media/textrecording.h>
 #include <private/textrecording_p.h>
 #include <private/contactmethod_p.h>
+#include <private/phonedirectorymodel_p.h>
 #include <media/media.h>
 
 /*
@@ -44,6 +51,18 @@
  *
  * If more than 1 peer is part of the conversation, then their hash are
  * concatenated then hashed in sha1 again.
+ *
+ * To avoid rewriting the whole conversation for each message, the changes are
+ * appended to a "<sha1>.log" journal next to the json snapshot. The snapshot
+ * is only rewritten (compacted) once the journal is as large as the
+ * conversation itself.
+ *
+ * The startup only need to know which conversations exist. A summary of each
+ * file (peers, message and unread count, last activity) is cached in the
+ * "conversations.index" file along with the size and time of the snapshot and
+ * the journal length it covers. The messages themselves are parsed the first
+ * time the conversation is used, and the least recently loaded conversations
+ * are freed once too many messages are in memory.
  */
 
 class LocalTextRecordingEditor final : public CollectionEditor<Media::Recording>
@@ -55,12 +74,33 @@ public:
    virtual bool edit       ( Media::Recording*       item ) override;
    virtual bool addNew     ( Media::Recording*       item ) override;
    virtual bool addExisting( const Media::Recording* item ) override;
-   QString fetch(const QByteArray& sha1);
+   Media::TextRecording* fetch    (const QString& sha1, const ContactMethod* cm, CollectionInterface* backend);
+   Media::TextRecording* fetchLazy(const QJsonObject& entry, CollectionInterface* backend);
+   QJsonObject           indexEntry(const QString& sha1, const QJsonObject& cached);
+
+   static QHash<QString,QJsonObject> readIndex();
+   static void writeIndex(const QJsonArray& entries);
+
+   ///Journal records required before a compaction is considered
+   constexpr static const int COMPACTION_MIN = 256;
+
+   ///Messages kept in memory before cold conversations are evicted
+   constexpr static const int MESSAGE_BUDGET = 8192;
 
 private:
    virtual QVector<Media::Recording*> items() const override;
+
+   //Helpers
+   static QString filePath(const QString& sha1);
+   static QString indexPath();
+   static int replay(QJsonObject& snapshot, const QString& path);
+   static QJsonObject read(const QString& sha1, int& records);
+   QJsonObject loadMessages(Media::TextRecording* r, const QString& sha1);
+   bool compact(Serializable::Peers* p, const QString& path);
+
    //Attributes
-   QVector<Media::Recording*> m_lNumbers;
+   QVector<Media::Recording*>      m_lNumbers;
+   QList<Media::TextRecording*>    m_lLoaded ;
 };
 
 LocalTextRecordingCollection::LocalTextRecordingCollection(CollectionMediator<Media::Recording>* mediator) :
@@ -80,32 +120,146 @@ LocalTextRecordingCollection& LocalTextRecordingCollection::instance()
    return *instance;
 }
 
+QString LocalTextRecordingEditor::filePath(const QString& sha1)
+{
+   return QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/text/" + sha1;
+}
+
 bool LocalTextRecordingEditor::save(const Media::Recording* recording)
 {
-   Q_UNUSED(recording)
-   QHash<QByteArray,QByteArray> ret = static_cast<const Media::TextRecording*>(recording)->d_ptr->toJsons();
+   const Media::TextRecordingPrivate* d = static_cast<const Media::TextRecording*>(recording)->d_ptr;
 
    QDir dir(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
 
    //Make sure the directory exist
    dir.mkdir("text/");
 
-   //Save each file
-   for (QHash<QByteArray,QByteArray>::const_iterator i = ret.begin(); i != ret.end(); ++i) {
-      QFile file(QString("%1/text/%2.json").arg(dir.path()).arg(QString(i.key())));
+   bool ret = true;
 
-      if ( file.open(QIODevice::WriteOnly | QIODevice::Text) ) {
-         QTextStream streamFileOut(&file);
-         streamFileOut.setCodec("UTF-8");
-         streamFileOut << i.value();
-         streamFileOut.flush();
-         file.close();
+   for (Serializable::Peers* p : d->m_lAssociatedPeers) {
+      const QString path = filePath(p->sha1s[0]);
+
+      //Rewrite the snapshot when the journal cost more to replay than to load,
+      //evicted conversations don't have their messages to write
+      if ((!p->isStored) || (d->m_IsLoaded && p->journalSize >= qMax(COMPACTION_MIN, p->messageCount()))) {
+         ret &= compact(p, path);
+         continue;
+      }
+
+      if (p->journal.isEmpty())
+         continue;
+
+      QFile file(path + ".log");
+
+      if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+         qWarning() << "Could not open the text recording journal" << file.fileName();
+         ret = false;
+         continue;
       }
+
+      file.write(p->journal);
+      p->journal.clear();
    }
 
+   return ret;
+}
+
+bool LocalTextRecordingEditor::compact(Serializable::Peers* p, const QString& path)
+{
+   QJsonObject output;
+   p->write(output);
+
+   QSaveFile file(path + ".json");
+
+   if (!file.open(QIODevice::WriteOnly)) {
+      qWarning() << "Could not open text recording json file" << file.fileName();
+      return false;
+   }
+
+   file.write(QJsonDocument(output).toJson());
+
+   if (!file.commit())
+      return false;
+
+   //If this fail, the records will be replayed on a snapshot already having them
+   QFile::remove(path + ".log");
+
+   p->isStored    = true;
+   p->journalSize = 0;
+   p->journal.clear();
+
    return true;
 }
 
+/**
+ * Apply the journal records to the snapshot. Returns the number of records.
+ */
+int LocalTextRecordingEditor::replay(QJsonObject& snapshot, const QString& path)
+{
+   QFile file(path);
+
+   if (!file.open(QIODevice::ReadOnly))
+      return 0;
+
+   //Take the message arrays once instead of rebuilding the snapshot for each record
+   QVector<QJsonObject> headers ;
+   QVector<QJsonArray > messages;
+
+   const QJsonArray groups = snapshot["groups"].toArray();
+   for (int i = 0; i < groups.size(); ++i) {
+      QJsonObject header = groups[i].toObject();
+      messages << header["messages"].toArray();
+      header.remove("messages");
+      headers << header;
+   }
+
+   int records = 0;
+
+   while (!file.atEnd()) {
+      const QJsonObject record = QJsonDocument::fromJson(file.readLine()).object();
+      const int         group  = record["group"].toInt(-1);
+
+      //A truncated record is left by an interrupted write, nothing follow it
+      if (group < 0 || group > headers.size()) {
+         qWarning() << "Invalid text recording journal record" << path;
+         break;
+      }
+
+      if (group == headers.size()) {
+         headers  << QJsonObject();
+         messages << QJsonArray ();
+      }
+
+      if (record.contains("header")) {
+         headers[group] = record["header"].toObject();
+      }
+      else {
+         const int index = record["index"].toInt(-1);
+
+         if (index == messages[group].size())
+            messages[group].append(record["message"]);
+         else if (index >= 0 && index < messages[group].size())
+            messages[group].replace(index, record["message"]);
+         else {
+            qWarning() << "Invalid text recording journal record" << path;
+            break;
+         }
+      }
+
+      records++;
+   }
+
+   QJsonArray output;
+   for (int i = 0; i < headers.size(); ++i) {
+      QJsonObject group = headers[i];
+      group["messages"] = messages[i];
+      output.append(group);
+   }
+   snapshot["groups"] = output;
+
+   return records;
+}
+
 bool LocalTextRecordingEditor::remove(const Media::Recording* item)
 {
    Q_UNUSED(item)
@@ -133,15 +287,231 @@ bool LocalTextRecordingEditor::addExisting(const Media::Recording* item)
    return false;
 }
 
-QString LocalTextRecordingEditor::fetch(const QByteArray& sha1)
+///Read a conversation snapshot and apply its journal
+QJsonObject LocalTextRecordingEditor::read(const QString& sha1, int& records)
+{
+   const QString path = filePath(sha1);
+
+   records = 0;
+
+   QFile file(path + ".json");
+
+   if (!file.open(QIODevice::ReadOnly)) {
+      return {};
+   }
+
+   const QByteArray content = file.readAll();
+
+   if (content.isEmpty()) {
+      qWarning() << "Text recording file is empty";
+      return {};
+   }
+
+   QJsonParseError err;
+   QJsonDocument loadDoc = QJsonDocument::fromJson(content, &err);
+
+   if (err.error != QJsonParseError::ParseError::NoError) {
+      qWarning() << "Error Decoding Text Message History Json" << err.errorString();
+      return {};
+   }
+
+   QJsonObject snapshot = loadDoc.object();
+   records = replay(snapshot, path + ".log");
+
+   return snapshot;
+}
+
+Media::TextRecording* LocalTextRecordingEditor::fetch(const QString& sha1, const ContactMethod* cm, CollectionInterface* backend)
 {
-   QFile file(QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/text/" + sha1 + ".json");
+   int records = 0;
+   const QJsonObject snapshot = read(sha1, records);
+
+   if (snapshot.isEmpty())
+      return nullptr;
 
-   if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-      return QByteArray();
+   Media::TextRecording* r = Media::TextRecording::fromJson({snapshot}, cm, backend);
+
+   for (Serializable::Peers* p : r->d_ptr->m_lAssociatedPeers) {
+      if (p && p->sha1s.first() == sha1)
+         p->journalSize += records;
    }
 
-   return QString::fromUtf8(file.readAll());
+   addExisting(r);
+
+   return r;
+}
+
+///Create a conversation from its index entry, the messages are loaded later
+Media::TextRecording* LocalTextRecordingEditor::fetchLazy(const QJsonObject& entry, CollectionInterface* backend)
+{
+   Serializable::Peers* p = SerializableEntityManager::fromJson(entry["peers"].toObject());
+
+   if (!p)
+      return nullptr;
+
+   p->journalSize = entry["journalRecords"].toInt();
+
+   Media::TextRecording* r = new Media::TextRecording();
+   r->setCollection(backend);
+
+   const QString sha1 = entry["sha1"].toString();
+
+   Media::TextRecordingPrivate* d = r->d_ptr;
+   d->m_lAssociatedPeers << p;
+   d->m_IsLoaded     = false;
+   d->m_MessageCount = entry["messages"].toInt();
+   d->m_UnreadCount  = entry["unread"  ].toInt();
+   d->m_fLoader      = [this, sha1](Media::TextRecording* rec) {
+      return loadMessages(rec, sha1);
+   };
+
+   if (!p->peers.isEmpty())
+      p->peers.first()->m_pContactMethod->setLastUsed(static_cast<time_t>(entry["lastUsed"].toDouble()));
+
+   addExisting(r);
+
+   return r;
+}
+
+QJsonObject LocalTextRecordingEditor::loadMessages(Media::TextRecording* r, const QString& sha1)
+{
+   int loaded = r->d_ptr->m_MessageCount;
+
+   for (const Media::TextRecording* other : m_lLoaded)
+      loaded += other->d_ptr->m_lNodes.size();
+
+   //Evict the least recently loaded conversations first
+   for (int i = 0; i < m_lLoaded.size() && loaded > MESSAGE_BUDGET;) {
+      Media::TextRecording* other = m_lLoaded[i];
+      const int size = other->d_ptr->m_lNodes.size();
+
+      if (other->d_ptr->evict()) {
+         loaded -= size;
+         m_lLoaded.removeAt(i);
+      }
+      else
+         i++;
+   }
+
+   m_lLoaded << r;
+
+   int records = 0;
+   return read(sha1, records);
+}
+
+QString LocalTextRecordingEditor::indexPath()
+{
+   return QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/text/conversations.index";
+}
+
+QHash<QString,QJsonObject> LocalTextRecordingEditor::readIndex()
+{
+   QHash<QString,QJsonObject> ret;
+
+   QFile file(indexPath());
+
+   if (!file.open(QIODevice::ReadOnly))
+      return ret;
+
+   const QJsonArray entries = QJsonDocument::fromJson(file.readAll()).object()["conversations"].toArray();
+
+   for (int i = 0; i < entries.size(); ++i) {
+      const QJsonObject entry = entries[i].toObject();
+      ret[entry["sha1"].toString()] = entry;
+   }
+
+   return ret;
+}
+
+void LocalTextRecordingEditor::writeIndex(const QJsonArray& entries)
+{
+   QJsonObject index;
+   index["conversations"] = entries;
+
+   QSaveFile file(indexPath());
+
+   if (!file.open(QIODevice::WriteOnly)) {
+      qWarning() << "Could not open the text recording index" << file.fileName();
+      return;
+   }
+
+   file.write(QJsonDocument(index).toJson(QJsonDocument::Compact));
+   file.commit();
+}
+
+/**
+ * Return the summary of a conversation. The cached one is used as long as
+ * the snapshot didn't change and the journal didn't grow past the covered
+ * offset, otherwise the file is parsed again.
+ */
+QJsonObject LocalTextRecordingEditor::indexEntry(const QString& sha1, const QJsonObject& cached)
+{
+   const QString   path = filePath(sha1);
+   const QFileInfo snapshotInfo(path + ".json");
+   const QFileInfo journalInfo (path + ".log" );
+
+   const double snapshotSize = static_cast<double>(snapshotInfo.size());
+   const double snapshotTime = static_cast<double>(snapshotInfo.lastModified().toMSecsSinceEpoch());
+   const double journalBytes = static_cast<double>(journalInfo.exists() ? journalInfo.size() : 0);
+
+   if (cached["snapshotSize"].toDouble(-1) == snapshotSize
+    && cached["snapshotTime"].toDouble(-1) == snapshotTime
+    && cached["journalBytes"].toDouble(-1) == journalBytes)
+      return cached;
+
+   int records = 0;
+   const QJsonObject snapshot = read(sha1, records);
+
+   if (snapshot.isEmpty())
+      return {};
+
+   int    messages = 0;
+   int    unread   = 0;
+   double lastUsed = 0;
+
+   const QJsonArray groups = snapshot["groups"].toArray();
+   for (int i = 0; i < groups.size(); ++i) {
+      const QJsonArray a = groups[i].toObject()["messages"].toArray();
+
+      for (int j = 0; j < a.size(); ++j) {
+         const QJsonObject m = a[j].toObject();
+
+         messages++;
+         lastUsed = qMax(lastUsed, m["timestamp"].toDouble());
+
+         if (m["isRead"].toBool())
+            continue;
+
+         //Same as Serializable::Message::m_HasText
+         bool hasText = !m["payload"].toString().isEmpty();
+
+         const QJsonArray payloads = m["payloads"].toArray();
+         for (int k = 0; k < payloads.size() && !hasText; ++k) {
+            const QString mimeType = payloads[k].toObject()["mimeType"].toString();
+            hasText = mimeType == QLatin1String("text/plain") || mimeType == QLatin1String("text/html");
+         }
+
+         if (hasText)
+            unread++;
+      }
+   }
+
+   QJsonObject peers;
+   peers["sha1s"] = snapshot["sha1s"];
+   peers["peers"] = snapshot["peers"];
+
+   QJsonObject entry;
+   entry["sha1"          ] = sha1        ;
+   entry["snapshotSize"  ] = snapshotSize;
+   entry["snapshotTime"  ] = snapshotTime;
+   entry["journalBytes"  ] = journalBytes;
+   entry["journalRecords"] = records     ;
+   entry["messages"      ] = messages    ;
+   entry["unread"        ] = unread      ;
+   entry["lastUsed"      ] = lastUsed    ;
+   entry["peers"         ] = peers       ;
+
+   return entry;
 }
 
 QVector<Media::Recording*> LocalTextRecordingEditor::items() const
@@ -174,48 +544,67 @@ bool LocalTextRecordingCollection::load()
     // load all text recordings so we can recover CMs that are not in the call history
     QDir dir(QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/text/");
     if (dir.exists()) {
-        // get .json files, sorted by time, latest first
+        // get .json files, sorted by time, latest first. The snapshot is not
+        // rewritten for each message, so the journal time is used when present
         QStringList filters;
         filters << "*.json";
-        auto list = dir.entryInfoList(filters, QDir::Files | QDir::NoSymLinks | QDir::Readable, QDir::Time);
+        const auto infos = dir.entryInfoList(filters, QDir::Files | QDir::NoSymLinks | QDir::Readable);
+
+        QVector<QPair<QDateTime,QString>> list;
+        list.reserve(infos.size());
+
+        for (const QFileInfo& info : infos) {
+            const QFileInfo journal(info.absolutePath() + '/' + info.completeBaseName() + ".log");
+            list << qMakePair(
+                journal.exists() ? qMax(info.lastModified(), journal.lastModified()) : info.lastModified(),
+                info.completeBaseName()
+            );
+        }
+
+        std::sort(list.begin(), list.end(), [](const QPair<QDateTime,QString>& a, const QPair<QDateTime,QString>& b) {
+            return a.first > b.first;
+        });
+
+        auto e = static_cast<LocalTextRecordingEditor*>(editor<Media::Recording>());
+
+        const QHash<QString,QJsonObject> cache = LocalTextRecordingEditor::readIndex();
+
+        QJsonArray index;
+        bool changed = false;
+
+        //Notify the new numbers once all the recordings are loaded
+        PhoneDirectoryModelPrivate::BulkInsertion guard;
 
         for (int i = 0; i < list.size(); ++i) {
-            QFileInfo fileInfo = list.at(i);
-
-            QString content;
-            QFile file(fileInfo.absoluteFilePath());
-            if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-                content = QString::fromUtf8(file.readAll());
-            } else {
-                qWarning() << "Could not open text recording json file";
-            }
+            const QJsonObject cached = cache.value(list.at(i).second);
+            const QJsonObject entry  = e->indexEntry(list.at(i).second, cached);
+
+            changed |= entry != cached;
+
+            if (entry.isEmpty())
+                continue;
 
-            if (!content.isEmpty()) {
-                QJsonParseError err;
-                QJsonDocument loadDoc = QJsonDocument::fromJson(content.toUtf8(), &err);
-
-                if (err.error == QJsonParseError::ParseError::NoError) {
-                    Media::TextRecording* r = Media::TextRecording::fromJson({loadDoc.object()}, nullptr, this);
-
-                    editor<Media::Recording>()->addExisting(r);
-
-                    // get CMs from recording
-                    for (ContactMethod *cm : r->peers()) {
-                        // since we load the recordings in order from newest to oldest, if there is
-                        // more than one found associated with a CM, we take the newest one
-                        if (!cm->d_ptr->m_pTextRecording) {
-                            cm->d_ptr->setTextRecording(r);
-                        } else {
-                            qWarning() << "CM already has text recording" << cm;
-                        }
-                    }
+            index.append(entry);
+
+            Media::TextRecording* r = e->fetchLazy(entry, this);
+
+            if (!r)
+                continue;
+
+            // get CMs from recording
+            for (ContactMethod *cm : r->peers()) {
+                // since we load the recordings in order from newest to oldest, if there is
+                // more than one found associated with a CM, we take the newest one
+                if (!cm->d_ptr->m_pTextRecording) {
+                    cm->d_ptr->setTextRecording(r);
                 } else {
-                    qWarning() << "Error Decoding Text Message History Json" << err.errorString();
+                    qWarning() << "CM already has text recording" << cm;
                 }
-            } else {
-                qWarning() << "Text recording file is empty";
             }
         }
+
+        if (changed || index.size() != cache.size())
+            LocalTextRecordingEditor::writeIndex(index);
     }
 
     // always return true, even if noting was loaded, since the collection can still be used to
@@ -287,25 +676,7 @@ bool LocalTextRecordingCollection::fetch( const QList<CollectionInterface::Eleme
 
 Media::TextRecording* LocalTextRecordingCollection::fetchFor(const ContactMethod* cm)
 {
-   const QByteArray& sha1 = cm->sha1();
-   const QString content = static_cast<LocalTextRecordingEditor*>(editor<Media::Recording>())->fetch(sha1);
-
-   if (content.isEmpty())
-      return nullptr;
-
-   QJsonParseError err;
-   QJsonDocument loadDoc = QJsonDocument::fromJson(content.toUtf8(), &err);
-
-   if (err.error != QJsonParseError::ParseError::NoError) {
-       qWarning() << "Error Decoding Text Message History Json" << err.errorString();
-       return nullptr;
-   }
-
-   Media::TextRecording* r = Media::TextRecording::fromJson({loadDoc.object()}, cm, this);
-
-   editor<Media::Recording>()->addExisting(r);
-
-   return r;
+   return static_cast<LocalTextRecordingEditor*>(editor<Media::Recording>())->fetch(cm->sha1(), cm, this);
 }
 
 Media::TextRecording* LocalTextRecordingCollection::createFor(const ContactMethod* cm)
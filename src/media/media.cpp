@@ -20,7 +20,7 @@
 #include "../private/media_p.h"
 #include <call.h>
 
-const Matrix2D<Media::Media::State, Media::Media::Action, bool> Media::MediaPrivate::m_mValidTransitions ={{
+constexpr Matrix2D<Media::Media::State, Media::Media::Action, bool> Media::MediaPrivate::m_mValidTransitions ={{
    /*                MUTE   UNMUTE  TERMINATE */
    /* ACTIVE   */ {{ true  , true  , true     }},
    /* MUTED    */ {{ true  , true  , true     }},
@@ -30,7 +30,7 @@ const Matrix2D<Media::Media::State, Media::Media::Action, bool> Media::MediaPriv
 
 //Use the Media::MediaPrivate wrapper to avoid vtable issues
 #define MEDF &MediaPrivate
-const Matrix2D<Media::Media::State, Media::Media::Action, Media::MediaTransitionFct> Media::MediaPrivate::m_mCallbacks ={{
+constexpr Matrix2D<Media::Media::State, Media::Media::Action, Media::MediaTransitionFct> Media::MediaPrivate::m_mCallbacks ={{
    /*                     MUTE           UNMUTE         TERMINATE     */
    /* ACTIVE   */ {{ MEDF::mute    , MEDF::nothing , MEDF::terminate }},
    /* MUTED    */ {{ MEDF::nothing , MEDF::unmute  , MEDF::terminate }},
@@ -144,6 +144,7 @@ Serializable::Peers* SerializableEntityManager::fromJson(const QJsonObject& json
    //Load from json
    Serializable::Peers* p = new Serializable::Peers();
    p->read(json);
+   p->isStored = true;
    m_hPeers[sha1] = p;
 
    //TODO Remove in 2016
@@ -195,6 +196,10 @@ bool Media::TextRecordingPrivate::updateMessageStatus(Serializable::Message* m,
         m->deliveryStatus = newSatus;
         modified = true;
     }
+
+    if (modified)
+        m->group->peers->journalMessage(m);
+
     return modified;
 }
 
@@ -226,16 +231,26 @@ QAbstractItemModel* Media::TextRecording::instantMessagingModel() const
       d_ptr->m_pImModel = new InstantMessagingModel(const_cast<TextRecording*>(this));
    }
 
+   d_ptr->load();
+
    return d_ptr->m_pImModel;
 }
 
 ///Set all messages as read and then save the recording
 void Media::TextRecording::setAllRead()
 {
+    //Avoid loading a conversation when there is nothing to do
+    if ((!d_ptr->m_IsLoaded) && !d_ptr->m_UnreadCount)
+        return;
+
+    d_ptr->load();
+
     bool changed = false;
     for(int row = 0; row < d_ptr->m_lNodes.size(); ++row) {
-        if (!d_ptr->m_lNodes[row]->m_pMessage->isRead) {
-            d_ptr->m_lNodes[row]->m_pMessage->isRead = true;
+        Serializable::Message* m = d_ptr->m_lNodes[row]->m_pMessage;
+        if (!m->isRead) {
+            m->isRead = true;
+            m->group->peers->journalMessage(m);
             if (d_ptr->m_pImModel) {
                 auto idx = d_ptr->m_pImModel->index(row, 0);
                 emit d_ptr->m_pImModel->dataChanged(idx,idx);
@@ -281,10 +296,22 @@ QVector<ContactMethod*> Media::TextRecording::peers() const
    be replaced by the new one, be it in KItemModels (the KDE abstract proxy
    library) or QtCore.
  */
-class TextProxyModel : public QSortFilterProxyModel
+class ConversationProxyModel : public QSortFilterProxyModel
 {
 public:
-   explicit TextProxyModel(QObject* parent) : QSortFilterProxyModel(parent){}
+   explicit ConversationProxyModel(QObject* parent) : QSortFilterProxyModel(parent){}
+
+   ///If a view or a persistent index uses this model, "proxies" are the internal models built on it
+   bool isInUse(int proxies) const
+   {
+      return !persistentIndexList().isEmpty() || receivers(SIGNAL(modelReset())) > proxies;
+   }
+};
+
+class TextProxyModel : public ConversationProxyModel
+{
+public:
+   explicit TextProxyModel(QObject* parent) : ConversationProxyModel(parent){}
    virtual bool filterAcceptsRow(int source_row, const QModelIndex& source_parent) const override
    {
       const QModelIndex srcIdx = sourceModel()->index(source_row, filterKeyColumn(), source_parent);
@@ -311,10 +338,10 @@ QAbstractItemModel* Media::TextRecording::instantTextMessagingModel() const
 /**
  * Proxy model to get the unread text messages, as well as their number (rowCount)
  */
-class UnreadProxyModel : public QSortFilterProxyModel
+class UnreadProxyModel : public ConversationProxyModel
 {
 public:
-    explicit UnreadProxyModel(QObject* parent) : QSortFilterProxyModel(parent){}
+    explicit UnreadProxyModel(QObject* parent) : ConversationProxyModel(parent){}
     virtual bool filterAcceptsRow(int source_row, const QModelIndex& source_parent) const override
     {
         const QModelIndex srcIdx = sourceModel()->index(source_row, filterKeyColumn(), source_parent);
@@ -339,27 +366,26 @@ QAbstractItemModel* Media::TextRecording::unreadInstantTextMessagingModel() cons
 }
 
 
-bool Media::TextRecording::isEmpty() const
+///If the messages are displayed, the models are only created for the views
+bool Media::TextRecordingPrivate::isInUse() const
 {
-   return !d_ptr->m_lNodes.size();
+   auto text   = static_cast<ConversationProxyModel*>(m_pTextMessagesModel      );
+   auto unread = static_cast<ConversationProxyModel*>(m_pUnreadTextMessagesModel);
+
+   return (m_pImModel && m_pImModel->isInUse(text ? 1 : 0))
+      || (text   && text  ->isInUse(unread ? 1 : 0))
+      || (unread && unread->isInUse(0));
 }
 
-QHash<QByteArray,QByteArray> Media::TextRecordingPrivate::toJsons() const
+bool Media::TextRecording::isEmpty() const
 {
-   QHash<QByteArray,QByteArray> ret;
-   for (Serializable::Peers* p : m_lAssociatedPeers) {
-//       if (p->hasChanged) {
-         p->hasChanged = false;
-
-         QJsonObject output;
-         p->write(output);
-
-         QJsonDocument doc(output);
-         ret[p->sha1s[0].toLatin1()] = doc.toJson();
-//       }
-   }
+   return !(d_ptr->m_IsLoaded ? d_ptr->m_lNodes.size() : d_ptr->m_MessageCount);
+}
 
-   return ret;
+///The number of unread text messages, it doesn't require the messages to be loaded
+int Media::TextRecording::unreadCount() const
+{
+   return d_ptr->m_UnreadCount;
 }
 
 Media::TextRecording* Media::TextRecording::fromJson(const QList<QJsonObject>& items, const ContactMethod* cm, CollectionInterface* backend)
@@ -368,21 +394,31 @@ Media::TextRecording* Media::TextRecording::fromJson(const QList<QJsonObject>& i
     if (backend)
         t->setCollection(backend);
 
-    ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
-
     //Load the history data
     for (const QJsonObject& obj : items) {
         Serializable::Peers* p = SerializableEntityManager::fromJson(obj,cm);
         t->d_ptr->m_lAssociatedPeers << p;
     }
 
+    t->d_ptr->reconstruct(cm);
+
+    return t;
+}
+
+///Create the conversation nodes from the loaded groups
+void Media::TextRecordingPrivate::reconstruct(const ContactMethod* cm)
+{
+    ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
+
     //Create the model
     bool statusChanged = false; // if a msg status changed during parsing, we need to re-save the model
-    t->instantMessagingModel();
+    q_ptr->instantMessagingModel();
+
+    int unreadCount = 0;
 
     //Reconstruct the conversation
     //TODO do it right, right now it flatten the graph
-    for (const Serializable::Peers* p : t->d_ptr->m_lAssociatedPeers) {
+    for (const Serializable::Peers* p : m_lAssociatedPeers) {
         //Seems old version didn't store that
         if (p->peers.isEmpty())
             continue;
@@ -413,33 +449,93 @@ Media::TextRecording* Media::TextRecording::fromJson(const QList<QJsonObject>& i
                     }
                 }
                 n->m_pContactMethod   = m->contactMethod;
-                t->d_ptr->m_pImModel->addRowBegin();
-                t->d_ptr->m_lNodes << n;
-                t->d_ptr->m_pImModel->addRowEnd();
+                m_pImModel->addRowBegin();
+                m_lNodes << n;
+                m_pImModel->addRowEnd();
 
                 if (lastUsed < n->m_pMessage->timestamp)
                     lastUsed = n->m_pMessage->timestamp;
+                if (m->m_HasText && !m->isRead)
+                    unreadCount++;
                 if (m->id) {
                     int status = configurationManager.getMessageStatus(m->id);
-                    t->d_ptr->m_hPendingMessages[m->id] = n;
-                    if (t->d_ptr->updateMessageStatus(m, static_cast<TextRecording::Status>(status)))
+                    m_hPendingMessages[m->id] = n;
+                    if (updateMessageStatus(m, static_cast<TextRecording::Status>(status)))
                         statusChanged = true;
                 }
             }
         }
 
         if (statusChanged)
-            t->save();
+            q_ptr->save();
 
         // update the timestamp of the CM
         peerCM->setLastUsed(lastUsed);
     }
 
-    return t;
+    m_UnreadCount = unreadCount;
+}
+
+///Load the messages of a conversation created from the collection index
+void Media::TextRecordingPrivate::load()
+{
+    if (m_IsLoaded || !m_fLoader)
+        return;
+
+    m_IsLoaded = true;
+
+    //Indexed conversations are always stored in a single file
+    const QJsonObject json = m_fLoader(q_ptr);
+
+    if (!m_lAssociatedPeers.isEmpty())
+        m_lAssociatedPeers.first()->readGroups(json);
+
+    reconstruct(nullptr);
+}
+
+/**
+ * Free the messages of a conversation, they will be loaded again the next time
+ * they are needed. Conversations waiting for a delivery status or still
+ * displayed are kept.
+ */
+bool Media::TextRecordingPrivate::evict()
+{
+    if ((!m_IsLoaded) || (!m_fLoader) || !m_hPendingMessages.isEmpty() || isInUse())
+        return false;
+
+    if (m_pImModel)
+        m_pImModel->resetBegin();
+
+    m_MessageCount = m_lNodes.size();
+
+    qDeleteAll(m_lNodes);
+    m_lNodes.clear();
+
+    for (Serializable::Peers* p : m_lAssociatedPeers) {
+        for (Serializable::Group* g : p->groups) {
+            for (Serializable::Message* m : g->messages) {
+                qDeleteAll(m->payloads);
+                delete m;
+            }
+            delete g;
+        }
+        p->groups.clear();
+    }
+
+    m_pCurrentGroup = nullptr;
+    m_IsLoaded      = false;
+
+    if (m_pImModel)
+        m_pImModel->resetEnd();
+
+    return true;
 }
 
 void Media::TextRecordingPrivate::insertNewMessage(const QMap<QString,QString>& message, ContactMethod* cm, Media::Media::Direction direction, uint64_t id)
 {
+    //The group and message positions are only known once the conversation is loaded
+    load();
+
     //Only create it if none was found on the disk
     if (!m_pCurrentGroup) {
         m_pCurrentGroup = new Serializable::Group();
@@ -452,6 +548,8 @@ void Media::TextRecordingPrivate::insertNewMessage(const QMap<QString,QString>&
             m_lAssociatedPeers << p;
         }
         p->groups << m_pCurrentGroup;
+        m_pCurrentGroup->peers = p;
+        p->journalGroup(m_pCurrentGroup);
    }
 
    //Create the message
@@ -503,7 +601,9 @@ void Media::TextRecordingPrivate::insertNewMessage(const QMap<QString,QString>&
             m_lMimeTypes << strippedMimeType;
       }
    }
+   m->group = m_pCurrentGroup;
    m_pCurrentGroup->messages << m;
+   m_pCurrentGroup->peers->journalMessage(m);
 
    //Make sure the model exist
    q_ptr->instantMessagingModel();
@@ -644,17 +744,23 @@ void Serializable::Group::read (const QJsonObject &json, const QHash<QString,Con
    for (int i = 0; i < a.size(); ++i) {
       QJsonObject o = a[i].toObject();
       Message* message = new Message();
+      message->group         = this;
       message->contactMethod = sha1s[message->authorSha1];
       message->read(o);
       messages.append(message);
    }
 }
 
-void Serializable::Group::write(QJsonObject &json) const
+void Serializable::Group::writeHeader(QJsonObject &json) const
 {
    json["id"            ] = id           ;
    json["nextGroupSha1" ] = nextGroupSha1;
    json["nextGroupId"   ] = nextGroupId  ;
+}
+
+void Serializable::Group::write(QJsonObject &json) const
+{
+   writeHeader(json);
 
    QJsonArray a;
    for (const Message* m : messages) {
@@ -704,10 +810,16 @@ void Serializable::Peers::read (const QJsonObject &json)
       peers.append(peer);
    }
 
+   readGroups(json);
+}
+
+void Serializable::Peers::readGroups(const QJsonObject &json)
+{
    QJsonArray a = json["groups"].toArray();
    for (int i = 0; i < a.size(); ++i) {
       QJsonObject o = a[i].toObject();
       Group* group = new Group();
+      group->peers = this;
       group->read(o,m_hSha1);
       groups.append(group);
    }
@@ -738,6 +850,58 @@ void Serializable::Peers::write(QJsonObject &json) const
    json["peers"] = a3;
 }
 
+/**
+ * The journal is a list of single line json records appended to the file
+ * after its last snapshot. Each record set the header or a message at a given
+ * position, so replaying it on a snapshot already containing it is harmless.
+ *
+ * Records are only kept once a snapshot exist, before that the whole file is
+ * written anyway.
+ */
+void Serializable::Peers::journalGroup(Group* g)
+{
+   if (!isStored)
+      return;
+
+   QJsonObject header;
+   g->writeHeader(header);
+
+   QJsonObject record;
+   record["group" ] = groups.indexOf(g);
+   record["header"] = header;
+
+   journal += QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n';
+   journalSize++;
+}
+
+void Serializable::Peers::journalMessage(Message* m)
+{
+   if (!isStored)
+      return;
+
+   QJsonObject message;
+   m->write(message);
+
+   //Recent messages are the most likely to change, search from the end
+   QJsonObject record;
+   record["group"  ] = groups.indexOf(m->group);
+   record["index"  ] = m->group->messages.lastIndexOf(m);
+   record["message"] = message;
+
+   journal += QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n';
+   journalSize++;
+}
+
+int Serializable::Peers::messageCount() const
+{
+   int count = 0;
+
+   for (const Group* g : groups)
+      count += g->messages.size();
+
+   return count;
+}
+
 
 ///Constructor
 InstantMessagingModel::InstantMessagingModel(Media::TextRecording* recording) : QAbstractListModel(recording),m_pRecording(recording)
@@ -867,6 +1031,7 @@ bool InstantMessagingModel::setData(const QModelIndex& idx, const QVariant &valu
         case (int)Media::TextRecording::Role::IsRead               :
             if (n->m_pMessage->isRead != value.toBool()) {
                 n->m_pMessage->isRead = value.toBool();
+                n->m_pMessage->group->peers->journalMessage(n->m_pMessage);
                 if (n->m_pMessage->m_HasText) {
                     int val = value.toBool() ? -1 : +1;
                     m_pRecording->d_ptr->m_UnreadCount += val;
@@ -898,3 +1063,31 @@ void InstantMessagingModel::addRowEnd()
 {
    endInsertRows();
 }
+
+void InstantMessagingModel::resetBegin()
+{
+   beginResetModel();
+}
+
+void InstantMessagingModel::resetEnd()
+{
+   endResetModel();
+}
+
+///If a view or a persistent index uses this model, "proxies" are the internal models built on it
+bool InstantMessagingModel::isInUse(int proxies) const
+{
+   return !persistentIndexList().isEmpty() || receivers(SIGNAL(modelReset())) > proxies;
+}
+
+///Reload the messages after the conversation was evicted
+bool InstantMessagingModel::canFetchMore(const QModelIndex& parent) const
+{
+   return (!parent.isValid()) && !m_pRecording->d_ptr->m_IsLoaded;
+}
+
+void InstantMessagingModel::fetchMore(const QModelIndex& parent)
+{
+   if (!parent.isValid())
+      m_pRecording->d_ptr->load();
+}
@@ -91,6 +91,7 @@ public:
    bool                hasMimeType              ( const QString& mimeType ) const;
    QStringList         mimeTypes                (                         ) const;
    QVector<ContactMethod*> peers                (                         ) const;
+   int                 unreadCount              (                         ) const;
 
    //Helper
    void setAllRead();
@@ -22,7 +22,8 @@
 #include <QtCore/QItemSelectionModel>
 
 //System
-#include <cmath>
+#include <algorithm>
+#include <functional>
 
 //DRing
 #include <account_const.h>
@@ -53,29 +54,48 @@ public:
       WEIGHT  = 3,
    };
 
+   ///A single completion row, the rows are kept sorted by decreasing weight
+   struct Entry {
+      ContactMethod* cm    ;
+      uint           weight;
+   };
+
+   ///An index key matching the current prefix
+   typedef QPair<QString,NumberWrapper*> Match;
+
    //Constructor
    NumberCompletionModelPrivate(NumberCompletionModel* parent);
 
    //Methods
    void updateModel();
+   void applyEntries(const QVector<Entry>& entries);
+   void clearMatches();
 
    //Helper
-   void locateNameRange  (const QString& prefix, QSet<ContactMethod*>& set);
-   void locateNumberRange(const QString& prefix, QSet<ContactMethod*>& set);
+   void locateNameRange  (const QString& prefix);
+   void locateNumberRange(const QString& prefix);
    uint getWeight(ContactMethod* number);
    uint getWeight(Account* account);
-   void getRange(QMap<QString,NumberWrapper*> map, const QString& prefix, QSet<ContactMethod*>& set) const;
+   void getRange(const PrefixIndex& index, const QString& prefix, QVector<Match>& matches) const;
+   static void filterMatches(QVector<Match>& matches, const QString& prefix);
 
    //Attributes
-   QMultiMap<int,ContactMethod*> m_hNumbers              ;
+   QVector<Entry>                m_lEntries              ;
    URI                           m_Prefix                ;
    Call*                         m_pCall                 ;
    bool                          m_Enabled               ;
    bool                          m_UseUnregisteredAccount;
    bool                          m_DisplayMostUsedNumbers;
+   int                           m_MostUsedNumberCount   ;
    QItemSelectionModel*          m_pSelectionModel       ;
    bool                          m_HasCustomSelection    ;
 
+   //Completion cache, used to narrow the previous result when the prefix grows
+   QString                       m_MatchPrefix           ;
+   uint                          m_MatchRevision         ;
+   QVector<Match>                m_lNameMatches          ;
+   QVector<Match>                m_lNumberMatches        ;
+
    QHash<Account*,TemporaryContactMethod*> m_hSipIaxTemporaryNumbers;
    QHash<Account*,TemporaryContactMethod*> m_hRingTemporaryNumbers;
    QHash<int, TemporaryContactMethod*> m_pPreferredTemporaryNumbers;
@@ -95,8 +115,8 @@ private:
 
 
 NumberCompletionModelPrivate::NumberCompletionModelPrivate(NumberCompletionModel* parent) : QObject(parent), q_ptr(parent),
-m_pCall(nullptr),m_Enabled(false),m_UseUnregisteredAccount(true), m_Prefix(QString()),m_DisplayMostUsedNumbers(false),
-m_pSelectionModel(nullptr),m_HasCustomSelection(false)
+m_pCall(nullptr),m_Enabled(false),m_UseUnregisteredAccount(true), m_Prefix(QString()),m_DisplayMostUsedNumbers(false),m_MostUsedNumberCount(10),
+m_pSelectionModel(nullptr),m_HasCustomSelection(false),m_MatchRevision(0)
 {
    //Create the temporary number list
    bool     hasNonIp2Ip = false;
@@ -167,9 +187,9 @@ QVariant NumberCompletionModel::data(const QModelIndex& index, int role ) const
    if (!index.isValid())
       return QVariant();
 
-   const QMap<int,ContactMethod*>::iterator i = d_ptr->m_hNumbers.end()-1-index.row();
-   const ContactMethod* n = i.value();
-   const int weight     = i.key  ();
+   const NumberCompletionModelPrivate::Entry& e = d_ptr->m_lEntries[index.row()];
+   const ContactMethod* n = e.cm;
+   const int weight     = e.weight;
 
    bool needAcc = (role>=100 || role == Qt::UserRole) && n->account() /*&& n->account() != AvailableAccountModel::currentDefaultAccount()*/
                   && !n->account()->isIp2ip();
@@ -240,7 +260,7 @@ int NumberCompletionModel::rowCount(const QModelIndex& parent ) const
    if (parent.isValid())
       return 0;
 
-   return d_ptr->m_hNumbers.size();
+   return d_ptr->m_lEntries.size();
 }
 
 int NumberCompletionModel::columnCount(const QModelIndex& parent ) const
@@ -307,9 +327,8 @@ void NumberCompletionModelPrivate::setPrefix(const QString& str)
    if (m_Enabled)
       updateModel();
    else {
-      q_ptr->beginRemoveRows(QModelIndex(), 0, m_hNumbers.size()-1);
-      m_hNumbers.clear();
-      q_ptr->endRemoveRows();
+      clearMatches();
+      applyEntries({});
    }
 
    if (m_Prefix.protocolHint() == URI::ProtocolHint::RING) {
@@ -333,7 +352,7 @@ ContactMethod* NumberCompletionModel::number(const QModelIndex& idx) const
 {
    if (idx.isValid()) {
       //Keep the temporary contact methods private, export a copy
-      ContactMethod* m = (d_ptr->m_hNumbers.end()-1-idx.row()).value();
+      ContactMethod* m = d_ptr->m_lEntries[idx.row()].cm;
       return m->type() == ContactMethod::Type::TEMPORARY ?
          PhoneDirectoryModel::instance().fromTemporary(qobject_cast<TemporaryContactMethod*>(m))
          : m;
@@ -344,140 +363,303 @@ ContactMethod* NumberCompletionModel::number(const QModelIndex& idx) const
 
 void NumberCompletionModelPrivate::updateModel()
 {
-   QSet<ContactMethod*> numbers;
-   q_ptr->beginRemoveRows(QModelIndex(), 0, m_hNumbers.size()-1);
-   m_hNumbers.clear();
-   q_ptr->endRemoveRows();
+   QVector<Entry> entries;
 
    if (!m_Prefix.isEmpty()) {
-      locateNameRange  ( m_Prefix, numbers );
-      locateNumberRange( m_Prefix, numbers );
+      const QString pref     = PrefixIndex::fold(m_Prefix);
+      const uint    revision = PhoneDirectoryModel::instance().d_ptr->m_IndexRevision;
+
+      //When a character is appended, the new result is a subset of the
+      //previous one. Unless the index changed in between, narrow it in place
+      //instead of searching the index again.
+      if ((!m_MatchPrefix.isEmpty()) && m_MatchRevision == revision && pref.startsWith(m_MatchPrefix)) {
+         filterMatches( m_lNameMatches  , pref );
+         filterMatches( m_lNumberMatches, pref );
+      }
+      else {
+         locateNameRange  ( pref );
+         locateNumberRange( pref );
+      }
+
+      m_MatchPrefix   = pref;
+      m_MatchRevision = revision;
+
+      QSet<ContactMethod*> numbers;
+
+      for (const Match& m : m_lNameMatches) {
+         for (ContactMethod* n : m.second->numbers) {
+            if (n)
+               numbers << n;
+         }
+      }
+
+      for (const Match& m : m_lNumberMatches) {
+         for (ContactMethod* n : m.second->numbers) {
+            if (n)
+               numbers << n;
+         }
+      }
 
       if (m_Prefix.protocolHint() == URI::ProtocolHint::RING) {
          for (TemporaryContactMethod* cm : m_hRingTemporaryNumbers) {
-            const int weight = getWeight(cm->account());
-            if (weight) {
-               q_ptr->beginInsertRows(QModelIndex(), m_hNumbers.size(), m_hNumbers.size());
-               m_hNumbers.insert(weight,cm);
-               q_ptr->endInsertRows();
-            }
+            if (!cm) continue;
+            if (const uint weight = getWeight(cm->account()))
+               entries << Entry {cm, weight};
          }
       } else {
          for (auto cm : m_hSipIaxTemporaryNumbers) {
             if (!cm) continue;
-            if (auto weight = getWeight(cm->account())) {
-               q_ptr->beginInsertRows(QModelIndex(), m_hNumbers.size(), m_hNumbers.size());
-               m_hNumbers.insert(weight, cm);
-               q_ptr->endInsertRows();
-            }
+            if (const uint weight = getWeight(cm->account()))
+               entries << Entry {cm, weight};
          }
       }
 
+      entries.reserve(entries.size() + numbers.size());
+
       for (ContactMethod* n : numbers) {
          if (m_UseUnregisteredAccount || ((n->account() && n->account()->registrationState() == Account::RegistrationState::READY)
           || !n->account())) {
-            q_ptr->beginInsertRows(QModelIndex(), m_hNumbers.size(), m_hNumbers.size());
-            m_hNumbers.insert(getWeight(n),n);
-            q_ptr->endInsertRows();
+            entries << Entry {n, getWeight(n)};
          }
       }
    }
-   else if (m_DisplayMostUsedNumbers) {
-      //If enabled, display the most probable entries
-      const QVector<ContactMethod*> cl = PhoneDirectoryModel::instance().getNumbersByPopularity();
-
-      for (int i=0;i<((cl.size()>=10)?10:cl.size());i++) {
-         ContactMethod* n = cl[i];
-         q_ptr->beginInsertRows(QModelIndex(), m_hNumbers.size(), m_hNumbers.size());
-         m_hNumbers.insert(getWeight(n),n);
-         q_ptr->endInsertRows();
+   else {
+      clearMatches();
+
+      if (m_DisplayMostUsedNumbers) {
+         //If enabled, display the most probable entries
+         const QVector<ContactMethod*> cl = PhoneDirectoryModel::instance().getNumbersByPopularity(m_MostUsedNumberCount);
+
+         for (ContactMethod* n : cl)
+            entries << Entry {n, getWeight(n)};
       }
    }
+
+   //Sort by weight, the pointer is only used to keep the order stable between keystrokes
+   std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+      return a.weight != b.weight ? a.weight > b.weight : std::less<ContactMethod*>()(a.cm, b.cm);
+   });
+
+   applyEntries(entries);
 }
 
-void NumberCompletionModelPrivate::getRange(QMap<QString,NumberWrapper*> map, const QString& prefix, QSet<ContactMethod*>& set) const
-{
-   if (prefix.isEmpty() || map.isEmpty())
+/**
+ * Transform the current rows into `entries` with the smallest set of model
+ * transactions.
+ *
+ * The rows shared by both ends of the old and new results are skipped. What
+ * is left is applied as contiguous removals, then moves of the rows that are
+ * not part of the longest run already in the right order, then contiguous
+ * insertions. The row count only changes inside the row transactions.
+ */
+void NumberCompletionModelPrivate::applyEntries(const QVector<Entry>& entries)
+{
+   const int oldSize = m_lEntries.size();
+   const int newSize = entries.size();
+
+   if (!(oldSize || newSize))
       return;
 
-   QMap<QString,NumberWrapper*>::iterator iBeg = map.begin();
-   QMap<QString,NumberWrapper*>::iterator iEnd = map.end  ()-1;
+   //Skip the common head and tail
+   int head = 0;
+   while (head < oldSize && head < newSize && m_lEntries[head].cm == entries[head].cm)
+      head++;
 
-   const QString pref = prefix.toLower();
+   int tail = 0;
+   while (tail < oldSize - head && tail < newSize - head
+    && m_lEntries[oldSize-tail-1].cm == entries[newSize-tail-1].cm)
+      tail++;
 
-   const int prefixLen = pref.size();
-   int size = map.size()/2;
-   bool startOk(false),endOk(false);
+   const int oldEnd = oldSize - tail;
+   const int newEnd = newSize - tail;
 
-   while (size > 1 && !(startOk&&endOk)) {
-      QMap<QString,NumberWrapper*>::iterator mid;
+   //Rows kept in place whose weight changed
+   int firstChanged = -1, lastChanged = -1;
 
-      if (size > 7)
-         mid = (iBeg+size);
-      else {
-         //We have to be careful with "::ceil" it may cause an overflow in some rare case
-         int toAdd = size-1;
-         mid = iBeg;
+   const auto trackWeight = [&](uint oldWeight, int row) {
+      if (oldWeight != entries[row].weight) {
+         if (firstChanged == -1 || row < firstChanged)
+            firstChanged = row;
+         lastChanged = qMax(lastChanged, row);
+      }
+   };
+
+   for (int i = 0; i < head; i++)
+      trackWeight(m_lEntries[i].weight, i);
+   for (int i = 0; i < tail; i++)
+      trackWeight(m_lEntries[oldEnd + i].weight, newEnd + i);
 
-         while (toAdd && mid != map.end()) {
-            ++mid;
-            --toAdd;
+   if (head == oldEnd && head == newEnd) {
+      m_lEntries = entries;
+   }
+   else if (head == oldEnd) {
+      q_ptr->beginInsertRows(QModelIndex(), head, newEnd - 1);
+      m_lEntries = entries;
+      q_ptr->endInsertRows();
+   }
+   else if (head == newEnd) {
+      q_ptr->beginRemoveRows(QModelIndex(), head, oldEnd - 1);
+      m_lEntries = entries;
+      q_ptr->endRemoveRows();
+   }
+   else {
+      QHash<ContactMethod*, int> newRows;
+      newRows.reserve(newEnd - head);
+
+      for (int i = head; i < newEnd; i++)
+         newRows[entries[i].cm] = i;
+
+      //Remove the rows that are gone, bottom first so the rows above stay valid
+      for (int row = oldEnd - 1; row >= head;) {
+         if (newRows.contains(m_lEntries[row].cm)) {
+            row--;
+            continue;
          }
 
+         const int last = row;
+         while (row >= head && !newRows.contains(m_lEntries[row].cm))
+            row--;
+
+         q_ptr->beginRemoveRows(QModelIndex(), row + 1, last);
+         m_lEntries.remove(row + 1, last - row);
+         q_ptr->endRemoveRows();
       }
 
-      if (mid != map.end() && mid.key().left(prefixLen) == pref && iBeg.key().left(prefixLen) < pref) {
-         //Too far, need to go back
-         iBeg = mid;
+      //The survivors, in their current order, and their target rows
+      const int survivors = m_lEntries.size() - tail - head;
 
-         while ((iBeg-1).key().left(prefixLen) == pref && iBeg != map.begin())
-            iBeg--;
+      QHash<ContactMethod*, uint> oldWeights;
+      oldWeights.reserve(survivors);
 
-         startOk = true;
-      }
-      else if ((!startOk) && mid != map.end() && mid.key().left(prefixLen) < pref) {
-         iBeg = mid;
-      }
-      else if(!endOk) {
-         iEnd = mid;
+      QVector<int> targets(survivors);
+
+      for (int i = 0; i < survivors; i++) {
+         const Entry& e = m_lEntries[head + i];
+         oldWeights[e.cm] = e.weight;
+         targets[i]       = newRows[e.cm];
       }
 
-      while ((iEnd).key().left(prefixLen) == pref && iEnd+1 != map.end()) {
-         ++iEnd;
+      //The longest increasing run of target rows doesn't need to move
+      QVector<int> tails, tailIdx, previous(survivors, -1);
+
+      for (int i = 0; i < survivors; i++) {
+         const int pos = std::lower_bound(tails.begin(), tails.end(), targets[i]) - tails.begin();
+
+         if (pos == tails.size()) {
+            tails   << targets[i];
+            tailIdx << i;
+         }
+         else {
+            tails  [pos] = targets[i];
+            tailIdx[pos] = i;
+         }
+
+         previous[i] = pos ? tailIdx[pos - 1] : -1;
       }
 
-      endOk = (iEnd.key().left(prefixLen) == pref);
+      QSet<ContactMethod*> stable;
+      for (int i = tailIdx.isEmpty() ? -1 : tailIdx.last(); i != -1; i = previous[i])
+         stable << m_lEntries[head + i].cm;
 
-      size = (int)::ceil((static_cast<float>(size))/2.0f);
-   }
+      //Put each other row right after its predecessor in the new order
+      ContactMethod* predecessor = nullptr;
 
-   while (iBeg.key().left(prefixLen) != pref && iBeg != map.end() && iBeg != iEnd)
-      ++iBeg;
+      for (int i = head; i < newEnd; i++) {
+         ContactMethod* cm = entries[i].cm;
 
-   if (iEnd == iBeg && iBeg.key().left(prefixLen) != pref) {
-      iEnd = map.end();
-      iBeg = map.end();
-   }
+         if (!oldWeights.contains(cm))
+            continue;
+
+         if (!stable.contains(cm)) {
+            int from = head;
+            while (m_lEntries[from].cm != cm)
+               from++;
+
+            int to = head;
+            if (predecessor) {
+               while (m_lEntries[to].cm != predecessor)
+                  to++;
+               to++;
+            }
+
+            if (to != from && to != from + 1) {
+               q_ptr->beginMoveRows(QModelIndex(), from, from, QModelIndex(), to);
+               m_lEntries.move(from, to > from ? to - 1 : to);
+               q_ptr->endMoveRows();
+            }
+         }
+
+         predecessor = cm;
+      }
 
-   while(iBeg != iEnd) {
-      foreach(ContactMethod* n,iBeg.value()->numbers) {
-         if (n) {
-            set << n;
+      //The rows in between are now in their final place, insert the new ones
+      for (int row = head; row < newEnd;) {
+         if (oldWeights.contains(entries[row].cm)) {
+            trackWeight(oldWeights[entries[row].cm], row);
+            row++;
+            continue;
          }
+
+         const int first = row;
+         while (row < newEnd && !oldWeights.contains(entries[row].cm))
+            row++;
+
+         q_ptr->beginInsertRows(QModelIndex(), first, row - 1);
+         m_lEntries.insert(first, row - first, Entry());
+         std::copy(entries.constBegin() + first, entries.constBegin() + row, m_lEntries.begin() + first);
+         q_ptr->endInsertRows();
       }
 
-      ++iBeg;
+      m_lEntries = entries;
+   }
+
+   if (firstChanged != -1)
+      emit q_ptr->dataChanged(
+         q_ptr->index(firstChanged, static_cast<int>(Columns::WEIGHT)),
+         q_ptr->index(lastChanged , static_cast<int>(Columns::WEIGHT))
+      );
+}
+
+void NumberCompletionModelPrivate::clearMatches()
+{
+   m_MatchPrefix.clear();
+   m_lNameMatches.clear();
+   m_lNumberMatches.clear();
+}
+
+void NumberCompletionModelPrivate::getRange(const PrefixIndex& index, const QString& prefix, QVector<Match>& matches) const
+{
+   if (prefix.isEmpty())
+      return;
+
+   int begin, end;
+   index.range(prefix, begin, end);
+
+   matches.reserve(matches.size() + end - begin);
+
+   for (int i = begin; i < end; i++) {
+      const PrefixIndex::Entry& e = index.at(i);
+      matches << Match(e.key, e.value);
    }
 }
 
-void NumberCompletionModelPrivate::locateNameRange(const QString& prefix, QSet<ContactMethod*>& set)
+void NumberCompletionModelPrivate::filterMatches(QVector<Match>& matches, const QString& prefix)
 {
-   getRange(PhoneDirectoryModel::instance().d_ptr->m_lSortedNames,prefix,set);
+   matches.erase(std::remove_if(matches.begin(), matches.end(), [&prefix](const Match& m) {
+      return !m.first.startsWith(prefix);
+   }), matches.end());
 }
 
-void NumberCompletionModelPrivate::locateNumberRange(const QString& prefix, QSet<ContactMethod*>& set)
+void NumberCompletionModelPrivate::locateNameRange(const QString& prefix)
 {
-   getRange(PhoneDirectoryModel::instance().d_ptr->m_hSortedNumbers,prefix,set);
+   m_lNameMatches.clear();
+   getRange(PhoneDirectoryModel::instance().d_ptr->m_lSortedNames,prefix,m_lNameMatches);
+}
+
+void NumberCompletionModelPrivate::locateNumberRange(const QString& prefix)
+{
+   m_lNumberMatches.clear();
+   getRange(PhoneDirectoryModel::instance().d_ptr->m_hSortedNumbers,prefix,m_lNumberMatches);
 }
 
 uint NumberCompletionModelPrivate::getWeight(ContactMethod* number)
@@ -534,6 +716,21 @@ bool NumberCompletionModel::displayMostUsedNumbers() const
    return d_ptr->m_DisplayMostUsedNumbers;
 }
 
+/**
+ * How many of the most used numbers are displayed when the prefix is empty.
+ *
+ * @note It is bounded by PhoneDirectoryModel::mostPopularCount()
+ */
+void NumberCompletionModel::setMostUsedNumberCount(int count)
+{
+   d_ptr->m_MostUsedNumberCount = count;
+}
+
+int NumberCompletionModel::mostUsedNumberCount() const
+{
+   return d_ptr->m_MostUsedNumberCount;
+}
+
 void NumberCompletionModelPrivate::resetSelectionModel()
 {
    if (!m_pSelectionModel)
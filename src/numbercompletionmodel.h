@@ -40,6 +40,7 @@ public:
    //Properties
    Q_PROPERTY(QString prefix READ prefix)
    Q_PROPERTY(bool displayMostUsedNumbers READ displayMostUsedNumbers WRITE setDisplayMostUsedNumbers)
+   Q_PROPERTY(int  mostUsedNumberCount    READ mostUsedNumberCount    WRITE setMostUsedNumberCount   )
 
    enum Role {
       ALTERNATE_ACCOUNT= (int)Ring::Role::UserRole,
@@ -65,6 +66,7 @@ public:
    void setCall(Call* call);
    void setUseUnregisteredAccounts(bool value);
    void setDisplayMostUsedNumbers(bool value);
+   void setMostUsedNumberCount(int count);
 
    //Getters
    Call* call() const;
@@ -72,6 +74,7 @@ public:
    bool isUsingUnregisteredAccounts();
    QString prefix() const;
    bool displayMostUsedNumbers() const;
+   int  mostUsedNumberCount() const;
    QItemSelectionModel* selectionModel() const;
 
 private:
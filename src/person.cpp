@@ -22,6 +22,9 @@
 
 //Qt
 #include <QtCore/QDateTime>
+#include <QtCore/QCache>
+#include <QtCore/QMutex>
+#include <QtCore/QSize>
 
 //Ring library
 #include "contactmethod.h"
@@ -38,6 +41,7 @@
 #include "globalinstances.h"
 #include "interfaces/pixmapmanipulatori.h"
 #include "private/person_p.h"
+#include "private/searchindex.h"
 #include "media/textrecording.h"
 #include "mime.h"
 
@@ -124,29 +128,22 @@ void Person::Address::setType(const QString& value)
    d_ptr->type = value;
 }
 
-QString PersonPrivate::filterString()
+QString PersonPrivate::filterString(const Person* p)
 {
-   if (m_CachedFilterString.size())
-      return m_CachedFilterString;
-
    //Also filter by phone numbers, accents are negligible
+   QString raw;
    foreach(const ContactMethod* n , m_Numbers) {
-      m_CachedFilterString += n->uri();
+      raw += n->uri();
    }
 
-   //Strip non essential characters like accents from the filter string
-   foreach(const QChar& char2,(m_FormattedName+'\n'+m_Organization+'\n'+m_Group+'\n'+
-      m_Department+'\n'+m_PreferredEmail).toLower().normalized(QString::NormalizationForm_KD) ) {
-      if (!char2.combiningClass())
-         m_CachedFilterString += char2;
-   }
+   raw += m_FormattedName+'\n'+m_Organization+'\n'+m_Group+'\n'+m_Department+'\n'+m_PreferredEmail;
 
-   return m_CachedFilterString;
+   //The normalization is only done again when the string changes
+   return SearchIndex::instance().update(p, raw);
 }
 
 void PersonPrivate::changed()
 {
-   m_CachedFilterString.clear();
    foreach (Person* c,m_lParents) {
       emit c->changed();
    }
@@ -189,8 +186,75 @@ void PersonPrivate::registerContactMethod(ContactMethod* m)
       slotLastUsedTimeChanged(m->lastUsed());
 }
 
+/**
+ * The decoded photos and the thumbnails are shared by all persons in a LRU
+ * cache. Each change of a photo get a new revision, so stale entries are
+ * never returned even if an other person later use the same uid.
+ */
+struct PhotoCacheKey {
+   QByteArray uid ;
+   QSize      size;
+
+   bool operator==(const PhotoCacheKey& other) const {
+      return uid == other.uid && size == other.size;
+   }
+};
+
+struct PhotoCacheEntry {
+   QVariant photo   ;
+   int      revision;
+};
+
+uint qHash(const PhotoCacheKey& key);
+uint qHash(const PhotoCacheKey& key)
+{
+   return qHash(key.uid) ^ (key.size.width() << 16) ^ key.size.height();
+}
+
+static QMutex                                 photoCacheMutex;
+static QCache<PhotoCacheKey, PhotoCacheEntry> photoCache(PersonPrivate::PHOTO_CACHE_SIZE);
+static QAtomicInt                             photoRevision;
+
+void PersonPrivate::setPhotoRevision()
+{
+   m_PhotoRevision = photoRevision.fetchAndAddRelaxed(1) + 1;
+}
+
+QVariant PersonPrivate::cachedPhoto(const QSize& size)
+{
+   const PhotoCacheKey key {
+      m_Uid.isEmpty() ? QByteArray::number(reinterpret_cast<quintptr>(this)) : m_Uid,
+      size
+   };
+
+   {
+      QMutexLocker locker(&photoCacheMutex);
+      const PhotoCacheEntry* entry = photoCache.object(key);
+
+      if (entry && entry->revision == m_PhotoRevision)
+         return entry->photo;
+   }
+
+   //Decoding can be slow, don't hold the lock
+   const QVariant photo = size.isValid() ?
+      GlobalInstances::pixmapManipulator().contactPhoto(q_ptr, size, false) : (
+         m_vPhoto.isValid() ? m_vPhoto :
+         GlobalInstances::pixmapManipulator().personPhoto(m_PhotoData, m_PhotoType)
+      );
+
+   //A decoded photo use about 10 times its encoded size
+   const int cost = qMax(1, size.isValid() ?
+      size.width() * size.height() * 4 / 1024 : m_PhotoData.size() * 10 / 1024
+   );
+
+   QMutexLocker locker(&photoCacheMutex);
+   photoCache.insert(key, new PhotoCacheEntry { photo, m_PhotoRevision }, cost);
+
+   return photo;
+}
+
 PersonPrivate::PersonPrivate(Person* contact) : QObject(nullptr),
-   m_Numbers(),m_DisplayPhoto(false),m_Active(true),m_isPlaceHolder(false),
+   m_PhotoRevision(0),m_Numbers(),m_DisplayPhoto(false),m_Active(true),m_isPlaceHolder(false),
    m_LastUsed(0),m_LastUsedInit(false), q_ptr(contact)
 {
    moveToThread(QCoreApplication::instance()->thread());
@@ -249,6 +313,9 @@ d_ptr(new PersonPrivate(this))
    d_ptr->m_SecondName           = other.d_ptr->m_SecondName          ;
    d_ptr->m_NickName             = other.d_ptr->m_NickName            ;
    d_ptr->m_vPhoto               = other.d_ptr->m_vPhoto              ;
+   d_ptr->m_PhotoData            = other.d_ptr->m_PhotoData           ;
+   d_ptr->m_PhotoType            = other.d_ptr->m_PhotoType           ;
+   d_ptr->m_PhotoRevision        = other.d_ptr->m_PhotoRevision       ;
    d_ptr->m_FormattedName        = other.d_ptr->m_FormattedName       ;
    d_ptr->m_PreferredEmail       = other.d_ptr->m_PreferredEmail      ;
    d_ptr->m_Organization         = other.d_ptr->m_Organization        ;
@@ -311,10 +378,29 @@ const QString& Person::secondName() const
    return d_ptr->m_SecondName;
 }
 
-///Get the photo
+///Get the photo, photos loaded from a vCard are decoded on demand
 const QVariant Person::photo() const
 {
-   return d_ptr->m_vPhoto;
+   if (d_ptr->m_vPhoto.isValid() || d_ptr->m_PhotoData.isEmpty())
+      return d_ptr->m_vPhoto;
+
+   return d_ptr->cachedPhoto(QSize());
+}
+
+/**
+ * Get the photo scaled by the pixmap manipulator (without the presence
+ * overlay). Thumbnails are kept in the same bounded cache as the decoded
+ * photos.
+ */
+QVariant Person::thumbnail(const QSize& size) const
+{
+   if (!size.isValid())
+      return photo();
+
+   if ((!d_ptr->m_vPhoto.isValid()) && d_ptr->m_PhotoData.isEmpty())
+      return QVariant();
+
+   return d_ptr->cachedPhoto(size);
 }
 
 ///Get the formatted name
@@ -418,6 +504,19 @@ void Person::setFamilyName(const QString& name)
 void Person::setPhoto(const QVariant& photo)
 {
    d_ptr->m_vPhoto = photo;
+   d_ptr->m_PhotoData.clear();
+   d_ptr->m_PhotoType.clear();
+   d_ptr->setPhotoRevision();
+   d_ptr->changed();
+}
+
+///Set the encoded Photo/Avatar, it will only be decoded when used
+void Person::setPhotoData(const QByteArray& data, const QString& type)
+{
+   d_ptr->m_vPhoto    = QVariant();
+   d_ptr->m_PhotoData = data;
+   d_ptr->m_PhotoType = type;
+   d_ptr->setPhotoRevision();
    d_ptr->changed();
 }
 
@@ -573,7 +672,7 @@ bool Person::hasRecording(Media::Media::Type type, Media::Media::Direction direc
 ///Recomputing the filter string is heavy, cache it
 QString Person::filterString() const
 {
-   return d_ptr->filterString();
+   return d_ptr->filterString(this);
 }
 
 ///Get the role value
@@ -615,7 +714,7 @@ QVariant Person::roleData(int role) const
             int unread = 0;
             for (int i = 0; i < d_ptr->m_Numbers.size(); ++i) {
                if (auto rec = d_ptr->m_Numbers.at(i)->textRecording())
-                  unread += rec->unreadInstantTextMessagingModel()->rowCount();
+                  unread += rec->unreadCount();
             }
             return unread;
          }
@@ -32,6 +32,7 @@ class AddressPrivate;
 class Account;
 class CollectionInterface;
 class PersonPlaceHolderPrivate;
+class QSize;
 
 #include "typedefs.h"
 
@@ -138,6 +139,7 @@ public:
    const  QByteArray& uid           () const;
    const  QString& preferredEmail   () const;
    const  QVariant photo            () const;
+   QVariant        thumbnail        ( const QSize& size ) const;
    const  QString& group            () const;
    const  QString& department       () const;
    time_t lastUsedTime              () const;
@@ -170,6 +172,7 @@ public:
    void setDepartment     ( const QString&    name   );
    void setUid            ( const QByteArray& id     );
    void setPhoto          ( const QVariant&   photo  );
+   void setPhotoData      ( const QByteArray& data, const QString& type );
 
    //Updates an existing contact from vCard info
    void updateFromVCard(const QByteArray& content);
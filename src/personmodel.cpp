@@ -67,6 +67,10 @@ public:
    QHash<QByteArray,Person*> m_hPersonsByUid;
    QVector<PersonItemNode*> m_lPersons;
 
+   //Helpers
+   PersonItemNode* createNode     (const Person* c);
+   void            finishInsertion(const Person* c);
+
 private:
    PersonModel* q_ptr;
 //    void slotPersonAdded(Person* c);
@@ -97,6 +101,10 @@ PersonModel::PersonModel(QObject* par) : QAbstractItemModel(par?par:QCoreApplica
 d_ptr(new PersonModelPrivate(this))
 {
    setObjectName("PersonModel");
+
+   setAddItemsCallback([this](const QVector<const Person*>& items) {
+      addItems(items);
+   });
 }
 
 ///Destructor
@@ -269,45 +277,73 @@ void PersonModel::collectionAddedCallback(CollectionInterface* backend)
    Q_UNUSED(backend)
 }
 
-bool PersonModel::addItemCallback(const Person* c)
+///Create the person node and its contact method nodes, without notifications
+PersonItemNode* PersonModelPrivate::createNode(const Person* c)
 {
-   //Add to the model
-   beginInsertRows(QModelIndex(),d_ptr->m_lPersons.size(),d_ptr->m_lPersons.size());
    PersonItemNode* n = new PersonItemNode(const_cast<Person*>(c),PersonItemNode::NodeType::PERSON);
-   n->m_Index = d_ptr->m_lPersons.size();
-   d_ptr->m_lPersons << n;
-   d_ptr->m_hPersonsByUid[c->uid()] = const_cast<Person*>(c);
-   endInsertRows();
-   emit newPersonAdded(c);
+   n->m_Index = m_lPersons.size();
+   m_lPersons << n;
+   m_hPersonsByUid[c->uid()] = const_cast<Person*>(c);
 
-   //Add the contact method nodes
-   const QModelIndex& idx = index(n->m_Index,0);
-   beginInsertRows(idx,0,c->phoneNumbers().size());
    for(ContactMethod* m : c->phoneNumbers() ) {
       PersonItemNode* n2 = new PersonItemNode(m,PersonItemNode::NodeType::NUMBER);
       n2->m_Index = n->m_lChildren.size();
       n2->m_pParent = n; //TODO support adding new contact methods on the fly
       n->m_lChildren << n2;
    }
-   endInsertRows();
+
+   return n;
+}
+
+///Notify and update the placeholders once the node is part of the model
+void PersonModelPrivate::finishInsertion(const Person* c)
+{
+   emit q_ptr->newPersonAdded(c);
 
    //Deprecate the placeholder
-   if (d_ptr->m_hPlaceholders.contains(c->uid())) {
-      PersonPlaceHolder* c2 = d_ptr->m_hPlaceholders[c->uid()];
+   if (m_hPlaceholders.contains(c->uid())) {
+      PersonPlaceHolder* c2 = m_hPlaceholders[c->uid()];
       if (c2) {
          c2->merge(const_cast<Person*>(c));
-         d_ptr->m_hPlaceholders[c->uid()] = nullptr;
+         m_hPlaceholders[c->uid()] = nullptr;
       }
    }
 
-   connect(c, &Person::lastUsedTimeChanged, d_ptr.data(), &PersonModelPrivate::slotLastUsedTimeChanged);
+   connect(c, &Person::lastUsedTimeChanged, this, &PersonModelPrivate::slotLastUsedTimeChanged);
 
    if (c->lastUsedTime())
-      emit lastUsedTimeChanged(const_cast<Person*>(c), c->lastUsedTime());
+      emit q_ptr->lastUsedTimeChanged(const_cast<Person*>(c), c->lastUsedTime());
+}
+
+bool PersonModel::addItemCallback(const Person* c)
+{
+   //Add to the model, the contact method rows are part of the same insertion
+   beginInsertRows(QModelIndex(),d_ptr->m_lPersons.size(),d_ptr->m_lPersons.size());
+   d_ptr->createNode(c);
+   endInsertRows();
+
+   d_ptr->finishInsertion(c);
 
    return true;
 }
 
+///Insert the persons loaded in the background in a single transaction
+void PersonModel::addItems(const QVector<const Person*>& items)
+{
+   if (items.isEmpty())
+      return;
+
+   const int first = d_ptr->m_lPersons.size();
+
+   beginInsertRows(QModelIndex(), first, first + items.size() - 1);
+   for (const Person* c : items)
+      d_ptr->createNode(c);
+   endInsertRows();
+
+   for (const Person* c : items)
+      d_ptr->finishInsertion(c);
+}
+
 bool PersonModel::removeItemCallback(const Person* item)
 {
    if (item)
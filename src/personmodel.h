@@ -82,6 +82,7 @@ private:
    virtual void collectionAddedCallback(CollectionInterface* backend) override;
    virtual bool addItemCallback(const Person* item) override;
    virtual bool removeItemCallback(const Person* item) override;
+   void addItems(const QVector<const Person*>& items);
 
 public Q_SLOTS:
    bool addNewPerson(Person* c, CollectionInterface* backend = nullptr);
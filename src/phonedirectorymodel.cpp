@@ -19,6 +19,10 @@
 
 //Qt
 #include <QtCore/QCoreApplication>
+#include <QtCore/QThread>
+#include <QtCore/QThreadStorage>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QTimer>
 
 //DRing
 #include <account_const.h>
@@ -42,10 +46,16 @@
 
 //Private
 #include "private/phonedirectorymodel_p.h"
+#include "private/contactmethod_p.h"
+#include "private/accountmodel_p.h"
 
 PhoneDirectoryModelPrivate::PhoneDirectoryModelPrivate(PhoneDirectoryModel* parent) : QObject(parent), q_ptr(parent),
-m_CallWithAccount(false),m_pPopularModel(nullptr)
+m_IndexRevision(0),m_VisibleCount(0),m_CallWithAccount(false),m_pPopularModel(nullptr),
+m_pRolloverTimer(new QTimer(this))
 {
+   m_pRolloverTimer->setSingleShot(true);
+   connect(m_pRolloverTimer, &QTimer::timeout, this, &PhoneDirectoryModelPrivate::slotRollover);
+   scheduleRollover();
 }
 
 PhoneDirectoryModel::PhoneDirectoryModel(QObject* parent) :
@@ -71,7 +81,7 @@ PhoneDirectoryModel::~PhoneDirectoryModel()
    }
 
    //Used by auto completion
-   vals = d_ptr->m_hSortedNumbers.values();
+   vals = d_ptr->m_hDirectory.values();
    d_ptr->m_hSortedNumbers.clear();
    d_ptr->m_hDirectory.clear();
    while (vals.size()) {
@@ -100,7 +110,7 @@ QHash<int,QByteArray> PhoneDirectoryModel::roleNames() const
 
 QVariant PhoneDirectoryModel::data(const QModelIndex& index, int role ) const
 {
-   if (!index.isValid() || index.row() >= d_ptr->m_lNumbers.size()) return QVariant();
+   if (!index.isValid() || index.row() >= d_ptr->m_VisibleCount) return QVariant();
    const ContactMethod* number = d_ptr->m_lNumbers[index.row()];
    switch (static_cast<PhoneDirectoryModelPrivate::Columns>(index.column())) {
       case PhoneDirectoryModelPrivate::Columns::URI:
@@ -253,7 +263,7 @@ int PhoneDirectoryModel::rowCount(const QModelIndex& parent ) const
 {
    if (parent.isValid())
       return 0;
-   return d_ptr->m_lNumbers.size();
+   return d_ptr->m_VisibleCount;
 }
 
 int PhoneDirectoryModel::columnCount(const QModelIndex& parent ) const
@@ -318,7 +328,8 @@ void PhoneDirectoryModelPrivate::setAccount(ContactMethod* number, Account* acco
          const QString extendedUri = strippedUri+'@'+account->hostname();
          wrap = new NumberWrapper();
          m_hDirectory    [extendedUri] = wrap;
-         m_hSortedNumbers[extendedUri] = wrap;
+         m_hSortedNumbers.insert(PrefixIndex::fold(extendedUri), wrap);
+         m_IndexRevision++;
 
       }
       else {
@@ -434,20 +445,13 @@ ContactMethod* PhoneDirectoryModel::getNumber(const QString& uri, const QString&
 
    //Too bad, lets create one
    ContactMethod* number = new ContactMethod(strippedUri,NumberCategoryModel::instance().getCategory(type));
-   number->setIndex(d_ptr->m_lNumbers.size());
-   d_ptr->m_lNumbers << number;
-   connect(number,SIGNAL(callAdded(Call*)),d_ptr.data(),SLOT(slotCallAdded(Call*)));
-   connect(number,SIGNAL(changed()),d_ptr.data(),SLOT(slotChanged()));
-   connect(number,&ContactMethod::lastUsedChanged,d_ptr.data(), &PhoneDirectoryModelPrivate::slotLastUsedChanged);
-   connect(number,&ContactMethod::contactChanged ,d_ptr.data(), &PhoneDirectoryModelPrivate::slotContactChanged);
-
-   const QString hn = number->uri().hostname();
+   d_ptr->registerNumber(number);
 
-   emit layoutChanged();
    if (!wrap) {
       wrap = new NumberWrapper();
       d_ptr->m_hDirectory[strippedUri] = wrap;
-      d_ptr->m_hSortedNumbers[strippedUri] = wrap;
+      d_ptr->m_hSortedNumbers.insert(PrefixIndex::fold(strippedUri), wrap);
+      d_ptr->m_IndexRevision++;
    }
    wrap->numbers << number;
    return number;
@@ -543,18 +547,14 @@ ContactMethod* PhoneDirectoryModel::getNumber(const QString& uri, Person* contac
    //Create the number
    ContactMethod* number = new ContactMethod(strippedUri,NumberCategoryModel::instance().getCategory(type));
    number->setAccount(account);
-   number->setIndex( d_ptr->m_lNumbers.size());
    if (contact)
       number->setPerson(contact);
-   d_ptr->m_lNumbers << number;
-   connect(number,SIGNAL(callAdded(Call*)),d_ptr.data(),SLOT(slotCallAdded(Call*)));
-   connect(number,SIGNAL(changed()),d_ptr.data(),SLOT(slotChanged()));
-   connect(number,&ContactMethod::lastUsedChanged,d_ptr.data(), &PhoneDirectoryModelPrivate::slotLastUsedChanged);
-   connect(number,&ContactMethod::contactChanged ,d_ptr.data(), &PhoneDirectoryModelPrivate::slotContactChanged );
+   d_ptr->registerNumber(number);
    if (!wrap) {
       wrap = new NumberWrapper();
       d_ptr->m_hDirectory    [strippedUri] = wrap;
-      d_ptr->m_hSortedNumbers[strippedUri] = wrap;
+      d_ptr->m_hSortedNumbers.insert(PrefixIndex::fold(strippedUri), wrap);
+      d_ptr->m_IndexRevision++;
 
       //Also add its alternative URI, it should be safe to do
       if ( !hasAtSign && account && !account->hostname().isEmpty() ) {
@@ -563,18 +563,155 @@ ContactMethod* PhoneDirectoryModel::getNumber(const QString& uri, Person* contac
          if ((!wrap2) && (!d_ptr->m_hDirectory[extendedUri])) {
             wrap2 = new NumberWrapper();
             d_ptr->m_hDirectory    [extendedUri] = wrap2;
-            d_ptr->m_hSortedNumbers[extendedUri] = wrap2;
+            d_ptr->m_hSortedNumbers.insert(PrefixIndex::fold(extendedUri), wrap2);
+            d_ptr->m_IndexRevision++;
          }
          wrap2->numbers << number;
       }
 
    }
    wrap->numbers << number;
-   emit layoutChanged();
 
    return number;
 }
 
+///Append a new number to the model, the insertion is deferred in bulk mode
+void PhoneDirectoryModelPrivate::registerNumber(ContactMethod* number)
+{
+   connect(number, &ContactMethod::callAdded      , this, &PhoneDirectoryModelPrivate::slotCallAdded      );
+   connect(number, &ContactMethod::changed        , this, &PhoneDirectoryModelPrivate::slotChanged        );
+   connect(number, &ContactMethod::lastUsedChanged, this, &PhoneDirectoryModelPrivate::slotLastUsedChanged);
+   connect(number, &ContactMethod::contactChanged , this, &PhoneDirectoryModelPrivate::slotContactChanged );
+   connect(number, &QObject::destroyed, this, [this, number]() {
+      m_lPopularityIndex.remove(number);
+   });
+
+   //Created by a collection being loaded by this thread, wait for the end
+   if (BulkInsertion* bulk = currentBulkInsertion().localData()) {
+      bulk->m_lNumbers << number;
+      return;
+   }
+
+   //Collections loaded in a thread, m_lNumbers is only touched by the model
+   //thread as the views read it, queue the number until it get there
+   if (QThread::currentThread() != thread()) {
+      QMutexLocker locker(&m_PendingMutex);
+      m_lPendingNumbers << number;
+
+      if (m_lPendingNumbers.size() == 1)
+         QMetaObject::invokeMethod(this, "slotCommitInsertion", Qt::QueuedConnection);
+
+      return;
+   }
+
+   number->setIndex(m_lNumbers.size());
+   m_lNumbers << number;
+
+   //Also flush the rows left pending by a bulk insertion
+   slotCommitInsertion();
+}
+
+///The outermost bulk insertion of the current thread, if any
+QThreadStorage<PhoneDirectoryModelPrivate::BulkInsertion*>& PhoneDirectoryModelPrivate::currentBulkInsertion()
+{
+   static QThreadStorage<BulkInsertion*> current;
+   return current;
+}
+
+///Publish the numbers deferred by a bulk insertion, from any thread
+void PhoneDirectoryModelPrivate::commitBulkInsertion(const QVector<ContactMethod*>& numbers)
+{
+   PhoneDirectoryModelPrivate* d = PhoneDirectoryModel::instance().d_ptr.data();
+
+   {
+      QMutexLocker locker(&d->m_PendingMutex);
+      d->m_lPendingNumbers << numbers;
+   }
+
+   if (QThread::currentThread() == d->thread())
+      d->slotCommitInsertion();
+   else
+      QMetaObject::invokeMethod(d, "slotCommitInsertion", Qt::QueuedConnection);
+}
+
+///Fire just after the next (UTC) day boundary
+void PhoneDirectoryModelPrivate::scheduleRollover()
+{
+   const qint64 next = (UsageStatistics::today() + 1) * UsageStatistics::DAY_SECONDS;
+   m_pRolloverTimer->start(static_cast<int>(next - ::time(nullptr)) * 1000 + 1000);
+}
+
+/**
+ * Move the usage statistics windows to the new day. Only the numbers with
+ * calls in the last trimester can change, they are notified in a single
+ * range covering the first and last affected rows. The accounts have their
+ * own statistics, AccountModel does the same for them.
+ */
+void PhoneDirectoryModelPrivate::slotRollover()
+{
+   int first = -1, last = -1;
+
+   for (int i = 0; i < m_VisibleCount; i++) {
+      if (m_lNumbers[i]->d_ptr->m_Usage.rollover()) {
+         if (first == -1)
+            first = i;
+         last = i;
+      }
+   }
+
+   if (first != -1)
+      emit q_ptr->dataChanged(
+         q_ptr->index(first, static_cast<int>(Columns::WEEK_COUNT)),
+         q_ptr->index(last , static_cast<int>(Columns::TRIM_COUNT))
+      );
+
+   AccountModel::instance().d_ptr->rolloverUsage();
+
+   scheduleRollover();
+}
+
+///Notify the views about all the numbers added since the last insertion
+void PhoneDirectoryModelPrivate::slotCommitInsertion()
+{
+   {
+      QMutexLocker locker(&m_PendingMutex);
+
+      for (ContactMethod* number : m_lPendingNumbers) {
+         number->setIndex(m_lNumbers.size());
+         m_lNumbers << number;
+      }
+
+      m_lPendingNumbers.clear();
+   }
+
+   if (m_VisibleCount == m_lNumbers.size())
+      return;
+
+   q_ptr->beginInsertRows(QModelIndex(), m_VisibleCount, m_lNumbers.size()-1);
+   m_VisibleCount = m_lNumbers.size();
+   q_ptr->endInsertRows();
+}
+
+PhoneDirectoryModelPrivate::BulkInsertion::BulkInsertion() :
+   m_IsOutermost(!currentBulkInsertion().localData())
+{
+   //The nested guards defer into the outermost one
+   if (m_IsOutermost)
+      currentBulkInsertion().setLocalData(this);
+}
+
+PhoneDirectoryModelPrivate::BulkInsertion::~BulkInsertion()
+{
+   if (!m_IsOutermost)
+      return;
+
+   //Never let QThreadStorage delete the guard when the thread exits
+   currentBulkInsertion().setLocalData(nullptr);
+
+   if (!m_lNumbers.isEmpty())
+      commitBulkInsertion(m_lNumbers);
+}
+
 ContactMethod* PhoneDirectoryModel::fromTemporary(const TemporaryContactMethod* number)
 {
    return getNumber(number->uri(),number->contact(),number->account());
@@ -600,7 +737,36 @@ ContactMethod* PhoneDirectoryModel::fromHash(const QString& hash)
 
 QVector<ContactMethod*> PhoneDirectoryModel::getNumbersByPopularity() const
 {
-   return d_ptr->m_lPopularityIndex;
+   return d_ptr->m_lPopularityIndex.topK(d_ptr->m_lPopularityIndex.capacity());
+}
+
+///Return the "count" most popular numbers, at most mostPopularCount()
+QVector<ContactMethod*> PhoneDirectoryModel::getNumbersByPopularity(int count) const
+{
+   return d_ptr->m_lPopularityIndex.topK(count);
+}
+
+int PhoneDirectoryModel::mostPopularCount() const
+{
+   return d_ptr->m_lPopularityIndex.capacity();
+}
+
+///Set how many numbers are tracked by the most popular number model
+void PhoneDirectoryModel::setMostPopularCount(int count)
+{
+   d_ptr->m_lPopularityIndex.setCapacity(count);
+}
+
+/**
+ * Replace how the numbers are ranked by popularity, the call count by
+ * default. Every number is ranked again.
+ *
+ * @note The numbers are ranked again when one of them has a new call, a score
+ *  depending on something else has to be set again when it changes.
+ */
+void PhoneDirectoryModel::setPopularityScore(const std::function<qreal(const ContactMethod*)>& score)
+{
+   d_ptr->m_lPopularityIndex.setScore(score);
 }
 
 void PhoneDirectoryModelPrivate::slotCallAdded(Call* call)
@@ -608,41 +774,7 @@ void PhoneDirectoryModelPrivate::slotCallAdded(Call* call)
    Q_UNUSED(call)
    ContactMethod* number = qobject_cast<ContactMethod*>(sender());
    if (number) {
-      int currentIndex = number->popularityIndex();
-
-      //The number is already in the top 10 and just passed the "index-1" one
-      if (currentIndex > 0 && m_lPopularityIndex[currentIndex-1]->callCount() < number->callCount()) {
-         do {
-            ContactMethod* tmp = m_lPopularityIndex[currentIndex-1];
-            m_lPopularityIndex[currentIndex-1] = number;
-            m_lPopularityIndex[currentIndex  ] = tmp   ;
-            tmp->setPopularityIndex(tmp->popularityIndex()+1);
-            currentIndex--;
-         } while (currentIndex && m_lPopularityIndex[currentIndex-1]->callCount() < number->callCount());
-         number->setPopularityIndex(currentIndex);
-         emit q_ptr->layoutChanged();
-         if (m_pPopularModel)
-            m_pPopularModel->reload();
-      }
-      //The top 10 is not complete, a call count of "1" is enough to make it
-      else if (m_lPopularityIndex.size() < 10 && currentIndex == -1) {
-         m_lPopularityIndex << number;
-         if (m_pPopularModel)
-            m_pPopularModel->addRow();
-         number->setPopularityIndex(m_lPopularityIndex.size()-1);
-         emit q_ptr->layoutChanged();
-      }
-      //The top 10 is full, but this number just made it to the top 10
-      else if (currentIndex == -1 && m_lPopularityIndex.size() >= 10 && m_lPopularityIndex[9] != number && m_lPopularityIndex[9]->callCount() < number->callCount()) {
-         ContactMethod* tmp = m_lPopularityIndex[9];
-         tmp->setPopularityIndex(-1);
-         m_lPopularityIndex[9]     = number;
-         number->setPopularityIndex(9);
-         emit tmp->changed();
-         emit number->changed();
-         if (m_pPopularModel)
-            m_pPopularModel->reload();
-      }
+      m_lPopularityIndex.update(number);
 
       //Now check for new peer names
       if (!call->peerName().isEmpty()) {
@@ -660,6 +792,10 @@ void PhoneDirectoryModelPrivate::slotChanged()
       if (idx<0)
          qDebug() << "Invalid slotChanged() index!" << idx;
 #endif
+      //Not yet visible, the pending insertion will cover it
+      if (idx < 0 || idx >= m_VisibleCount)
+         return;
+
       emit q_ptr->dataChanged(q_ptr->index(idx,0),q_ptr->index(idx,static_cast<int>(Columns::UID)));
    }
 }
@@ -708,7 +844,8 @@ void PhoneDirectoryModelPrivate::indexNumber(ContactMethod* number, const QStrin
             if (!wrap) {
                wrap = new NumberWrapper();
                m_hNumbersByNames[chunk] = wrap;
-               m_lSortedNames[chunk]    = wrap;
+               m_lSortedNames.insert(PrefixIndex::fold(chunk), wrap);
+               m_IndexRevision++;
             }
             const int numCount = wrap->numbers.size();
             if (!((numCount == 1 && wrap->numbers[0] == number) || (numCount > 1 && wrap->numbers.indexOf(number) != -1)))
@@ -719,7 +856,8 @@ void PhoneDirectoryModelPrivate::indexNumber(ContactMethod* number, const QStrin
       if (!wrap) {
          wrap = new NumberWrapper();
          m_hNumbersByNames[lower] = wrap;
-         m_lSortedNames[lower]    = wrap;
+         m_lSortedNames.insert(PrefixIndex::fold(lower), wrap);
+         m_IndexRevision++;
       }
       const int numCount = wrap->numbers.size();
       if (!((numCount == 1 && wrap->numbers[0] == number) || (numCount > 1 && wrap->numbers.indexOf(number) != -1)))
@@ -750,7 +888,7 @@ QVariant MostPopularNumberModel::data( const QModelIndex& index, int role ) cons
    if (!index.isValid())
       return QVariant();
 
-   return PhoneDirectoryModel::instance().d_ptr->m_lPopularityIndex[index.row()]->roleData(
+   return PhoneDirectoryModel::instance().d_ptr->m_lPopularityIndex.at(index.row())->roleData(
       role == Qt::DisplayRole ? (int)Call::Role::Name : role
    );
 }
@@ -773,22 +911,52 @@ bool MostPopularNumberModel::setData( const QModelIndex& index, const QVariant &
    return false;
 }
 
-void MostPopularNumberModel::addRow()
+void MostPopularNumberModel::beginInsert(int row)
+{
+   beginInsertRows(QModelIndex(), row, row);
+}
+
+void MostPopularNumberModel::endInsert()
 {
-   const int oldSize = PhoneDirectoryModel::instance().d_ptr->m_lPopularityIndex.size()-1;
-   beginInsertRows(QModelIndex(),oldSize,oldSize);
    endInsertRows();
 }
 
-void MostPopularNumberModel::reload()
+void MostPopularNumberModel::beginRemove(int row)
+{
+   beginRemoveRows(QModelIndex(), row, row);
+}
+
+void MostPopularNumberModel::endRemove()
+{
+   endRemoveRows();
+}
+
+void MostPopularNumberModel::beginMove(int row, int dest)
+{
+   beginMoveRows(QModelIndex(), row, row, QModelIndex(), dest);
+}
+
+void MostPopularNumberModel::endMove()
 {
-   emit dataChanged(index(0,0),index(rowCount(),0));
+   endMoveRows();
+}
+
+void MostPopularNumberModel::beginReset()
+{
+   beginResetModel();
+}
+
+void MostPopularNumberModel::endReset()
+{
+   endResetModel();
 }
 
 QAbstractListModel* PhoneDirectoryModel::mostPopularNumberModel() const
 {
-   if (!d_ptr->m_pPopularModel)
+   if (!d_ptr->m_pPopularModel) {
       d_ptr->m_pPopularModel = new MostPopularNumberModel();
+      d_ptr->m_lPopularityIndex.setModel(d_ptr->m_pPopularModel);
+   }
 
    return d_ptr->m_pPopularModel;
 }
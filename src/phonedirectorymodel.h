@@ -23,6 +23,9 @@
 #include <QtCore/QString>
 #include <QtCore/QAbstractTableModel>
 
+//Std
+#include <functional>
+
 //Ring
 #include "uri.h"
 class ContactMethod         ;
@@ -50,6 +53,9 @@ class LIB_EXPORT PhoneDirectoryModel : public QAbstractTableModel {
    //Phone number need to update the indexes as they change
    friend class ContactMethod;
 
+   //The bulk insertion guards commit to the singleton
+   friend class PhoneDirectoryModelPrivate;
+
    #pragma GCC diagnostic push
    #pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
    Q_OBJECT
@@ -86,12 +92,16 @@ public:
    int count() const;
    bool callWithAccount() const;
    QAbstractListModel* mostPopularNumberModel() const;
+   int mostPopularCount() const;
 
    //Setters
    void setCallWithAccount(bool value);
+   void setMostPopularCount(int count);
+   void setPopularityScore(const std::function<qreal(const ContactMethod*)>& score);
 
    //Static
    QVector<ContactMethod*> getNumbersByPopularity() const;
+   QVector<ContactMethod*> getNumbersByPopularity(int count) const;
 
 private:
    //Constructor
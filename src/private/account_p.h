@@ -24,6 +24,7 @@
 //Ring
 #include <account.h>
 #include <private/matrixutils.h>
+#include <private/usagestatistics.h>
 
 class AccountPrivate;
 class ContactMethod;
@@ -85,11 +86,10 @@ public:
    uint                       m_InternalId               ;
 
    //Statistic
-   bool   m_HaveCalled    ;
-   uint   m_TotalCount    ;
-   uint   m_LastWeekCount ;
-   uint   m_LastTrimCount ;
-   time_t m_LastUsed      ;
+   bool            m_HaveCalled;
+   uint            m_TotalCount;
+   UsageStatistics m_Usage     ;
+   time_t          m_LastUsed  ;
 
    //Setters
    void setAccountProperties(const QHash<QString,QString>& m          );
@@ -46,6 +46,7 @@ public:
    void enableProtocol(Account::Protocol proto);
    AccountModel::EditState convertAccountEditState(const Account::EditState s);
    void insertAccount(Account* a, int idx);
+   void rolloverUsage();
 
    //Attributes
    AccountModel*                     q_ptr                ;
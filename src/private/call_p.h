@@ -234,6 +234,7 @@ public:
    void removeRenderer(Video::Renderer* renderer);
    void setRecordingPath(const QString& path);
    static MapStringString getCallDetailsCommon(const QString& callId);
+   void applyDetails(const MapStringString& details);
    void peerHoldChanged(bool onPeerHold);
    template<typename T>
    T* mediaFactory(Media::Media::Direction dir);
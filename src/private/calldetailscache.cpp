@@ -0,0 +1,280 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "calldetailscache.h"
+
+//Qt
+#include <QtCore/QCoreApplication>
+
+//LibStdC++
+#include <memory>
+#ifndef ENABLE_LIBWRAP
+ #include <QtDBus/QDBusPendingCallWatcher>
+#endif
+
+//DRing
+#include <call_const.h>
+
+//Ring
+#include "dbus/callmanager.h"
+#include "account.h"
+#include "accountmodel.h"
+#include "callmodel.h"
+#include "call.h"
+#include "uri.h"
+#include "private/call_p.h"
+
+CallDetailsCache::CallDetailsCache() : QObject(QCoreApplication::instance()),
+m_FlushQueued(false)
+{
+   CallManagerInterface& callManager = CallManager::instance();
+
+   connect(&callManager, SIGNAL(callStateChanged(QString,QString,int)), this, SLOT(slotCallStateChanged(QString,QString,int)));
+   connect(&callManager, SIGNAL(conferenceCreated(QString))           , this, SLOT(slotConferenceChanged())                   );
+   connect(&callManager, SIGNAL(conferenceChanged(QString,QString))   , this, SLOT(slotConferenceChanged())                   );
+   connect(&callManager, SIGNAL(conferenceRemoved(QString))           , this, SLOT(slotConferenceChanged())                   );
+   connect(&callManager, SIGNAL(transferSucceeded())                  , this, SLOT(slotConferenceChanged())                   );
+   connect(&callManager, SIGNAL(transferFailed())                     , this, SLOT(slotConferenceChanged())                   );
+   connect(&callManager, SIGNAL(recordingStateChanged(QString,bool))  , this, SLOT(slotCallChanged(QString))                  );
+   connect(&callManager, SIGNAL(audioMuted(QString,bool))             , this, SLOT(slotCallChanged(QString))                  );
+   connect(&callManager, SIGNAL(videoMuted(QString,bool))             , this, SLOT(slotCallChanged(QString))                  );
+   connect(&callManager, SIGNAL(peerHold(QString,bool))               , this, SLOT(slotCallChanged(QString))                  );
+   connect(&callManager, SIGNAL(secureSdesOn(QString))                , this, SLOT(slotCallChanged(QString))                  );
+   connect(&callManager, SIGNAL(secureSdesOff(QString))               , this, SLOT(slotCallChanged(QString))                  );
+   connect(&callManager, SIGNAL(secureZrtpOn(QString,QString))        , this, SLOT(slotCallChanged(QString))                  );
+   connect(&callManager, SIGNAL(secureZrtpOff(QString))               , this, SLOT(slotCallChanged(QString))                  );
+
+   m_Clock.start();
+}
+
+CallDetailsCache& CallDetailsCache::instance()
+{
+   static auto cache = new CallDetailsCache();
+   return *cache;
+}
+
+///Only keep the useful part of the peer URI
+MapStringString CallDetailsCache::normalize(MapStringString details)
+{
+   const QString account = details[ DRing::Call::Details::ACCOUNTID ];
+
+   if (account.isEmpty())
+      return details;
+
+   Account* acc = AccountModel::instance().getById(account.toLatin1());
+
+   if (acc && acc->protocol() == Account::Protocol::RING)
+      details[DRing::Call::Details::PEER_NUMBER] = URI(details[DRing::Call::Details::PEER_NUMBER]).format(
+         URI::Section::SCHEME    |
+         URI::Section::USER_INFO
+      );
+   else
+      details[DRing::Call::Details::PEER_NUMBER] = URI(details[DRing::Call::Details::PEER_NUMBER]).format(
+         URI::Section::SCHEME    |
+         URI::Section::USER_INFO |
+         URI::Section::HOSTNAME
+      );
+
+   return details;
+}
+
+///Calls already destroyed by the daemon return empty details, don't keep them
+void CallDetailsCache::store(const QString& callId, const MapStringString& details)
+{
+   if (!details[ DRing::Call::Details::ACCOUNTID ].isEmpty())
+      m_hDetails[callId] = Entry { details, m_Clock.elapsed() };
+}
+
+///The cached details, nullptr if they are missing or expired
+const MapStringString* CallDetailsCache::cached(const QString& callId) const
+{
+   const auto entry = m_hDetails.constFind(callId);
+
+   if (entry == m_hDetails.constEnd() || m_Clock.elapsed() - entry->time > ENTRY_TTL_MS)
+      return nullptr;
+
+   return &entry->details;
+}
+
+///Return the cached details or fetch them synchronously
+MapStringString CallDetailsCache::details(const QString& callId)
+{
+   if (const MapStringString* c = cached(callId))
+      return *c;
+
+   const MapStringString details = normalize(CallManager::instance().getCallDetails(callId));
+
+   store(callId, details);
+
+   return details;
+}
+
+/**
+ * Call `callback` with the details of all `callIds` once they are available.
+ * The missing entries are requested together. With DBus, it never blocks,
+ * `callback` is called from the event loop once the last reply arrive.
+ * Otherwise (or if everything is cached) it is called before returning.
+ */
+void CallDetailsCache::details(const QStringList& callIds, const Callback& callback)
+{
+#ifndef ENABLE_LIBWRAP
+   auto ret       = std::make_shared< QHash<QString,MapStringString> >();
+   auto remaining = std::make_shared<int>(0);
+
+   ret->reserve(callIds.size());
+
+   for (const QString& callId : callIds) {
+      if (const MapStringString* c = cached(callId)) {
+         (*ret)[callId] = *c;
+         continue;
+      }
+
+      (*remaining)++;
+
+      const uint generation = m_hGeneration[callId];
+
+      auto watcher = new QDBusPendingCallWatcher(CallManager::instance().getCallDetails(callId), this);
+
+      connect(watcher, &QDBusPendingCallWatcher::finished, [this, callId, generation, ret, remaining, callback](QDBusPendingCallWatcher* w) {
+         w->deleteLater();
+
+         const QDBusPendingReply<MapStringString> reply = *w;
+
+         const MapStringString details = normalize(reply.isError() ? MapStringString() : reply.value());
+
+         //Don't cache a reply older than the last invalidation
+         if (m_hGeneration.value(callId, generation + 1) == generation)
+            store(callId, details);
+
+         (*ret)[callId] = details;
+
+         if (!--(*remaining))
+            callback(*ret);
+      });
+   }
+
+   if (!*remaining)
+      callback(*ret);
+#else
+   QHash<QString,MapStringString> ret;
+   ret.reserve(callIds.size());
+
+   for (const QString& callId : callIds)
+      ret[callId] = details(callId);
+
+   callback(ret);
+#endif
+}
+
+void CallDetailsCache::invalidate(const QString& callId)
+{
+   m_hDetails.remove(callId);
+   m_hGeneration[callId]++;
+}
+
+void CallDetailsCache::clear()
+{
+   m_hDetails.clear();
+
+   for (auto it = m_hGeneration.begin(); it != m_hGeneration.end(); ++it)
+      (*it)++;
+}
+
+/**
+ * Drop the cached entry and schedule a new fetch. All refresh requested
+ * during the same event loop iteration are sent together.
+ */
+void CallDetailsCache::refresh(const QString& callId)
+{
+   invalidate(callId);
+   m_lPending << callId;
+
+   if (!m_FlushQueued) {
+      m_FlushQueued = true;
+      QMetaObject::invokeMethod(this, "slotFlush", Qt::QueuedConnection);
+   }
+}
+
+void CallDetailsCache::slotFlush()
+{
+   m_FlushQueued = false;
+
+   const QSet<QString> pending = m_lPending;
+   m_lPending.clear();
+
+   for (const QString& callId : pending) {
+      //It may have been fetched synchronously in the meantime
+      if (const MapStringString* c = cached(callId)) {
+         if (Call* call = CallModel::instance().getCall(callId))
+            call->d_ptr->applyDetails(*c);
+         continue;
+      }
+
+#ifndef ENABLE_LIBWRAP
+      const uint generation = m_hGeneration[callId];
+
+      auto watcher = new QDBusPendingCallWatcher(CallManager::instance().getCallDetails(callId), this);
+
+      connect(watcher, &QDBusPendingCallWatcher::finished, [this, callId, generation](QDBusPendingCallWatcher* w) {
+         w->deleteLater();
+
+         const QDBusPendingReply<MapStringString> reply = *w;
+
+         //The call changed again since the request, a newer one will follow
+         if (reply.isError() || m_hGeneration.value(callId, generation + 1) != generation)
+            return;
+
+         const MapStringString details = normalize(reply.value());
+         store(callId, details);
+
+         if (Call* call = CallModel::instance().getCall(callId))
+            call->d_ptr->applyDetails(details);
+      });
+#else
+      const MapStringString details = normalize(CallManager::instance().getCallDetails(callId));
+      store(callId, details);
+
+      if (Call* call = CallModel::instance().getCall(callId))
+         call->d_ptr->applyDetails(details);
+#endif
+   }
+}
+
+void CallDetailsCache::slotCallStateChanged(const QString& callId, const QString& state, int code)
+{
+   Q_UNUSED(code)
+
+   invalidate(callId);
+
+   if (state == CallPrivate::StateChange::OVER) {
+      m_hGeneration.remove(callId);
+      m_lPending.remove(callId);
+   }
+}
+
+///The CONF_ID of every participants may have changed, the transfer signals
+///don't tell which calls they affect either
+void CallDetailsCache::slotConferenceChanged()
+{
+   clear();
+}
+
+///A signal changed the details of a single call
+void CallDetailsCache::slotCallChanged(const QString& callId)
+{
+   invalidate(callId);
+}
@@ -0,0 +1,89 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QObject>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QElapsedTimer>
+
+//LibStdC++
+#include <functional>
+
+//Ring
+#include <typedefs.h>
+
+/**
+ * Per call cache of the daemon getCallDetails() replies.
+ *
+ * The entries are invalidated by the CallManager signals changing the
+ * details (state, conference, recording, mute, hold, security and transfer).
+ * Other changes, such as the peer name or the codecs, are not signaled, so
+ * the entries also expire after ENTRY_TTL_MS.
+ *
+ * Refresh requests are coalesced and sent once per event loop iteration.
+ * With DBus, the missing details are fetched asynchronously and applied to
+ * the Call when the reply arrive.
+ *
+ * The PEER_NUMBER is stored already normalized (see normalize()).
+ */
+class CallDetailsCache final : public QObject
+{
+   Q_OBJECT
+public:
+   static CallDetailsCache& instance();
+
+   typedef std::function<void(const QHash<QString,MapStringString>&)> Callback;
+
+   MapStringString                details   (const QString&     callId );
+   void                           details   (const QStringList& callIds, const Callback& callback);
+   void                           invalidate(const QString&     callId );
+   void                           refresh   (const QString&     callId );
+   void                           clear     ();
+
+private:
+   explicit CallDetailsCache();
+
+   ///A cached reply and when it was received
+   struct Entry {
+      MapStringString details;
+      qint64          time   ;
+   };
+
+   //Constants
+   constexpr static const int ENTRY_TTL_MS = 2000;
+
+   //Helpers
+   static MapStringString normalize(MapStringString details);
+   void store(const QString& callId, const MapStringString& details);
+   const MapStringString* cached(const QString& callId) const;
+
+   //Attributes
+   QHash<QString,Entry>           m_hDetails   ;
+   QElapsedTimer                  m_Clock      ;
+   QHash<QString,uint>            m_hGeneration;
+   QSet<QString>                  m_lPending   ;
+   bool                           m_FlushQueued;
+
+private Q_SLOTS:
+   void slotFlush();
+   void slotCallStateChanged(const QString& callId, const QString& state, int code);
+   void slotConferenceChanged();
+   void slotCallChanged(const QString& callId);
+};
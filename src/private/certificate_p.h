@@ -57,6 +57,14 @@ public:
 
 };
 
+///The disk cache key of a certificate and what it was computed from
+struct ValidationKey {
+   QByteArray hash      ;
+   QString    path      ;
+   QString    privateKey;
+   QByteArray stamp     ; ///< Modification times and permissions
+};
+
 class ChecksCache {
 public:
    ChecksCache(const MapStringString& checks);
@@ -124,9 +132,14 @@ public:
    mutable DetailsCache* m_pDetailsCache;
    mutable ChecksCache*  m_pCheckCache  ;
 
+   ///Computed once in the background by CertificateValidator
+   ValidationKey m_ValidationKey;
+
    //Helpers
    void loadDetails(bool reload = false);
    void loadChecks (bool loadChecks = false);
+   void setDetails (const MapStringString& details);
+   void setChecks  (const MapStringString& checks );
 
    static Matrix1D<Certificate::Checks ,QString> m_slChecksName;
    static Matrix1D<Certificate::Checks ,QString> m_slChecksDescription;
@@ -0,0 +1,503 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "certificatevalidator.h"
+
+//Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QEvent>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QPointer>
+#include <QtCore/QRunnable>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QTimer>
+#ifndef ENABLE_LIBWRAP
+ #include <QtDBus/QDBusPendingCallWatcher>
+#endif
+
+//Ring daemon
+#include <security_const.h>
+
+//Ring
+#include "dbus/configurationmanager.h"
+#include "certificate.h"
+#include "private/certificate_p.h"
+
+static const QEvent::Type REQUEST_EVENT = static_cast<QEvent::Type>(QEvent::registerEventType());
+static const QEvent::Type KEY_EVENT     = static_cast<QEvent::Type>(QEvent::registerEventType());
+static const QEvent::Type RESULT_EVENT  = static_cast<QEvent::Type>(QEvent::registerEventType());
+
+///Carry a validation request from another thread, or a result from the pool
+class ValidationEvent final : public QEvent
+{
+public:
+   ValidationEvent(QEvent::Type type, Certificate* cert, const ValidationKey& key = ValidationKey()) :
+      QEvent(type), m_pCertificate(cert), m_Key(key) {}
+
+   QPointer<Certificate> m_pCertificate;
+   ValidationKey         m_Key         ;
+   MapStringString       m_Checks      ;
+   MapStringString       m_Details     ;
+};
+
+///Hash the certificate and read its disk cache entry
+class KeyTask final : public QRunnable
+{
+public:
+   KeyTask(QObject* receiver, Certificate* cert, const QString& path, const QString& privateKey) :
+      m_pReceiver(receiver), m_pCertificate(cert), m_Path(path), m_PrivateKey(privateKey) {}
+
+   virtual void run() override {
+      auto e = new ValidationEvent(KEY_EVENT, m_pCertificate, CertificateValidator::computeKey(m_Path, m_PrivateKey));
+
+      CertificateValidator::instance().lookup(e->m_Key.hash, CertificateValidator::Section::CHECKS , e->m_Checks );
+      CertificateValidator::instance().lookup(e->m_Key.hash, CertificateValidator::Section::DETAILS, e->m_Details);
+
+      QCoreApplication::postEvent(m_pReceiver, e);
+   }
+
+private:
+   QObject*              m_pReceiver   ;
+   QPointer<Certificate> m_pCertificate;
+   QString               m_Path        ;
+   QString               m_PrivateKey  ;
+};
+
+#ifdef ENABLE_LIBWRAP
+///The ConfigurationManager instance has to be created by the main thread first
+class ValidationTask final : public QRunnable
+{
+public:
+   ValidationTask(QObject* receiver, Certificate* cert, const ValidationKey& key) :
+      m_pReceiver(receiver), m_pCertificate(cert), m_Key(key) {}
+
+   virtual void run() override {
+      auto e = new ValidationEvent(RESULT_EVENT, m_pCertificate, m_Key);
+
+      e->m_Checks  = ConfigurationManager::instance().validateCertificatePath(QString(), m_Key.path, m_Key.privateKey, QString(), {});
+      e->m_Details = ConfigurationManager::instance().getCertificateDetailsPath(m_Key.path, m_Key.privateKey, QString());
+
+      QCoreApplication::postEvent(m_pReceiver, e);
+   }
+
+private:
+   QObject*              m_pReceiver   ;
+   QPointer<Certificate> m_pCertificate;
+   ValidationKey         m_Key         ;
+};
+#endif
+
+static QString cachePath()
+{
+   return QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/certificates.cache";
+}
+
+///The daemon date format isn't always the same
+static qint64 parseDate(const QString& date)
+{
+   QDateTime d = QDateTime::fromString(date, Qt::ISODate);
+
+   if (!d.isValid())
+      d = QDateTime(QDate::fromString(date, "yyyy-MM-dd"));
+
+   return d.isValid() ? d.toMSecsSinceEpoch() : 0;
+}
+
+CertificateValidator::CertificateValidator() : QObject(),
+m_pSaveTimer(new QTimer(this)), m_IsLoaded(false), m_IsDirty(false)
+{
+   m_pSaveTimer->setSingleShot(true);
+   m_pSaveTimer->setInterval(2000);
+   connect(m_pSaveTimer, &QTimer::timeout, this, &CertificateValidator::slotSave);
+
+   //The first certificates can be loaded by the folder loader thread
+   if (QCoreApplication::instance()) {
+      moveToThread(QCoreApplication::instance()->thread());
+      connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &CertificateValidator::slotSave);
+   }
+}
+
+CertificateValidator& CertificateValidator::instance()
+{
+   static auto validator = new CertificateValidator();
+   return *validator;
+}
+
+///The certificate and private key modification times and permissions
+QByteArray CertificateValidator::stamp(const QString& path, const QString& privateKey)
+{
+   const QFileInfo info(path);
+
+   QByteArray ret = QByteArray::number(info.lastModified().toMSecsSinceEpoch())
+      + ':' + QByteArray::number(static_cast<int>(info.permissions()));
+
+   //The key pair checks also depend on the private key
+   if (!privateKey.isEmpty()) {
+      const QFileInfo keyInfo(privateKey);
+      ret += ':' + QByteArray::number(keyInfo.lastModified().toMSecsSinceEpoch())
+         + ':' + QByteArray::number(static_cast<int>(keyInfo.permissions()));
+   }
+
+   return ret;
+}
+
+/**
+ * Hash the certificate file, the hash is empty when it cannot be read. This
+ * reads the whole file, it is only called from the thread pool.
+ */
+ValidationKey CertificateValidator::computeKey(const QString& path, const QString& privateKey)
+{
+   ValidationKey ret;
+   ret.path       = path;
+   ret.privateKey = privateKey;
+   ret.stamp      = stamp(path, privateKey);
+
+   QFile file(path);
+
+   if (!file.open(QIODevice::ReadOnly))
+      return ret;
+
+   QCryptographicHash hash(QCryptographicHash::Sha1);
+   hash.addData(QCryptographicHash::hash(file.readAll(), QCryptographicHash::Sha1));
+   hash.addData(ret.stamp);
+   hash.addData(path.toUtf8());
+   hash.addData(privateKey.toUtf8());
+
+   ret.hash = hash.result().toHex();
+
+   return ret;
+}
+
+///If the files are still the ones the key was computed from
+bool CertificateValidator::isCurrent(const CertificatePrivate* d, const ValidationKey& k)
+{
+   return (!k.hash.isEmpty())
+      && d->m_Path       == k.path
+      && d->m_PrivateKey == k.privateKey
+      && stamp(k.path, k.privateKey) == k.stamp;
+}
+
+/**
+ * Return the cache key of a certificate, or an empty key when it cannot be
+ * cached or when it was not computed yet.
+ */
+QByteArray CertificateValidator::key(const CertificatePrivate* d)
+{
+   if (d->m_LoadingType != LoadingType::FROM_PATH || !d->m_PrivateKeyPassword.isEmpty())
+      return QByteArray();
+
+   return isCurrent(d, d->m_ValidationKey) ? d->m_ValidationKey.hash : QByteArray();
+}
+
+bool CertificateValidator::lookup(const QByteArray& key, Section s, MapStringString& out)
+{
+   if (key.isEmpty())
+      return false;
+
+   QMutexLocker l(&m_Mutex);
+
+   load();
+
+   auto it = m_hEntries.find(key);
+
+   if (it == m_hEntries.end())
+      return false;
+
+   //The certificate expired or was activated since
+   if (it->validUntil < QDateTime::currentMSecsSinceEpoch()) {
+      m_hEntries.erase(it);
+      m_IsDirty = true;
+      return false;
+   }
+
+   const MapStringString& values = s == Section::CHECKS ? it->checks : it->details;
+
+   if (values.isEmpty())
+      return false;
+
+   out = values;
+
+   return true;
+}
+
+void CertificateValidator::store(const QByteArray& key, Section s, const MapStringString& values)
+{
+   //The daemon replies nothing when it failed, don't keep that
+   if (key.isEmpty() || values.isEmpty())
+      return;
+
+   QMutexLocker l(&m_Mutex);
+
+   load();
+
+   const qint64 now   = QDateTime::currentMSecsSinceEpoch();
+   const qint64 until = now + qint64(MAX_AGE) * 24 * 3600 * 1000;
+
+   if (!m_hEntries.contains(key))
+      m_hEntries[key].validUntil = until;
+
+   Entry& e = m_hEntries[key];
+
+   //The previous values are replaced, they may come from a stale entry
+   if (s == Section::CHECKS)
+      e.checks = values;
+   else {
+      e.details    = values;
+      e.validUntil = until;
+
+      //The EXPIRED and NOT_ACTIVATED checks change at those dates
+      const qint64 expiration = parseDate(values[DRing::Certificate::DetailsNames::EXPIRATION_DATE]);
+      const qint64 activation = parseDate(values[DRing::Certificate::DetailsNames::ACTIVATION_DATE]);
+
+      if (expiration > now)
+         e.validUntil = qMin(e.validUntil, expiration);
+
+      if (activation > now)
+         e.validUntil = qMin(e.validUntil, activation);
+   }
+
+   m_IsDirty = true;
+
+   QMetaObject::invokeMethod(m_pSaveTimer, "start", Qt::QueuedConnection);
+}
+
+/**
+ * Fill the certificate caches from the disk cache, or validate it in the
+ * background. Can be called from any thread.
+ */
+void CertificateValidator::validate(Certificate* cert)
+{
+   if (!cert)
+      return;
+
+   if (QThread::currentThread() != thread()) {
+      QCoreApplication::postEvent(this, new ValidationEvent(REQUEST_EVENT, cert));
+      return;
+   }
+
+   CertificatePrivate* d = cert->d_ptr;
+
+   if (d->m_pCheckCache && d->m_pDetailsCache)
+      return;
+
+   if (d->m_LoadingType != LoadingType::FROM_PATH || !d->m_PrivateKeyPassword.isEmpty())
+      return;
+
+#ifdef ENABLE_LIBWRAP
+   //The validation tasks use it from the pool threads
+   ConfigurationManager::instance();
+#endif
+
+   QThreadPool::globalInstance()->start(new KeyTask(this, cert, d->m_Path, d->m_PrivateKey));
+}
+
+///Apply the cached sections and ask the daemon for the missing ones
+void CertificateValidator::request(Certificate* cert, const ValidationKey& k, const MapStringString& checks, const MapStringString& details)
+{
+   if ((!cert) || k.hash.isEmpty())
+      return;
+
+   CertificatePrivate* d = cert->d_ptr;
+
+   //The paths changed while the key was computed
+   if (d->m_Path != k.path || d->m_PrivateKey != k.privateKey)
+      return;
+
+   d->m_ValidationKey = k;
+
+   if (m_hPending.contains(k.hash))
+      return;
+
+   finish(k, cert, Section::CHECKS , checks );
+   finish(k, cert, Section::DETAILS, details);
+
+   if ((!checks.isEmpty()) && !details.isEmpty())
+      return;
+
+   m_hPending[k.hash] = 2;
+
+#ifndef ENABLE_LIBWRAP
+   QPointer<Certificate> ptr(cert);
+
+   auto checksWatcher = new QDBusPendingCallWatcher(ConfigurationManager::instance().validateCertificatePath(
+      QString(), k.path, k.privateKey, QString(), {}
+   ), this);
+
+   auto detailsWatcher = new QDBusPendingCallWatcher(ConfigurationManager::instance().getCertificateDetailsPath(
+      k.path, k.privateKey, QString()
+   ), this);
+
+   connect(checksWatcher, &QDBusPendingCallWatcher::finished, [this, k, ptr](QDBusPendingCallWatcher* w) {
+      w->deleteLater();
+      const QDBusPendingReply<MapStringString> reply = *w;
+      finish(k, ptr, Section::CHECKS, reply.isError() ? MapStringString() : reply.value());
+   });
+
+   connect(detailsWatcher, &QDBusPendingCallWatcher::finished, [this, k, ptr](QDBusPendingCallWatcher* w) {
+      w->deleteLater();
+      const QDBusPendingReply<MapStringString> reply = *w;
+      finish(k, ptr, Section::DETAILS, reply.isError() ? MapStringString() : reply.value());
+   });
+#else
+   QThreadPool::globalInstance()->start(new ValidationTask(this, cert, k));
+#endif
+}
+
+///Store a result and apply it unless it was loaded synchronously in the meantime
+void CertificateValidator::finish(const ValidationKey& k, Certificate* cert, Section s, const MapStringString& values)
+{
+   auto pending = m_hPending.find(k.hash);
+   const bool isReply = pending != m_hPending.end();
+
+   if (isReply) {
+      store(k.hash, s, values);
+
+      if (!--(*pending))
+         m_hPending.erase(pending);
+   }
+
+   if ((!cert) || values.isEmpty())
+      return;
+
+   CertificatePrivate* d = cert->d_ptr;
+
+   //The certificate or the private key changed since the request
+   if (isReply && !isCurrent(d, k))
+      return;
+
+   if (s == Section::CHECKS && !d->m_pCheckCache)
+      d->setChecks(values);
+   else if (s == Section::DETAILS && !d->m_pDetailsCache) {
+      d->setDetails(values);
+      emit cert->changed();
+   }
+}
+
+bool CertificateValidator::event(QEvent* e)
+{
+   if (e->type() == REQUEST_EVENT) {
+      if (Certificate* cert = static_cast<ValidationEvent*>(e)->m_pCertificate)
+         validate(cert);
+      return true;
+   }
+
+   if (e->type() == KEY_EVENT) {
+      const ValidationEvent* ve = static_cast<ValidationEvent*>(e);
+      request(ve->m_pCertificate, ve->m_Key, ve->m_Checks, ve->m_Details);
+      return true;
+   }
+
+   if (e->type() == RESULT_EVENT) {
+      const ValidationEvent* ve = static_cast<ValidationEvent*>(e);
+      finish(ve->m_Key, ve->m_pCertificate, Section::CHECKS , ve->m_Checks );
+      finish(ve->m_Key, ve->m_pCertificate, Section::DETAILS, ve->m_Details);
+      return true;
+   }
+
+   return QObject::event(e);
+}
+
+static QJsonObject toJson(const MapStringString& values)
+{
+   QJsonObject ret;
+
+   for (auto it = values.constBegin(); it != values.constEnd(); ++it)
+      ret[it.key()] = it.value();
+
+   return ret;
+}
+
+static MapStringString fromJson(const QJsonObject& values)
+{
+   MapStringString ret;
+
+   for (auto it = values.constBegin(); it != values.constEnd(); ++it)
+      ret[it.key()] = it.value().toString();
+
+   return ret;
+}
+
+///Must be called with the mutex locked
+void CertificateValidator::load()
+{
+   if (m_IsLoaded)
+      return;
+
+   m_IsLoaded = true;
+
+   QFile file(cachePath());
+
+   if (!file.open(QIODevice::ReadOnly))
+      return;
+
+   const QJsonObject doc = QJsonDocument::fromJson(file.readAll()).object();
+
+   for (auto it = doc.constBegin(); it != doc.constEnd(); ++it) {
+      const QJsonObject o = it.value().toObject();
+
+      Entry& e     = m_hEntries[it.key().toLatin1()];
+      e.checks     = fromJson(o["checks" ].toObject());
+      e.details    = fromJson(o["details"].toObject());
+      e.validUntil = static_cast<qint64>(o["until"].toDouble());
+   }
+}
+
+void CertificateValidator::slotSave()
+{
+   QMutexLocker l(&m_Mutex);
+
+   if (!m_IsDirty)
+      return;
+
+   m_IsDirty = false;
+
+   const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+   QJsonObject doc;
+
+   for (auto it = m_hEntries.constBegin(); it != m_hEntries.constEnd(); ++it) {
+      if (it->validUntil < now)
+         continue;
+
+      QJsonObject o;
+      o["checks" ] = toJson(it->checks );
+      o["details"] = toJson(it->details);
+      o["until"  ] = static_cast<double>(it->validUntil);
+
+      doc[QString::fromLatin1(it.key())] = o;
+   }
+
+   QDir().mkpath(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
+
+   QFile file(cachePath());
+
+   if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+      qWarning() << "Cannot write the certificate cache" << cachePath();
+      return;
+   }
+
+   file.write(QJsonDocument(doc).toJson(QJsonDocument::Compact));
+}
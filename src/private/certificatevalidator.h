@@ -0,0 +1,97 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QObject>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+class QTimer;
+
+//Ring
+#include <typedefs.h>
+class Certificate;
+class CertificatePrivate;
+struct ValidationKey;
+
+/**
+ * Validate the certificates loaded from files in the background and keep the
+ * daemon checks and details on disk.
+ *
+ * The entries are keyed by a hash of the certificate fingerprint, the file
+ * modification time and permissions and the private key, so an unchanged
+ * certificate is not validated again on the next startup. They expire with
+ * the certificate (or after MAX_AGE, for the revocation lists). The key is
+ * computed once per certificate on the global thread pool, then only the
+ * paths and the file modification times and permissions are compared.
+ *
+ * With DBus, the requests are sent asynchronously and the daemon handles
+ * them concurrently. With libwrap, they run on the global thread pool.
+ * Certificates loaded from an id or with a private key password are not
+ * cached.
+ */
+class CertificateValidator final : public QObject
+{
+   Q_OBJECT
+public:
+   enum class Section {
+      CHECKS ,
+      DETAILS,
+   };
+
+   ///Re-validate the cached entries after this amount of days
+   constexpr static const int MAX_AGE = 7;
+
+   static CertificateValidator& instance();
+   static QByteArray    key       (const CertificatePrivate* d                   );
+   static ValidationKey computeKey(const QString& path, const QString& privateKey);
+
+   void validate(Certificate* cert                                                  );
+   bool lookup  (const QByteArray& key, Section s,       MapStringString& out       );
+   void store   (const QByteArray& key, Section s, const MapStringString& values    );
+
+protected:
+   virtual bool event(QEvent* e) override;
+
+private:
+   explicit CertificateValidator();
+
+   struct Entry {
+      MapStringString checks    ;
+      MapStringString details   ;
+      qint64          validUntil;
+   };
+
+   //Helpers
+   static QByteArray stamp    (const QString& path, const QString& privateKey   );
+   static bool       isCurrent(const CertificatePrivate* d, const ValidationKey& k);
+   void load   ();
+   void request(Certificate* cert, const ValidationKey& k, const MapStringString& checks, const MapStringString& details);
+   void finish (const ValidationKey& k, Certificate* cert, Section s, const MapStringString& values);
+
+   //Attributes
+   QHash<QByteArray,Entry> m_hEntries  ;
+   QHash<QByteArray,int>   m_hPending  ;
+   QMutex                  m_Mutex     ;
+   QTimer*                 m_pSaveTimer;
+   bool                    m_IsLoaded  ;
+   bool                    m_IsDirty   ;
+
+private Q_SLOTS:
+   void slotSave();
+};
@@ -17,6 +17,8 @@
  ***************************************************************************/
 #pragma once
 
+#include "private/usagestatistics.h"
+
 class ContactMethodPrivate {
 public:
    ContactMethodPrivate(const URI& number, NumberCategory* cat, ContactMethod::Type st,
@@ -33,8 +35,7 @@ public:
    QString            m_MostCommonName   ;
    QHash<QString,QPair<int,time_t>> m_hNames;
    bool               m_hasType          ;
-   uint               m_LastWeekCount    ;
-   uint               m_LastTrimCount    ;
+   UsageStatistics    m_Usage            ;
    bool               m_HaveCalled       ;
    int                m_Index            ;
    bool               m_IsBookmark       ;
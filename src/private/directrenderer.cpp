@@ -20,11 +20,16 @@
 
 #include <QtCore/QDebug>
 #include <QtCore/QMutex>
+#include <QtCore/QSharedPointer>
 #include <QtCore/QThread>
 #include <QtCore/QTime>
 #include <QtCore/QTimer>
 
 #include <cstring>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 #ifndef CLOCK_REALTIME
 #define CLOCK_REALTIME 0
@@ -38,6 +43,34 @@
 
 namespace Video {
 
+/**
+ * A frame buffer owned by the renderer pool. The daemon borrows it to decode
+ * a frame, then the clients read it through sharedFrame() handles.
+ */
+struct FrameSlot {
+    DRing::SinkTarget::FrameBufferPtr buffer; ///< nullptr while lent to the daemon
+    DRing::FrameBuffer*               raw   ;
+    Video::Frame                      frame ; ///< Shared view on the decoded frame
+    int                               refs  ; ///< Live sharedFrame() handles
+};
+
+/**
+ * The frame buffers are shared by the renderer and the frame handles, so a
+ * handle can outlive the renderer. A slot goes back to the free list only
+ * once it is neither the latest frame nor referenced by a handle.
+ */
+struct FramePool {
+    void recycle(FrameSlot* slot);
+    void release(FrameSlot* slot);
+
+    QMutex mutex;
+    std::unordered_map< DRing::FrameBuffer*, std::unique_ptr<FrameSlot> > slots;
+    std::vector<FrameSlot*>  freeSlots              ; ///< Slots neither lent nor displayed
+    FrameSlot*               latest      {nullptr}  ; ///< Last frame pushed by the daemon
+    std::atomic<quint64>     allocations {0}        ;
+    std::atomic<quint64>     recycles    {0}        ;
+};
+
 class DirectRendererPrivate : public QObject
 {
     Q_OBJECT
@@ -48,7 +81,9 @@ public:
 
     DRing::SinkTarget target;
     mutable QMutex directmutex;
-    mutable DRing::SinkTarget::FrameBufferPtr daemonFramePtr_;
+
+    QSharedPointer<FramePool> m_pPool;
+
 private:
     Video::DirectRenderer* q_ptr;
 };
@@ -57,6 +92,7 @@ private:
 
 Video::DirectRendererPrivate::DirectRendererPrivate(Video::DirectRenderer* parent) :
 QObject(parent),
+m_pPool(new FramePool),
 q_ptr(parent)
 {
     using namespace std::placeholders;
@@ -85,47 +121,164 @@ void Video::DirectRenderer::startRendering()
 void Video::DirectRenderer::stopRendering ()
 {
    Video::Renderer::d_ptr->m_isRendering = false;
+
+   {
+      FramePool* pool = d_ptr->m_pPool.data();
+      QMutexLocker lock(&pool->mutex);
+      FrameSlot* latest = pool->latest;
+      pool->latest = nullptr;
+      pool->recycle(latest);
+   }
+
    emit stopped();
 }
 
+///Put a slot back in the free list unless it is still displayed, must be locked
+void Video::FramePool::recycle(FrameSlot* slot)
+{
+    if (slot && slot->buffer && slot != latest && not slot->refs)
+        freeSlots.push_back(slot);
+}
+
+///Drop a sharedFrame() handle
+void Video::FramePool::release(FrameSlot* slot)
+{
+    QMutexLocker lk(&mutex);
+    --slot->refs;
+    recycle(slot);
+}
+
+///Lend a free buffer of the pool to the daemon, allocate one only if none is free
 DRing::SinkTarget::FrameBufferPtr Video::DirectRendererPrivate::requestFrameBuffer(std::size_t bytes)
 {
-    QMutexLocker lk(q_ptr->mutex());
-    if (not daemonFramePtr_)
-        daemonFramePtr_.reset(new DRing::FrameBuffer);
-    daemonFramePtr_->storage.resize(bytes);
-    daemonFramePtr_->ptr = daemonFramePtr_->storage.data();
-    daemonFramePtr_->ptrSize = bytes;
-    return std::move(daemonFramePtr_);
+    FramePool* pool = m_pPool.data();
+    QMutexLocker lk(&pool->mutex);
+
+    FrameSlot* slot = nullptr;
+
+    if (not pool->freeSlots.empty()) {
+        slot = pool->freeSlots.back();
+        pool->freeSlots.pop_back();
+
+        if (slot->buffer->storage.capacity() < bytes)
+            ++pool->allocations;
+        else
+            ++pool->recycles;
+    }
+    else {
+        std::unique_ptr<FrameSlot> s(new FrameSlot);
+        s->buffer.reset(new DRing::FrameBuffer);
+        s->raw  = s->buffer.get();
+        s->refs = 0;
+        slot = s.get();
+        pool->slots[slot->raw] = std::move(s);
+        ++pool->allocations;
+    }
+
+    auto buf = std::move(slot->buffer);
+    buf->storage.resize(bytes);
+    buf->ptr = buf->storage.data();
+    buf->ptrSize = bytes;
+    return buf;
 }
 
+///Take back a buffer from the daemon and make it the current frame
 void Video::DirectRendererPrivate::onNewFrame(DRing::SinkTarget::FrameBufferPtr buf)
 {
-    if (not q_ptr->isRendering())
+    if (not buf)
         return;
 
     {
-        QMutexLocker lk(q_ptr->mutex());
-        daemonFramePtr_ = std::move(buf);
+        FramePool* pool = m_pPool.data();
+        QMutexLocker lk(&pool->mutex);
+
+        auto& s = pool->slots[buf.get()];
+
+        // The buffer was not requested from this pool, adopt it
+        if (not s) {
+            s.reset(new FrameSlot);
+            s->raw  = buf.get();
+            s->refs = 0;
+        }
+
+        FrameSlot* slot = s.get();
+        slot->buffer     = std::move(buf);
+        slot->frame.ptr  = slot->raw->ptr;
+        slot->frame.size = slot->raw->ptrSize;
+
+        if (not q_ptr->isRendering()) {
+            pool->recycle(slot);
+            return;
+        }
+
+        FrameSlot* previous = pool->latest;
+        pool->latest = slot;
+        pool->recycle(previous);
     }
 
     emit q_ptr->frameUpdated();
 }
 
+/**
+ * Copy the latest frame. The pooled buffers are recycled as soon as they are
+ * not referenced anymore, so the frame can't borrow them, use sharedFrame()
+ * to avoid the copy.
+ */
 Video::Frame Video::DirectRenderer::currentFrame() const
 {
     if (not isRendering())
         return {};
 
-    QMutexLocker lock(mutex());
-    if (not d_ptr->daemonFramePtr_)
+    FramePool* pool = d_ptr->m_pPool.data();
+    QMutexLocker lock(&pool->mutex);
+
+    if (not pool->latest)
         return {};
 
+    const Video::Frame& latest = pool->latest->frame;
+
     Video::Frame frame;
-    frame.storage = std::move(d_ptr->daemonFramePtr_->storage);
-    frame.ptr = frame.storage.data();
-    frame.size = frame.storage.size();
-    return std::move(frame);
+    frame.storage.assign(latest.ptr, latest.ptr + latest.size);
+    frame.ptr  = frame.storage.data();
+    frame.size = latest.size;
+    return frame;
+}
+
+/**
+ * Share the latest frame without copying it. The buffer is not reused by
+ * the daemon until the last copy of the handle is destroyed, so the clients
+ * should not keep it longer than needed.
+ */
+QSharedPointer<const Video::Frame> Video::DirectRenderer::sharedFrame() const
+{
+    if (not isRendering())
+        return {};
+
+    const QSharedPointer<FramePool> pool = d_ptr->m_pPool;
+    QMutexLocker lock(&pool->mutex);
+
+    FrameSlot* slot = pool->latest;
+
+    if (not slot)
+        return {};
+
+    ++slot->refs;
+
+    return QSharedPointer<const Video::Frame>(&slot->frame, [pool, slot](const Video::Frame*) {
+        pool->release(slot);
+    });
+}
+
+///Number of frame buffers (re)allocated since the renderer creation
+quint64 Video::DirectRenderer::frameAllocationCount() const
+{
+    return d_ptr->m_pPool->allocations.load();
+}
+
+///Number of frames decoded in a recycled buffer without allocation
+quint64 Video::DirectRenderer::frameRecycleCount() const
+{
+    return d_ptr->m_pPool->recycles.load();
 }
 
 const DRing::SinkTarget& Video::DirectRenderer::target() const
@@ -19,6 +19,7 @@
 
 //Base
 #include <QtCore/QObject>
+#include <QtCore/QSharedPointer>
 #include "typedefs.h"
 #include "video/renderer.h"
 #include "videomanager_interface.h"
@@ -51,6 +52,11 @@ public:
    const DRing::SinkTarget& target() const;
    virtual ColorSpace colorSpace() const override;
    virtual Frame currentFrame() const override;
+   QSharedPointer<const Frame> sharedFrame() const;
+
+   //Statistics
+   quint64 frameAllocationCount() const;
+   quint64 frameRecycleCount   () const;
 
 
 public Q_SLOTS:
@@ -30,7 +30,7 @@ struct TypedStateMachine
    // no ctor/dtor and one public member variable for easy initialization
    T _data[size_t(E::COUNT__)];
 
-   T& operator[](E v) {
+   constexpr T& operator[](E v) {
    if (size_t(v) >= size_t(E::COUNT__)) {
       Q_ASSERT(false);
       qDebug() << "State Machine Out of Bound" << size_t(v);
@@ -39,7 +39,7 @@ struct TypedStateMachine
    return _data[size_t(v)];
    }
 
-   const T& operator[](E v) const {
+   constexpr const T& operator[](E v) const {
    if (size_t(v) >= size_t(E::COUNT__)) {
       Q_ASSERT(false);
       qDebug() << "State Machine Out of Bound" << size_t(v);
@@ -48,11 +48,11 @@ struct TypedStateMachine
    return _data[size_t(v)];
    }
 
-   T *begin() {
+   constexpr T *begin() {
    return _data;
    }
 
-   T *end() {
+   constexpr T *end() {
    return _data + size_t(E::COUNT__);
    }
 };
@@ -60,7 +60,7 @@ struct TypedStateMachine
 template<typename Enum>
 class EnumClassReordering {
 public:
-   EnumClassReordering(std::initializer_list<Enum> s);
+   constexpr EnumClassReordering(std::initializer_list<Enum> s);
 // private:
    Enum m_lData[enum_class_size<Enum>()];
 };
@@ -75,6 +75,11 @@ public:
  * * That the rows are indexed using enum_classes
  * * That the size of the matrix matches the enum_class size
  * * That the operators are within the matrix boundary
+ *
+ * The values are stored inline and contiguously. When Value is a literal
+ * type (bool, enums, function pointers, nested matrices of those), the
+ * constructors are evaluated at compile time and the tables end up in
+ * the read only data instead of being allocated on startup.
  */
 template<class Row, typename Value, typename A = Value>
 struct Matrix1D
@@ -90,19 +95,16 @@ struct Matrix1D
       std::initializer_list<Value> vs   ;
    };
 
-   Matrix1D(std::initializer_list< std::initializer_list<Value> > s);
-   Matrix1D(std::initializer_list< Pairs > s);
-   Matrix1D(std::initializer_list<Order> s);
-   explicit Matrix1D();
-   Matrix1D(const Matrix1D<Row,Value,A>& copy);
-   ~Matrix1D();
+   constexpr Matrix1D(std::initializer_list< std::initializer_list<Value> > s);
+   constexpr Matrix1D(std::initializer_list< Pairs > s);
+   constexpr Matrix1D(std::initializer_list<Order> s);
+   constexpr Matrix1D();
 
    // Row is a built-in type ("int" by default)
-   Value operator[](Row v);
-   void operator=(Matrix1D<Row,Value,A>& other);
+   constexpr Value& operator[](Row v);
    void operator=(std::initializer_list< Pairs > s);
 
-   const Value operator[](Row v) const;
+   constexpr const Value& operator[](Row v) const;
 
    /**
    * An Iterator for enum classes
@@ -138,10 +140,11 @@ struct Matrix1D
    void setAt(Row,Value);
 
    //Getter
-   bool isSet(Row);
+   constexpr bool isSet(Row) const;
 
 private:
-   Value* m_lData[enum_class_size<Row>()];
+   Value m_lData[enum_class_size<Row>()];
+   bool  m_lSet [enum_class_size<Row>()];
    static QMap<A, Row> m_hReverseMapping;
 };
 
@@ -16,6 +16,20 @@
  *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
  ***************************************************************************/
 
+/**
+ * Report a broken table. It is not constexpr on purpose: reaching it while a
+ * constexpr table is evaluated is a compilation error, in release builds too.
+ * The runtime tables (QString, FlagPack) only assert in debug builds.
+ */
+inline void matrixAssertFailed(const char* cond)
+{
+   Q_ASSERT_X(false, "Matrix1D", cond);
+   Q_UNUSED(cond)
+}
+
+///The checks depending on the constructor arguments, use static_assert for the others
+#define MATRIX_ASSERT(cond) do { if (Q_UNLIKELY(!(cond))) { matrixAssertFailed(#cond); } } while (0)
+
 template<class EnumClass >
 EnumIterator<EnumClass>::EnumIterator() {
    static_assert(std::is_enum<EnumClass>(),"The first template parameter has to be an enum class\n");
@@ -54,29 +68,14 @@ typename EnumIterator<EnumClass>::EnumClassIter EnumIterator<EnumClass>::end()
 }
 
 template<class Row, typename Value, typename Accessor>
-Matrix1D<Row,Value,Accessor>::Matrix1D() : m_lData{nullptr}
+constexpr Matrix1D<Row,Value,Accessor>::Matrix1D() : m_lData{}, m_lSet{}
 {
 }
 
-template<class Row, typename Value, typename Accessor>
-Matrix1D<Row,Value,Accessor>::Matrix1D(const Matrix1D<Row,Value,Accessor>& copy) : m_lData{nullptr}
-{
-   for (int i = 0; i < enum_class_size<Row>(); i++) {
-      m_lData[i] = new Value(*copy.m_lData[i]);
-   }
-}
-
-template<class Row, typename Value, typename Accessor>
-Matrix1D<Row,Value,Accessor>::~Matrix1D()
-{
-   for (auto v : m_lData)
-      delete v;
-}
-
 //DEPRECATED
 template<class Row, typename Value, typename Accessor>
-Matrix1D<Row,Value,Accessor>::Matrix1D(std::initializer_list< std::initializer_list<Value>> s)
-: m_lData{nullptr} {
+constexpr Matrix1D<Row,Value,Accessor>::Matrix1D(std::initializer_list< std::initializer_list<Value>> s)
+: m_lData{}, m_lSet{} {
    static_assert(std::is_enum<Row>(),"Row has to be an enum class");
    static_assert(static_cast<int>(Row::COUNT__) > 0,"Row need a COUNT__ element");
 
@@ -84,55 +83,59 @@ Matrix1D<Row,Value,Accessor>::Matrix1D(std::initializer_list< std::initializer_l
    for (auto& rows : s) {
       int row = 0;
       for (auto& value : rows) {
-         m_lData[row] = new Value(value);
+         m_lData[row] = value;
+         m_lSet [row] = true;
          row++;
       }
    }
 
-   // FIXME C++14, use static_assert and make the ctor constexpr
-   Q_ASSERT(std::begin(s)->size() == enum_class_size<Row>());//,"Matrix row have to match the enum class size");
+   //For the constexpr tables, a failed assertion is a compilation error
+   MATRIX_ASSERT(std::begin(s)->size() == enum_class_size<Row>());//,"Matrix row have to match the enum class size");
 }
 
 template<typename Enum>
-EnumClassReordering<Enum>::EnumClassReordering(std::initializer_list<Enum> s)
+constexpr EnumClassReordering<Enum>::EnumClassReordering(std::initializer_list<Enum> s) : m_lData{}
 {
    static_assert(std::is_enum<Enum>(),"Row has to be an enum class");
-   Q_ASSERT(s.size() == enum_class_size<Enum>());
+   MATRIX_ASSERT(s.size() == enum_class_size<Enum>());
 
    //FIXME the code below isn't correct, this isn't a problem until the limit
    //is reached. This is private API, so it can wait
-   static const int longSize = sizeof(unsigned long long)*8;
-   Q_ASSERT(enum_class_size<Enum>() < longSize -1);
+   constexpr int longSize = sizeof(unsigned long long)*8;
+   static_assert(enum_class_size<Enum>() < longSize -1, "Too many elements");
 
    unsigned long long usedElements[enum_class_size<Enum>()] = {};
 
    int i=0;
    for (auto& p : s) {
       const int val = static_cast<int>(p);
-      Q_ASSERT(!(usedElements[val/longSize] & (0x1 << (val%longSize)))); // isNotPresent
+      MATRIX_ASSERT(!(usedElements[val/longSize] & (0x1 << (val%longSize)))); // isNotPresent
       usedElements[val/longSize] |= (0x1 << (val%longSize));
       m_lData[i++] = p;
    }
 }
 
 template<class Row, typename Value, typename Accessor>
-Matrix1D<Row,Value,Accessor>::Matrix1D(std::initializer_list< Matrix1D<Row,Value,Accessor>::Order > s)
-: m_lData{} {
+constexpr Matrix1D<Row,Value,Accessor>::Matrix1D(std::initializer_list< Matrix1D<Row,Value,Accessor>::Order > s)
+: m_lData{}, m_lSet{} {
    static_assert(std::is_enum<Row>(),"Row has to be an enum class");
    static_assert(static_cast<int>(Row::COUNT__) > 0,"Row need a COUNT__ element");
-      Q_ASSERT(s.size() == 1);
+      MATRIX_ASSERT(s.size() == 1);
 
    for (const Matrix1D<Row,Value,Accessor>::Order& p : s) {
-      // FIXME C++14, use static_assert and make the ctor constexpr
-      Q_ASSERT(p.vs.size() == enum_class_size<Row>());
+      //For the constexpr tables, a failed assertion is a compilation error
+      MATRIX_ASSERT(p.vs.size() == enum_class_size<Row>());
 
-      int reOredered[enum_class_size<Row>()],i(0);
+      int reOredered[enum_class_size<Row>()] = {},i(0);
       for (const Row r : p.order.m_lData)
          reOredered[i++] = static_cast<int>(r);
 
       i = 0;
-      for (auto& r : p.vs)
-         m_lData[reOredered[i++]] = new Value(r);
+      for (auto& r : p.vs) {
+         m_lData[reOredered[i]] = r;
+         m_lSet [reOredered[i]] = true;
+         i++;
+      }
 
    }
 
@@ -143,16 +146,16 @@ Matrix1D<Row,Value,Accessor>::Matrix1D(std::initializer_list< Matrix1D<Row,Value
  * they are present only once and support re-ordering
  */
 template<class Row, typename Value, typename Accessor>
-Matrix1D<Row,Value,Accessor>::Matrix1D(std::initializer_list< Matrix1D<Row,Value,Accessor>::Pairs> s)
-: m_lData{} {
+constexpr Matrix1D<Row,Value,Accessor>::Matrix1D(std::initializer_list< Matrix1D<Row,Value,Accessor>::Pairs> s)
+: m_lData{}, m_lSet{} {
    static_assert(std::is_enum<Row>(),"Row has to be an enum class");
    static_assert(static_cast<int>(Row::COUNT__) > 0,"Row need a COUNT__ element");
 
-   static const int longSize = sizeof(unsigned long long)*8;
+   constexpr int longSize = sizeof(unsigned long long)*8;
 
    //FIXME the code below isn't correct, this isn't a problem until the limit
    //is reached. This is private API, so it can wait
-   Q_ASSERT(enum_class_size<Row>() < longSize -1);
+   static_assert(enum_class_size<Row>() < longSize -1, "Too many elements");
 
    unsigned long long usedElements[enum_class_size<Row>()] = {};
 
@@ -160,56 +163,48 @@ Matrix1D<Row,Value,Accessor>::Matrix1D(std::initializer_list< Matrix1D<Row,Value
    for (auto& pair : s) {
       //Avoid a value being here twice
       const int val = static_cast<int>(pair.key);
-      Q_ASSERT(!(usedElements[val/longSize] & (0x1 << (val%longSize)))); // isNotPresent
+      MATRIX_ASSERT(!(usedElements[val/longSize] & (0x1 << (val%longSize)))); // isNotPresent
 
       usedElements[val/longSize] |= (0x1 << (val%longSize));
 
 
-      m_lData[val] = new Value(pair.value);
+      m_lData[val] = pair.value;
+      m_lSet [val] = true;
       counter++;
    }
 
-   // FIXME C++14, use static_assert and make the ctor constexpr
-   Q_ASSERT(counter == enum_class_size<Row>());//,"Matrix row have to match the enum class size");
+   //For the constexpr tables, a failed assertion is a compilation error
+   MATRIX_ASSERT(counter == enum_class_size<Row>());//,"Matrix row have to match the enum class size");
 }
 
 template<class Row, typename Value, typename Accessor>
-Value Matrix1D<Row,Value,Accessor>::operator[](Row v) {
+constexpr Value& Matrix1D<Row,Value,Accessor>::operator[](Row v) {
    //ASSERT(size_t(v) >= size_t(Row::COUNT__),"State Machine Out of Bounds\n");
    if (size_t(v) >= enum_class_size<Row>() || static_cast<int>(v) < 0) {
       qWarning() << "State Machine Out of Bounds" << size_t(v);
       Q_ASSERT(false);
       throw v;
    }
-   return *m_lData[static_cast<int>(v)];
+   return m_lData[static_cast<int>(v)];
 }
 
 template<class Row, typename Value, typename Accessor>
-const Value Matrix1D<Row,Value,Accessor>::operator[](Row v) const {
-   Q_ASSERT(size_t(v) <= enum_class_size<Row>()+1 && size_t(v)>=0); //COUNT__ is also valid
+constexpr const Value& Matrix1D<Row,Value,Accessor>::operator[](Row v) const {
+   MATRIX_ASSERT(size_t(v) <= enum_class_size<Row>()+1 && size_t(v)>=0); //COUNT__ is also valid
    if (size_t(v) >= enum_class_size<Row>()) {
       qWarning() << "State Machine Out of Bounds" << size_t(v);
       Q_ASSERT(false);
       throw v;
    }
-   Q_ASSERT(m_lData[static_cast<int>(v)]);
+   MATRIX_ASSERT(m_lSet[static_cast<int>(v)]);
 
-   return *(m_lData[static_cast<int>(v)]);
-}
-
-template<class Row, typename Value, typename Accessor>
-void Matrix1D<Row,Value,Accessor>::operator=(Matrix1D<Row,Value,Accessor>& other)
-{
-   for (int i = 0; i < enum_class_size<Row>(); i++) {
-      m_lData[i] = new Value(*other.m_lData[i]);
-   }
+   return m_lData[static_cast<int>(v)];
 }
 
 template<class Row, typename Value, typename Accessor>
 void Matrix1D<Row,Value,Accessor>::operator=(std::initializer_list< Pairs > s)
 {
-   Matrix1D<Row,Value,Accessor> m(s);
-   (*this) = m;
+   (*this) = Matrix1D<Row,Value,Accessor>(s);
 }
 
 template <class E, class T, class A> QMap<A,E> Matrix1D<E,T,A>::m_hReverseMapping;
@@ -251,27 +246,27 @@ bool Matrix1D<Row,Value,Accessor>::Matrix1DEnumClassIter::operator== (const Matr
 template<class Row, typename Value, typename Accessor>
 void Matrix1D<Row,Value,Accessor>::Matrix1DEnumClassIter::operator= (Value& other) const
 {
-   p_vec_->m_lData[pos_] = &other;
+   p_vec_->setAt(static_cast<Row>(pos_), other);
 }
 
 template<class Row, typename Value, typename Accessor>
 void Matrix1D<Row,Value,Accessor>::Matrix1DEnumClassIter::operator= (Value& other)
 {
-   p_vec_->m_lData[pos_] = &other;
+   p_vec_->setAt(static_cast<Row>(pos_), other);
 }
 
 ///@return if the value was changed (return false for identical values)
 template<class Row, typename Value, typename Accessor>
 void Matrix1D<Row,Value,Accessor>::setAt(Row row,Value value)
 {
-   if (m_lData[(int)row])
-      delete m_lData[(int)row];
-
-   m_lData[(int)row] = new Value(value);
+   m_lData[(int)row] = value;
+   m_lSet [(int)row] = true;
 }
 
 template<class Row, typename Value, typename Accessor>
-bool Matrix1D<Row,Value,Accessor>::isSet(Row row)
+constexpr bool Matrix1D<Row,Value,Accessor>::isSet(Row row) const
 {
-   return m_lData[static_cast<int>(row)] != nullptr;
+   return m_lSet[static_cast<int>(row)];
 }
+
+#undef MATRIX_ASSERT
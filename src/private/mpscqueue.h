@@ -0,0 +1,113 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Std
+#include <atomic>
+
+/**
+ * Intrusive lock-free multiple producers, single consumer queue.
+ *
+ * The node type needs a "std::atomic<Node*> next" member and to be default
+ * constructible, a stub node is kept inside the queue. push() is wait-free
+ * and can be called from any thread, pop() and isEmpty() are reserved to
+ * the consumer thread.
+ *
+ * The nodes are not owned, the consumer has to pop and delete them.
+ */
+template<typename Node>
+class MpscQueue final
+{
+public:
+   explicit MpscQueue();
+
+   //Mutators
+   void  push(Node* n);
+   Node* pop (       );
+
+   //Getters
+   bool isEmpty() const;
+
+private:
+   //Attributes
+   std::atomic<Node*> m_pHead ;
+   Node*              m_pTail ;
+   Node               m_Stub  ;
+};
+
+template<typename Node>
+MpscQueue<Node>::MpscQueue() : m_pTail(&m_Stub)
+{
+   m_Stub.next.store(nullptr);
+   m_pHead.store(&m_Stub);
+}
+
+template<typename Node>
+void MpscQueue<Node>::push(Node* n)
+{
+   n->next.store(nullptr, std::memory_order_relaxed);
+   Node* prev = m_pHead.exchange(n, std::memory_order_acq_rel);
+   prev->next.store(n, std::memory_order_release);
+}
+
+/**
+ * Return nullptr when the queue is empty or when a producer is between the
+ * two steps of push(). In the later case, isEmpty() is still false.
+ */
+template<typename Node>
+Node* MpscQueue<Node>::pop()
+{
+   Node* tail = m_pTail;
+   Node* next = tail->next.load(std::memory_order_acquire);
+
+   if (tail == &m_Stub) {
+      if (!next)
+         return nullptr;
+
+      m_pTail = next;
+      tail    = next;
+      next    = next->next.load(std::memory_order_acquire);
+   }
+
+   if (next) {
+      m_pTail = next;
+      return tail;
+   }
+
+   if (tail != m_pHead.load(std::memory_order_acquire))
+      return nullptr;
+
+   push(&m_Stub);
+
+   next = tail->next.load(std::memory_order_acquire);
+
+   if (next) {
+      m_pTail = next;
+      return tail;
+   }
+
+   return nullptr;
+}
+
+///Also false while a producer is in the middle of push()
+template<typename Node>
+bool MpscQueue<Node>::isEmpty() const
+{
+   return !m_pTail->next.load(std::memory_order_acquire)
+      && m_pTail == m_pHead.load(std::memory_order_acquire);
+}
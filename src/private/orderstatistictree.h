@@ -0,0 +1,80 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+#include <QtCore/QHash>
+
+/**
+ * Ordered collection of pointers sorted by a descending key (the most
+ * recent timestamp first) with O(log n) rank lookups.
+ *
+ * It is a treap where each node knows its subtree size and parent, so the
+ * row of a value can be computed without renumbering the other ones when
+ * something is inserted, moved or removed. Equal keys are ordered from the
+ * most recently inserted one.
+ *
+ * The values are not owned.
+ */
+template<typename T>
+class OrderStatisticTree final
+{
+public:
+   explicit OrderStatisticTree();
+   ~OrderStatisticTree();
+
+   //Mutators
+   void insert(T* value, qint64 key);
+   void remove(T* value             );
+   void clear (                     );
+
+   //Getters
+   int  size    (                          ) const;
+   bool contains(T* value                  ) const;
+   int  rank    (const T* value            ) const;
+   T*   at      (int rank                  ) const;
+   int  position(qint64 key                ) const;
+   int  position(const T* value, qint64 key) const;
+
+private:
+   struct Node {
+      T*      value   ;
+      qint64  key     ;
+      quint64 serial  ;
+      quint32 priority;
+      int     size    ;
+      Node*   left    ;
+      Node*   right   ;
+      Node*   parent  ;
+   };
+
+   //Helpers
+   static bool before    (const Node* a, qint64 key, quint64 serial);
+   static int  sizeOf    (const Node* n);
+   static void updateSize(Node* n);
+   void        rotateUp  (Node* n);
+   void        deleteTree(Node* n);
+   quint32     nextPriority();
+
+   //Attributes
+   Node*                 m_pRoot  ;
+   QHash<const T*,Node*> m_hNodes ;
+   quint64               m_Serial ;
+   quint32               m_Seed   ;
+};
+
+#include "orderstatistictree.hpp"
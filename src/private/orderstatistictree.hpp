@@ -0,0 +1,257 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+template<typename T>
+OrderStatisticTree<T>::OrderStatisticTree() : m_pRoot(nullptr), m_Serial(0), m_Seed(2463534242u)
+{
+}
+
+template<typename T>
+OrderStatisticTree<T>::~OrderStatisticTree()
+{
+   deleteTree(m_pRoot);
+}
+
+template<typename T>
+void OrderStatisticTree<T>::deleteTree(Node* n)
+{
+   if (!n)
+      return;
+
+   deleteTree(n->left );
+   deleteTree(n->right);
+   delete n;
+}
+
+template<typename T>
+void OrderStatisticTree<T>::clear()
+{
+   deleteTree(m_pRoot);
+   m_pRoot = nullptr;
+   m_hNodes.clear();
+}
+
+///Xorshift, the priorities only need to be well distributed
+template<typename T>
+quint32 OrderStatisticTree<T>::nextPriority()
+{
+   m_Seed ^= m_Seed << 13;
+   m_Seed ^= m_Seed >> 17;
+   m_Seed ^= m_Seed << 5;
+   return m_Seed;
+}
+
+///Is "a" ordered before an entry with this key and serial
+template<typename T>
+bool OrderStatisticTree<T>::before(const Node* a, qint64 key, quint64 serial)
+{
+   return a->key > key || (a->key == key && a->serial > serial);
+}
+
+template<typename T>
+int OrderStatisticTree<T>::sizeOf(const Node* n)
+{
+   return n ? n->size : 0;
+}
+
+template<typename T>
+void OrderStatisticTree<T>::updateSize(Node* n)
+{
+   n->size = sizeOf(n->left) + sizeOf(n->right) + 1;
+}
+
+///Rotate "n" above its parent, keeping the order
+template<typename T>
+void OrderStatisticTree<T>::rotateUp(Node* n)
+{
+   Node* p = n->parent;
+   Node* g = p->parent;
+
+   if (p->left == n) {
+      p->left = n->right;
+      if (n->right)
+         n->right->parent = p;
+      n->right = p;
+   }
+   else {
+      p->right = n->left;
+      if (n->left)
+         n->left->parent = p;
+      n->left = p;
+   }
+
+   p->parent = n;
+   n->parent = g;
+
+   if (!g)
+      m_pRoot = n;
+   else if (g->left == p)
+      g->left = n;
+   else
+      g->right = n;
+
+   updateSize(p);
+   updateSize(n);
+}
+
+template<typename T>
+void OrderStatisticTree<T>::insert(T* value, qint64 key)
+{
+   Q_ASSERT(!m_hNodes.contains(value));
+
+   Node* n = new Node {value, key, ++m_Serial, nextPriority(), 1, nullptr, nullptr, nullptr};
+   m_hNodes[value] = n;
+
+   if (!m_pRoot) {
+      m_pRoot = n;
+      return;
+   }
+
+   //Regular binary tree insertion
+   Node* p = m_pRoot;
+
+   forever {
+      p->size++;
+
+      Node*& next = before(p, n->key, n->serial) ? p->right : p->left;
+
+      if (!next) {
+         next      = n;
+         n->parent = p;
+         break;
+      }
+
+      p = next;
+   }
+
+   //Restore the heap property of the priorities
+   while (n->parent && n->parent->priority < n->priority)
+      rotateUp(n);
+}
+
+template<typename T>
+void OrderStatisticTree<T>::remove(T* value)
+{
+   Node* n = m_hNodes.take(value);
+
+   if (!n)
+      return;
+
+   //Rotate it down until it has at most one child
+   while (n->left && n->right)
+      rotateUp(n->left->priority > n->right->priority ? n->left : n->right);
+
+   Node* child = n->left ? n->left : n->right;
+
+   if (child)
+      child->parent = n->parent;
+
+   if (!n->parent)
+      m_pRoot = child;
+   else if (n->parent->left == n)
+      n->parent->left = child;
+   else
+      n->parent->right = child;
+
+   for (Node* p = n->parent; p; p = p->parent)
+      p->size--;
+
+   delete n;
+}
+
+template<typename T>
+int OrderStatisticTree<T>::size() const
+{
+   return sizeOf(m_pRoot);
+}
+
+template<typename T>
+bool OrderStatisticTree<T>::contains(T* value) const
+{
+   return m_hNodes.contains(value);
+}
+
+///Return the row of "value" or -1
+template<typename T>
+int OrderStatisticTree<T>::rank(const T* value) const
+{
+   const Node* n = m_hNodes.value(value);
+
+   if (!n)
+      return -1;
+
+   int ret = sizeOf(n->left);
+
+   for (; n->parent; n = n->parent) {
+      if (n->parent->right == n)
+         ret += sizeOf(n->parent->left) + 1;
+   }
+
+   return ret;
+}
+
+template<typename T>
+T* OrderStatisticTree<T>::at(int rank) const
+{
+   const Node* n = m_pRoot;
+
+   while (n) {
+      const int left = sizeOf(n->left);
+
+      if (rank < left)
+         n = n->left;
+      else if (rank == left)
+         return n->value;
+      else {
+         rank -= left + 1;
+         n = n->right;
+      }
+   }
+
+   return nullptr;
+}
+
+///The row a new value with this key would be inserted at
+template<typename T>
+int OrderStatisticTree<T>::position(qint64 key) const
+{
+   int ret = 0;
+
+   for (const Node* n = m_pRoot; n;) {
+      if (before(n, key, m_Serial + 1)) {
+         ret += sizeOf(n->left) + 1;
+         n = n->right;
+      }
+      else
+         n = n->left;
+   }
+
+   return ret;
+}
+
+/**
+ * The row "value" will have once re-inserted with a new key, it doesn't
+ * count the current entry of "value".
+ */
+template<typename T>
+int OrderStatisticTree<T>::position(const T* value, qint64 key) const
+{
+   const Node* n = m_hNodes.value(value);
+
+   return position(key) - ((n && before(n, key, m_Serial + 1)) ? 1 : 0);
+}
@@ -38,6 +38,9 @@ public:
    QString                  m_SecondName          ;
    QString                  m_NickName            ;
    QVariant                 m_vPhoto              ;
+   QByteArray               m_PhotoData           ;
+   QString                  m_PhotoType           ;
+   int                      m_PhotoRevision       ;
    QString                  m_FormattedName       ;
    QString                  m_PreferredEmail      ;
    QString                  m_Organization        ;
@@ -62,10 +65,13 @@ public:
     * containers causing useless increase in memory usage.
    */
 
-   //Cache
-   QString m_CachedFilterString;
+   QString filterString(const Person* p);
 
-   QString filterString();
+   ///Maximum (approximate) size of the decoded photos and thumbnails, in KiB
+   constexpr static const int PHOTO_CACHE_SIZE = 64 * 1024;
+
+   QVariant cachedPhoto(const QSize& size);
+   void     setPhotoRevision();
 
    //Helper code to help handle multiple parents
    QList<Person*> m_lParents;
@@ -18,10 +18,16 @@
 #pragma once
 
 #include <QtCore/QObject>
+#include <QtCore/QMutex>
+
+class QTimer;
+template <class T> class QThreadStorage;
 
 //Ring
 class PhoneDirectoryModel;
 #include "contactmethod.h"
+#include "private/prefixindex.h"
+#include "private/popularityindex.h"
 
 //Internal data structures
 ///@struct NumberWrapper Wrap phone numbers to prevent collisions
@@ -41,8 +47,15 @@ public:
    virtual Qt::ItemFlags flags    ( const QModelIndex& index                                 ) const override;
    virtual bool          setData  ( const QModelIndex& index, const QVariant &value, int role)       override;
 
-   void addRow();
-   void reload();
+   //Notifications from the PopularityIndex
+   void beginInsert(int row          );
+   void endInsert  (                 );
+   void beginRemove(int row          );
+   void endRemove  (                 );
+   void beginMove  (int row, int dest);
+   void endMove    (                 );
+   void beginReset (                 );
+   void endReset   (                 );
 };
 
 class PhoneDirectoryModelPrivate final : public QObject
@@ -76,20 +89,49 @@ public:
    };
 
 
+   /**
+    * Scoped guard deferring the model row insertions while a collection
+    * create many numbers. Only the numbers created by the thread owning the
+    * guard are deferred, a single insertion covering them is emitted when
+    * the outermost guard of that thread is destroyed. It can be used from
+    * the collection loader threads, the insertion is then queued to the
+    * model thread.
+    */
+   class BulkInsertion final {
+   public:
+      explicit BulkInsertion();
+      ~BulkInsertion();
+   private:
+      Q_DISABLE_COPY(BulkInsertion)
+      friend class PhoneDirectoryModelPrivate;
+
+      bool                    m_IsOutermost;
+      QVector<ContactMethod*> m_lNumbers   ;
+   };
+
    //Helpers
+   void registerNumber(ContactMethod* number);
+   static QThreadStorage<BulkInsertion*>& currentBulkInsertion();
+   static void commitBulkInsertion(const QVector<ContactMethod*>& numbers);
    void indexNumber(ContactMethod* number, const QStringList& names   );
    void setAccount (ContactMethod* number,       Account*     account );
    ContactMethod* fillDetails(NumberWrapper* wrap, const URI& strippedUri, Account* account, Person* contact, const QString& type);
+   void scheduleRollover();
 
    //Attributes
    QVector<ContactMethod*>         m_lNumbers         ;
-   QHash<QString,NumberWrapper*> m_hDirectory       ;
-   QVector<ContactMethod*>         m_lPopularityIndex ;
-   QMap<QString,NumberWrapper*>  m_lSortedNames     ;
-   QMap<QString,NumberWrapper*>  m_hSortedNumbers   ;
+   QHash<URI,NumberWrapper*>     m_hDirectory       ;
+   PopularityIndex               m_lPopularityIndex ;
+   PrefixIndex                   m_lSortedNames     ;
+   PrefixIndex                   m_hSortedNumbers   ;
    QHash<QString,NumberWrapper*> m_hNumbersByNames  ;
+   uint                          m_IndexRevision    ;
+   int                           m_VisibleCount     ;
+   QMutex                        m_PendingMutex     ;
+   QVector<ContactMethod*>       m_lPendingNumbers  ;
    bool                          m_CallWithAccount  ;
    MostPopularNumberModel*       m_pPopularModel    ;
+   QTimer*                       m_pRolloverTimer   ;
 
    Q_DECLARE_PUBLIC(PhoneDirectoryModel)
 
@@ -97,6 +139,8 @@ private:
    PhoneDirectoryModel* q_ptr;
 
 private Q_SLOTS:
+   void slotCommitInsertion();
+   void slotRollover();
    void slotCallAdded(Call* call);
    void slotChanged();
    void slotLastUsedChanged(time_t t);
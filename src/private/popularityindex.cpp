@@ -0,0 +1,350 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "popularityindex.h"
+
+//Qt
+#include <QtCore/QAbstractListModel>
+
+//Ring
+#include "contactmethod.h"
+#include "private/phonedirectorymodel_p.h"
+
+//LibStdC++
+#include <algorithm>
+
+PopularityIndex::PopularityIndex(int capacity) : m_Capacity(capacity),
+m_fScore([](const ContactMethod* cm) { return static_cast<qreal>(cm->callCount()); }),
+m_pModel(nullptr)
+{
+}
+
+int PopularityIndex::capacity() const
+{
+   return m_Capacity;
+}
+
+int PopularityIndex::size() const
+{
+   return m_lTop.size();
+}
+
+ContactMethod* PopularityIndex::at(int i) const
+{
+   return m_lTop[i].cm;
+}
+
+///Return the k most popular contact methods, at most capacity()
+QVector<ContactMethod*> PopularityIndex::topK(int k) const
+{
+   const int count = std::min(k, m_lTop.size());
+
+   QVector<ContactMethod*> ret;
+   ret.reserve(count);
+
+   for (int i = 0; i < count; i++)
+      ret << m_lTop[i].cm;
+
+   return ret;
+}
+
+void PopularityIndex::setModel(MostPopularNumberModel* model)
+{
+   m_pModel = model;
+}
+
+///The score of a contact method changed (or it is a new candidate)
+void PopularityIndex::update(ContactMethod* cm)
+{
+   const qreal score = m_fScore(cm);
+   const int   pos   = cm->popularityIndex();
+
+   if (pos >= 0) {
+      const qreal old = m_lTop[pos].score;
+      m_lTop[pos].score = score;
+
+      if (score > old)
+         move(pos, insertPosition(score, pos));
+      else if (score < old) {
+         //Find the last entry still scoring at least as much
+         const auto next = std::partition_point(m_lTop.constBegin() + pos + 1, m_lTop.constEnd(),
+            [score](const Entry& e) { return e.score >= score; });
+         move(pos, (next - m_lTop.constBegin()) - 1);
+      }
+   }
+   else {
+      const auto it = m_hHeapPos.constFind(cm);
+
+      if (it == m_hHeapPos.constEnd())
+         heapPush(Entry {cm, score});
+      else {
+         const int i   = *it;
+         const qreal old = m_lHeap[i].score;
+         m_lHeap[i].score = score;
+
+         if (score > old)
+            siftUp(i);
+         else
+            siftDown(i);
+      }
+   }
+
+   rebalance();
+}
+
+/**
+ * Forget a contact method being destroyed. Only the pointer is used, its
+ * popularityIndex() may not be valid anymore.
+ */
+void PopularityIndex::remove(ContactMethod* cm)
+{
+   const auto it = m_hHeapPos.constFind(cm);
+
+   if (it != m_hHeapPos.constEnd()) {
+      const int i = *it;
+
+      heapSwap(i, m_lHeap.size() - 1);
+      m_lHeap.removeLast();
+      m_hHeapPos.remove(cm);
+
+      if (i < m_lHeap.size()) {
+         siftUp  (i);
+         siftDown(i);
+      }
+
+      return;
+   }
+
+   for (int row = 0; row < m_lTop.size(); row++) {
+      if (m_lTop[row].cm != cm)
+         continue;
+
+      if (m_pModel)
+         m_pModel->beginRemove(row);
+
+      m_lTop.remove(row);
+
+      if (m_pModel)
+         m_pModel->endRemove();
+
+      reindex(row, m_lTop.size() - 1);
+      rebalance();
+
+      return;
+   }
+}
+
+void PopularityIndex::setCapacity(int capacity)
+{
+   m_Capacity = std::max(0, capacity);
+
+   while (m_lTop.size() > m_Capacity)
+      demote();
+
+   rebalance();
+}
+
+///Replace the score function, everything is ranked again
+void PopularityIndex::setScore(const Score& score)
+{
+   m_fScore = score;
+
+   if (m_pModel)
+      m_pModel->beginReset();
+
+   QVector<Entry> all = m_lTop + m_lHeap;
+   m_lTop.clear();
+   m_lHeap.clear();
+   m_hHeapPos.clear();
+
+   for (Entry& e : all) {
+      e.cm->setPopularityIndex(-1);
+      e.score = m_fScore(e.cm);
+   }
+
+   std::stable_sort(all.begin(), all.end(), [](const Entry& a, const Entry& b) {
+      return a.score > b.score;
+   });
+
+   //A sorted array is already a valid heap
+   for (int i = 0; i < all.size(); i++) {
+      if (i < m_Capacity) {
+         all[i].cm->setPopularityIndex(i);
+         m_lTop << all[i];
+      }
+      else {
+         m_hHeapPos[all[i].cm] = m_lHeap.size();
+         m_lHeap << all[i];
+      }
+   }
+
+   if (m_pModel)
+      m_pModel->endReset();
+
+   for (const Entry& e : all)
+      emit e.cm->changed();
+}
+
+///Position of a new entry among [0, end), after the equal ones
+int PopularityIndex::insertPosition(qreal score, int end) const
+{
+   return std::upper_bound(m_lTop.constBegin(), m_lTop.constBegin() + end, score,
+      [](qreal s, const Entry& e) { return s > e.score; }
+   ) - m_lTop.constBegin();
+}
+
+///Keep the top full and better than all candidates
+void PopularityIndex::rebalance()
+{
+   while (m_lTop.size() < m_Capacity && !m_lHeap.isEmpty())
+      promote();
+
+   while ((!m_lTop.isEmpty()) && (!m_lHeap.isEmpty()) && m_lHeap.first().score > m_lTop.last().score) {
+      demote();
+      promote();
+   }
+}
+
+///Move the best candidate to the top
+void PopularityIndex::promote()
+{
+   const Entry e   = heapPop();
+   const int   row = insertPosition(e.score, m_lTop.size());
+
+   if (m_pModel)
+      m_pModel->beginInsert(row);
+
+   m_lTop.insert(row, e);
+
+   if (m_pModel)
+      m_pModel->endInsert();
+
+   reindex(row, m_lTop.size() - 1);
+}
+
+///Move the last top entry back to the candidates
+void PopularityIndex::demote()
+{
+   const int row = m_lTop.size() - 1;
+
+   if (m_pModel)
+      m_pModel->beginRemove(row);
+
+   const Entry e = m_lTop.takeLast();
+
+   if (m_pModel)
+      m_pModel->endRemove();
+
+   e.cm->setPopularityIndex(-1);
+   emit e.cm->changed();
+
+   heapPush(e);
+}
+
+void PopularityIndex::move(int from, int to)
+{
+   if (from == to)
+      return;
+
+   //Qt expects the destination row before the move
+   if (m_pModel)
+      m_pModel->beginMove(from, to > from ? to + 1 : to);
+
+   const Entry e = m_lTop[from];
+   m_lTop.remove(from);
+   m_lTop.insert(to, e);
+
+   if (m_pModel)
+      m_pModel->endMove();
+
+   reindex(std::min(from, to), std::max(from, to));
+}
+
+///Update the popularityIndex() of the shifted entries
+void PopularityIndex::reindex(int first, int last)
+{
+   for (int i = first; i <= last; i++) {
+      if (m_lTop[i].cm->popularityIndex() != i) {
+         m_lTop[i].cm->setPopularityIndex(i);
+         emit m_lTop[i].cm->changed();
+      }
+   }
+}
+
+void PopularityIndex::heapPush(const Entry& e)
+{
+   m_hHeapPos[e.cm] = m_lHeap.size();
+   m_lHeap << e;
+   siftUp(m_lHeap.size() - 1);
+}
+
+PopularityIndex::Entry PopularityIndex::heapPop()
+{
+   const Entry top = m_lHeap.first();
+
+   heapSwap(0, m_lHeap.size() - 1);
+   m_lHeap.removeLast();
+   m_hHeapPos.remove(top.cm);
+
+   if (!m_lHeap.isEmpty())
+      siftDown(0);
+
+   return top;
+}
+
+void PopularityIndex::siftUp(int i)
+{
+   while (i > 0) {
+      const int parent = (i - 1) / 2;
+
+      if (m_lHeap[parent].score >= m_lHeap[i].score)
+         return;
+
+      heapSwap(i, parent);
+      i = parent;
+   }
+}
+
+void PopularityIndex::siftDown(int i)
+{
+   const int size = m_lHeap.size();
+
+   forever {
+      const int left  = 2 * i + 1;
+      const int right = left + 1;
+      int best = i;
+
+      if (left < size && m_lHeap[left].score > m_lHeap[best].score)
+         best = left;
+
+      if (right < size && m_lHeap[right].score > m_lHeap[best].score)
+         best = right;
+
+      if (best == i)
+         return;
+
+      heapSwap(i, best);
+      i = best;
+   }
+}
+
+void PopularityIndex::heapSwap(int a, int b)
+{
+   std::swap(m_lHeap[a], m_lHeap[b]);
+   m_hHeapPos[m_lHeap[a].cm] = a;
+   m_hHeapPos[m_lHeap[b].cm] = b;
+}
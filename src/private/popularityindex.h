@@ -0,0 +1,87 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+#include <QtCore/QVector>
+#include <QtCore/QHash>
+
+//Std
+#include <functional>
+
+class ContactMethod;
+class MostPopularNumberModel;
+
+/**
+ * Ranking of the contact methods by a pluggable score (the call count by
+ * default), only the top K entries are kept sorted.
+ *
+ * The top entries are a sorted vector, their row is the
+ * ContactMethod::popularityIndex(). The other candidates are kept in an
+ * indexed binary max heap so the best one can be promoted in O(log n) when
+ * it overtakes the last top entry.
+ *
+ * The changes are reported to the MostPopularNumberModel as row insertions,
+ * removals and moves.
+ */
+class PopularityIndex final
+{
+public:
+   typedef std::function<qreal(const ContactMethod*)> Score;
+
+   explicit PopularityIndex(int capacity = 10);
+
+   void update     (ContactMethod* cm);
+   void remove     (ContactMethod* cm);
+   void setCapacity(int capacity     );
+   void setScore   (const Score& score);
+   void setModel   (MostPopularNumberModel* model);
+
+   int                     capacity(     ) const;
+   int                     size    (     ) const;
+   ContactMethod*          at      (int i) const;
+   QVector<ContactMethod*> topK    (int k) const;
+
+private:
+   struct Entry {
+      ContactMethod* cm   ;
+      qreal          score;
+   };
+
+   //Top entries helpers
+   void promote  ();
+   void demote   ();
+   void move     (int from, int to);
+   void reindex  (int first, int last);
+   void rebalance();
+   int  insertPosition(qreal score, int end) const;
+
+   //Heap helpers
+   void heapPush  (const Entry& e);
+   Entry heapPop  ();
+   void siftUp    (int i);
+   void siftDown  (int i);
+   void heapSwap  (int a, int b);
+
+   //Attributes
+   int                       m_Capacity;
+   Score                     m_fScore  ;
+   QVector<Entry>            m_lTop    ;
+   QVector<Entry>            m_lHeap   ;
+   QHash<ContactMethod*,int> m_hHeapPos;
+   MostPopularNumberModel*   m_pModel  ;
+};
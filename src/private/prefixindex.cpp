@@ -0,0 +1,91 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "prefixindex.h"
+
+//LibStdC++
+#include <algorithm>
+
+///The key must already be folded, see fold()
+void PrefixIndex::insert(const QString& key, NumberWrapper* value)
+{
+   m_lEntries << Entry {key, value};
+}
+
+void PrefixIndex::clear()
+{
+   m_lEntries.clear();
+   m_Sorted = 0;
+}
+
+int PrefixIndex::size() const
+{
+   merge();
+   return m_lEntries.size();
+}
+
+const PrefixIndex::Entry& PrefixIndex::at(int i) const
+{
+   merge();
+   return m_lEntries[i];
+}
+
+/**
+ * Locate all entries starting with the (folded) prefix, they are in
+ * [begin, end). The range is empty when begin == end.
+ */
+void PrefixIndex::range(const QString& prefix, int& begin, int& end) const
+{
+   merge();
+
+   const auto first = std::lower_bound(m_lEntries.constBegin(), m_lEntries.constEnd(), prefix,
+      [](const Entry& e, const QString& p) {
+         return e.key < p;
+      });
+
+   //All keys starting with the prefix are contiguous and follow lower_bound
+   const auto last = std::partition_point(first, m_lEntries.constEnd(),
+      [&prefix](const Entry& e) {
+         return e.key.startsWith(prefix);
+      });
+
+   begin = first - m_lEntries.constBegin();
+   end   = last  - m_lEntries.constBegin();
+}
+
+QString PrefixIndex::fold(const QString& key)
+{
+   return key.toCaseFolded();
+}
+
+///Sort the pending entries and merge them with the sorted ones
+void PrefixIndex::merge() const
+{
+   if (m_Sorted == m_lEntries.size())
+      return;
+
+   static const auto cmp = [](const Entry& a, const Entry& b) {
+      return a.key < b.key;
+   };
+
+   const auto mid = m_lEntries.begin() + m_Sorted;
+
+   std::sort(mid, m_lEntries.end(), cmp);
+   std::inplace_merge(m_lEntries.begin(), mid, m_lEntries.end(), cmp);
+
+   m_Sorted = m_lEntries.size();
+}
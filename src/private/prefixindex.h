@@ -0,0 +1,59 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+struct NumberWrapper;
+
+/**
+ * Flat, sorted array of case folded keys used for prefix lookups.
+ *
+ * Insertions are appended to an unsorted tail and merged back on the next
+ * lookup, this keep bulk loading linear. A lookup is then two binary searches
+ * that compare the keys in place without allocating temporary strings.
+ *
+ * The keys are implicitly shared with the other PhoneDirectoryModel indexes.
+ */
+class PrefixIndex final
+{
+public:
+   struct Entry {
+      QString        key  ;
+      NumberWrapper* value;
+   };
+
+   //Mutators
+   void insert(const QString& key, NumberWrapper* value);
+   void clear ();
+
+   //Getters
+   int          size    (                                          ) const;
+   const Entry& at      ( int i                                    ) const;
+   void         range   ( const QString& prefix, int& begin, int& end) const;
+
+   //Helper
+   static QString fold(const QString& key);
+
+private:
+   void merge() const;
+
+   mutable QVector<Entry> m_lEntries;
+   mutable int            m_Sorted {0};
+};
@@ -0,0 +1,205 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "searchindex.h"
+
+//Qt
+#include <QtCore/QCoreApplication>
+
+SearchIndex::SearchIndex() : QObject(QCoreApplication::instance()), m_Revision(0), m_MatchRevision(0)
+{
+}
+
+SearchIndex& SearchIndex::instance()
+{
+   static auto index = new SearchIndex();
+   return *index;
+}
+
+///Strip non essential characters like accents from the filter string
+QString SearchIndex::normalize(const QString& raw)
+{
+   const QString decomposed = raw.toLower().normalized(QString::NormalizationForm_KD);
+
+   QString ret;
+   ret.reserve(decomposed.size());
+
+   for (const QChar& c : decomposed) {
+      if (!c.combiningClass())
+         ret += c;
+   }
+
+   return ret;
+}
+
+///Split on everything that is not a letter or a digit
+QStringList SearchIndex::tokenize(const QString& normalized)
+{
+   QStringList ret;
+   int start = -1;
+
+   for (int i = 0; i <= normalized.size(); i++) {
+      const bool isWordChar = i < normalized.size() && normalized[i].isLetterOrNumber();
+
+      if (isWordChar && start == -1)
+         start = i;
+      else if ((!isWordChar) && start != -1) {
+         ret << normalized.mid(start, i - start);
+         start = -1;
+      }
+   }
+
+   ret.removeDuplicates();
+
+   return ret;
+}
+
+/**
+ * Return the normalized filter string of the item, the index is only
+ * updated when the raw string differ from the last one.
+ */
+QString SearchIndex::update(const QObject* item, const QString& raw)
+{
+   auto it = m_hEntries.find(item);
+
+   if (it == m_hEntries.end()) {
+      connect(item, SIGNAL(changed())          , this, SLOT(slotChanged())           );
+      connect(item, SIGNAL(destroyed(QObject*)), this, SLOT(slotDestroyed(QObject*)));
+      it = m_hEntries.insert(item, Entry {QString(), QString(), QStringList(), 0, true});
+   }
+   else if (it->raw == raw) {
+      it->dirty = false;
+      return it->normalized;
+   }
+   else
+      unindex(item, *it);
+
+   it->raw        = raw;
+   it->normalized = normalize(raw);
+   it->tokens     = tokenize(it->normalized);
+   it->revision   = ++m_Revision;
+   it->dirty      = false;
+
+   for (const QString& token : it->tokens)
+      m_hPostings[token] << item;
+
+   return it->normalized;
+}
+
+///If false, the filter role has to be read again before calling matches()
+bool SearchIndex::isFresh(const QObject* item) const
+{
+   const auto it = m_hEntries.constFind(item);
+   return it != m_hEntries.constEnd() && !it->dirty;
+}
+
+///Compute the matching set, the items changed later are checked one by one
+void SearchIndex::setQuery(const QString& query)
+{
+   if (query == m_LastQuery)
+      return;
+
+   m_LastQuery    = query;
+   m_QueryString  = normalize(query);
+   m_lQueryTokens = tokenize(m_QueryString);
+   m_lMatches.clear();
+
+   //An item containing the query contains all its tokens
+   for (int i = 0; i < m_lQueryTokens.size(); i++) {
+      QSet<const QObject*> candidates;
+
+      for (auto it = m_hPostings.constBegin(); it != m_hPostings.constEnd(); ++it) {
+         if (it.key().contains(m_lQueryTokens[i]))
+            candidates.unite(*it);
+      }
+
+      if (i)
+         m_lMatches.intersect(candidates);
+      else
+         m_lMatches = candidates;
+   }
+
+   //Keep the substring semantic, the tokens may be in another order or
+   //have other separators
+   for (auto it = m_lMatches.begin(); it != m_lMatches.end();) {
+      if (m_hEntries[*it].normalized.contains(m_QueryString))
+         ++it;
+      else
+         it = m_lMatches.erase(it);
+   }
+
+   m_MatchRevision = m_Revision;
+}
+
+///If false, matches() can't be used for this query
+bool SearchIndex::canMatch(const QString& query)
+{
+   setQuery(query);
+   return !m_lQueryTokens.isEmpty();
+}
+
+bool SearchIndex::matches(const QObject* item, const QString& query)
+{
+   setQuery(query);
+
+   const auto it = m_hEntries.constFind(item);
+
+   if (it == m_hEntries.constEnd())
+      return false;
+
+   //Updated after the set was computed
+   if (it->revision > m_MatchRevision)
+      return it->normalized.contains(m_QueryString);
+
+   return m_lMatches.contains(item);
+}
+
+void SearchIndex::unindex(const QObject* item, const Entry& entry)
+{
+   for (const QString& token : entry.tokens) {
+      auto it = m_hPostings.find(token);
+
+      if (it == m_hPostings.end())
+         continue;
+
+      it->remove(item);
+
+      if (it->isEmpty())
+         m_hPostings.erase(it);
+   }
+
+   m_lMatches.remove(item);
+}
+
+void SearchIndex::slotChanged()
+{
+   auto it = m_hEntries.find(sender());
+
+   if (it != m_hEntries.end())
+      it->dirty = true;
+}
+
+void SearchIndex::slotDestroyed(QObject* o)
+{
+   const auto it = m_hEntries.find(o);
+
+   if (it == m_hEntries.end())
+      return;
+
+   unindex(o, *it);
+   m_hEntries.erase(it);
+}
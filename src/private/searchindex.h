@@ -0,0 +1,84 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QObject>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QStringList>
+
+/**
+ * Shared full text index of the Call and Person filter strings.
+ *
+ * The filter role of each item provide a raw string, it is normalized
+ * (lower case, NFKD without combining marks) and tokenized only when it
+ * changes. The items are marked dirty when they emit changed() and are
+ * removed when destroyed.
+ *
+ * A query match an item when the normalized query is a substring of the
+ * normalized item string, as QSortFilterProxyModel would do with a fixed
+ * string. The tokens are only used to narrow the candidates: they are shared
+ * by many items (the same peer appear in many calls), so a query only scan
+ * the distinct tokens and the matching set is computed once per filter
+ * string instead of once per row. A query without any token (only
+ * separators) can't be narrowed, canMatch() is then false.
+ */
+class SearchIndex final : public QObject
+{
+   Q_OBJECT
+public:
+   static SearchIndex& instance();
+
+   QString update (const QObject* item, const QString& raw  );
+   bool    isFresh(const QObject* item                      ) const;
+   bool    matches(const QObject* item, const QString& query);
+   bool    canMatch(const QString& query);
+
+   static QString     normalize(const QString& raw       );
+   static QStringList tokenize (const QString& normalized);
+
+private:
+   explicit SearchIndex();
+
+   struct Entry {
+      QString     raw       ;
+      QString     normalized;
+      QStringList tokens    ;
+      quint64     revision  ;
+      bool        dirty     ;
+   };
+
+   //Helpers
+   void unindex(const QObject* item, const Entry& entry);
+   void setQuery(const QString& query);
+
+   //Attributes
+   QHash<const QObject*, Entry>                m_hEntries     ;
+   QHash<QString, QSet<const QObject*> >       m_hPostings    ;
+   quint64                                     m_Revision     ;
+   QString                                     m_LastQuery    ;
+   QString                                     m_QueryString  ;
+   QStringList                                 m_lQueryTokens ;
+   QSet<const QObject*>                        m_lMatches     ;
+   quint64                                     m_MatchRevision;
+
+private Q_SLOTS:
+   void slotChanged  (         );
+   void slotDestroyed(QObject* o);
+};
@@ -35,8 +35,10 @@
 #define CLOCK_REALTIME 0
 #endif
 
-#include <QtCore/QTimer>
 #include <chrono>
+#include <thread>
+#include <atomic>
+#include <memory>
 
 #include "private/videorenderermanager.h"
 #include "video/resolution.h"
@@ -90,18 +92,25 @@ public:
    int        m_fpsC          ;
    int        m_Fps           ;
    TimePoint  m_lastFrameDebug;
-   QTimer*    m_pTimer        ;
+
+   // Frame waiter, each thread has its own stop flag so a stopping waiter
+   // can be joined after a new one started
+   std::thread                        m_Waiter      ;
+   std::shared_ptr<std::atomic_bool>  m_pWaiterActive;
 
    // Constants
-   constexpr static const int FPS_RATE_SEC        = 1  ;
-   constexpr static const int FRAME_CHECK_RATE_HZ = 120;
+   constexpr static const int FPS_RATE_SEC       = 1  ;
+   constexpr static const int WAITER_TIMEOUT_MS  = 100;
 
    // Helpers
-   timespec createTimeout(           );
+   static timespec createTimeout( int ms    );
    bool     shmLock      (           );
    void     shmUnlock    (           );
-   bool     getNewFrame  ( bool wait );
-   bool     remapShm     (           );
+   bool        getNewFrame  (           );
+   bool        remapShm     (           );
+   void        startWaiter  (           );
+   std::thread releaseWaiter(           );
+   void        waitFrames   ( SHMHeader* header, const std::atomic_bool& active );
 
 private:
    Video::ShmRenderer* q_ptr;
@@ -116,7 +125,6 @@ ShmRendererPrivate::ShmRendererPrivate(ShmRenderer* parent)
    , m_pShmArea  ( (SHMHeader*)MAP_FAILED              )
    , m_ShmAreaLen( 0                                   )
    , m_FrameGen  ( 0                                   )
-   , m_pTimer    ( nullptr                             )
 #ifdef DEBUG_FPS
    , m_frameCount( 0                                   )
    , m_lastFrameDebug(std::chrono::system_clock::now() )
@@ -136,33 +144,38 @@ ShmRenderer::ShmRenderer(const QByteArray& id, const QString& shmPath, const QSi
 /// Destructor
 ShmRenderer::~ShmRenderer()
 {
-   if (d_ptr->m_pTimer) {
-      d_ptr->m_pTimer->stop();
-      d_ptr->m_pTimer = nullptr;
-   }
    stopShm();
 }
 
-/// Wait new frame data from shared memory and save pointer
-bool ShmRendererPrivate::getNewFrame(bool wait)
+/// Absolute CLOCK_REALTIME deadline, as expected by sem_timedwait
+timespec ShmRendererPrivate::createTimeout(int ms)
 {
-   if (!shmLock())
-      return false;
+   timespec timeout;
+   ::clock_gettime(CLOCK_REALTIME, &timeout);
 
-   if (m_FrameGen == m_pShmArea->frameGen) {
-      shmUnlock();
+   timeout.tv_sec  += ms / 1000;
+   timeout.tv_nsec += (ms % 1000) * 1000000L;
 
-      if (not wait)
-         return false;
+   if (timeout.tv_nsec >= 1000000000L) {
+      timeout.tv_sec  += 1;
+      timeout.tv_nsec -= 1000000000L;
+   }
 
-      // wait for a new frame, max 33ms
-      static const struct timespec timeout = {0, 33000000};
-      if (::sem_timedwait(&m_pShmArea->frameGenMutex, &timeout) < 0)
-         return false;
+   return timeout;
+}
 
-      if (!shmLock())
-         return false;
+/**
+ * Save the pointer to the latest frame, if any. This never blocks on the
+ * frame generation semaphore, the waiter thread is its only consumer.
+ */
+bool ShmRendererPrivate::getNewFrame()
+{
+   if (!shmLock())
+      return false;
 
+   if (m_FrameGen == m_pShmArea->frameGen) {
+      shmUnlock();
+      return false;
    }
 
    // valid frame to render (daemon may have stopped)?
@@ -236,6 +249,97 @@ bool ShmRendererPrivate::remapShm()
    return true;
 }
 
+/**
+ * Start a thread blocking on the frame generation semaphore. It uses its own
+ * mapping of the header, it is never remapped, so it doesn't need to hold the
+ * renderer mutex.
+ */
+void ShmRendererPrivate::startWaiter()
+{
+   if (m_Waiter.joinable() || m_fd < 0)
+      return;
+
+   SHMHeader* header = (SHMHeader*) ::mmap(nullptr, sizeof(SHMHeader),
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED, m_fd, 0
+   );
+
+   if (header == MAP_FAILED) {
+      qDebug() << "Could not map the frame waiter header: " << strerror(errno);
+      return;
+   }
+
+   auto active = std::make_shared<std::atomic_bool>(true);
+   m_pWaiterActive = active;
+
+   m_Waiter = std::thread([this, header, active]() {
+      waitFrames(header, *active);
+      ::munmap(header, sizeof(SHMHeader));
+   });
+}
+
+/**
+ * Ask the waiter to stop and hand over its thread. The caller must join it
+ * without holding the renderer mutex. The waiter is woken up by an extra post
+ * of the frame generation semaphore, it is the only consumer.
+ */
+std::thread ShmRendererPrivate::releaseWaiter()
+{
+   if (m_pWaiterActive) {
+      *m_pWaiterActive = false;
+
+      if (m_pShmArea != MAP_FAILED)
+         ::sem_post(&m_pShmArea->frameGenMutex);
+   }
+
+   m_pWaiterActive.reset();
+
+   return std::move(m_Waiter);
+}
+
+/**
+ * Emit frameUpdated() once per new frame, runs in the waiter thread. It
+ * sleeps on the frame generation semaphore until the daemon or
+ * releaseWaiter() posts it. The header lock is bounded, if the daemon dies
+ * while holding it, the thread still notices it has to stop.
+ */
+void ShmRendererPrivate::waitFrames(SHMHeader* header, const std::atomic_bool& active)
+{
+   unsigned lastGen = 0;
+
+   while (active) {
+      const timespec timeout = createTimeout(WAITER_TIMEOUT_MS);
+
+      if (::sem_timedwait(&header->mutex, &timeout) < 0) {
+         if (errno == EINTR || errno == ETIMEDOUT)
+            continue;
+
+         qDebug() << "The frame waiter could not lock the shared memory: " << strerror(errno);
+         break;
+      }
+
+      const unsigned gen  = header->frameGen;
+      const unsigned size = header->frameSize;
+
+      ::sem_post(&header->mutex);
+
+      // The daemon may have stopped, in which case there is nothing to render
+      if (gen != lastGen && size) {
+         lastGen = gen;
+         emit q_ptr->frameUpdated();
+      }
+
+      // Idle streams don't wake up until the next frame or the shutdown
+      int ret;
+      while ((ret = ::sem_wait(&header->frameGenMutex)) < 0 && errno == EINTR);
+
+      if (ret < 0) {
+         qDebug() << "The frame waiter could not wait for a frame: " << strerror(errno);
+         break;
+      }
+   }
+}
+
 /// Connect to the shared memory
 bool ShmRenderer::startShm()
 {
@@ -274,10 +378,11 @@ void ShmRenderer::stopShm()
    if (d_ptr->m_fd < 0)
       return;
 
-   if (d_ptr->m_pTimer) {
-      d_ptr->m_pTimer->stop();
-      d_ptr->m_pTimer = nullptr;
-   }
+   // Only reached with a running waiter from the destructor, stopRendering()
+   // joins it after releasing the renderer mutex
+   std::thread waiter = d_ptr->releaseWaiter();
+   if (waiter.joinable())
+      waiter.join();
 
    // reset the frame so it doesn't point to an old value
    Video::Renderer::d_ptr->m_pFrame.reset();
@@ -297,10 +402,15 @@ void ShmRenderer::stopShm()
    d_ptr->m_pShmArea = (SHMHeader*) MAP_FAILED;
 }
 
-/// Lock the memory while the copy is being made
+/// Lock the memory while the copy is being made, give up if the daemon hang
 bool ShmRendererPrivate::shmLock()
 {
-   return ::sem_wait(&m_pShmArea->mutex) >= 0;
+   const timespec timeout = createTimeout(WAITER_TIMEOUT_MS);
+
+   int ret;
+   while ((ret = ::sem_timedwait(&m_pShmArea->mutex, &timeout)) < 0 && errno == EINTR);
+
+   return ret >= 0;
 }
 
 /// Remove the lock, allow a new frame to be drawn
@@ -325,15 +435,7 @@ void ShmRenderer::startRendering()
 
    Video::Renderer::d_ptr->m_isRendering = true;
 
-   if (!d_ptr->m_pTimer) {
-      d_ptr->m_pTimer = new QTimer(this);
-      d_ptr->m_pTimer->setInterval(33);
-      connect(d_ptr->m_pTimer,&QTimer::timeout,[this]() {
-         emit this->frameUpdated();
-      });
-   }
-   //FIXME This is a temporary hack as frameUpdated() is no longer emitted
-   d_ptr->m_pTimer->start();
+   d_ptr->startWaiter();
 
    emit started();
 }
@@ -341,15 +443,18 @@ void ShmRenderer::startRendering()
 /// Stop the rendering loop
 void ShmRenderer::stopRendering()
 {
-   QMutexLocker locker {mutex()};
-   Video::Renderer::d_ptr->m_isRendering = false;
+   std::thread waiter;
+
+   {
+      QMutexLocker locker {mutex()};
+      Video::Renderer::d_ptr->m_isRendering = false;
 
-   if (d_ptr->m_pTimer) {
-      d_ptr->m_pTimer->stop();
-      d_ptr->m_pTimer = nullptr;
+      waiter = d_ptr->releaseWaiter();
+      stopShm();
    }
 
-   stopShm();
+   if (waiter.joinable())
+      waiter.join();
 }
 
 /*****************************************************************************
@@ -371,7 +476,7 @@ Frame ShmRenderer::currentFrame() const
         return {};
 
     QMutexLocker lk {mutex()};
-    if (d_ptr->getNewFrame(false)) {
+    if (d_ptr->getNewFrame()) {
         if (auto frame_ptr = Video::Renderer::d_ptr->m_pFrame)
             return std::move(*frame_ptr);
     }
@@ -31,6 +31,8 @@
 #include <categorizedhistorymodel.h>
 #include <globalinstances.h>
 #include <interfaces/pixmapmanipulatori.h>
+#include <itemdataroles.h>
+#include "searchindex.h"
 
 namespace CategoryModelCommon {
    inline Qt::ItemFlags flags(const QModelIndex& idx) {
@@ -106,6 +108,29 @@ bool RemoveDisabledProxy::filterAcceptsRow ( int source_row, const QModelIndex &
    else if (!source_parent.isValid() || source_parent.parent().isValid())
       return true;
 
+   const QRegExp& filter = filterRegExp();
+
+   if (filter.isEmpty())
+      return true;
+
+   //Plain text filters are answered by the search index, regexes are not.
+   //The items and the query are both normalized (lower case, no accents),
+   //then the query has to be a substring of the item, like a fixed string.
+   static const QRegExp special(QStringLiteral("[\\\\^$.*+?()\\[\\]{}|]"));
+
+   if ((filter.patternSyntax() == QRegExp::FixedString || special.indexIn(filter.pattern()) == -1)
+    && filter.caseSensitivity() == Qt::CaseInsensitive && SearchIndex::instance().canMatch(filter.pattern())) {
+      const QModelIndex idx = sourceModel()->index(source_row, filterKeyColumn(), source_parent);
+
+      if (auto item = qvariant_cast<QObject*>(idx.data(static_cast<int>(Ring::Role::Object)))) {
+         //Reading the filter role updates the index
+         if (!SearchIndex::instance().isFresh(item))
+            idx.data(filterRole());
+
+         return SearchIndex::instance().matches(item, filter.pattern());
+      }
+   }
+
    return QSortFilterProxyModel::filterAcceptsRow(source_row, source_parent);
 }
 
@@ -0,0 +1,230 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "standindaemon.h"
+
+//Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QTextStream>
+#include <QtCore/QTimer>
+
+//Ring
+#include "dbus/configurationmanager.h"
+#include "private/call_p.h"
+#include "qtwrapper/standin/standin.h"
+
+static const char STANDIN_VIDEO[] = "standin-video";
+
+StandInDaemon::StandInDaemon() : QObject(QCoreApplication::instance()),
+m_CallCounter(0), m_MessageCounter(0), m_PresenceCounter(0), m_IsDecoding(false), m_IsRunning(false)
+{
+   static const char* slots[] = {
+      SLOT(slotIncomingCall()),
+      SLOT(slotStateChange ()),
+      SLOT(slotMessage     ()),
+      SLOT(slotPresence    ()),
+      SLOT(slotVideo       ()),
+      SLOT(slotFrame       ()),
+   };
+
+   for (int i = 0; i < static_cast<int>(Event::COUNT__); i++) {
+      m_lTimers[i] = new QTimer(this);
+      m_lRates [i] = 0;
+      connect(m_lTimers[i], SIGNAL(timeout()), this, slots[i]);
+   }
+}
+
+StandInDaemon& StandInDaemon::instance()
+{
+   static auto daemon = new StandInDaemon();
+   return *daemon;
+}
+
+///Load a script, return false if it cannot be read or has invalid lines
+bool StandInDaemon::load(const QString& path)
+{
+   static const QHash<QString, Event> events {
+      { QStringLiteral("incoming_call"), Event::INCOMING_CALL },
+      { QStringLiteral("state_change" ), Event::STATE_CHANGE  },
+      { QStringLiteral("message"      ), Event::MESSAGE       },
+      { QStringLiteral("presence"     ), Event::PRESENCE      },
+      { QStringLiteral("video"        ), Event::VIDEO         },
+      { QStringLiteral("frame"        ), Event::FRAME         },
+   };
+
+   QFile file(path);
+
+   if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+      qWarning() << "Cannot open the stand-in daemon script" << path;
+      return false;
+   }
+
+   QTextStream stream(&file);
+   bool ret = true;
+
+   while (!stream.atEnd()) {
+      const QString line = stream.readLine().trimmed();
+
+      if (line.isEmpty() || line[0] == '#')
+         continue;
+
+      const QStringList fields = line.split(' ', QString::SkipEmptyParts);
+
+      bool ok = fields.size() == 2;
+
+      if (ok && fields[0] == QLatin1String("account"))
+         setAccountId(fields[1]);
+      else if (ok && events.contains(fields[0])) {
+         const qreal rate = fields[1].toDouble(&ok);
+
+         if (ok)
+            setRate(events[fields[0]], rate);
+      }
+      else
+         ok = false;
+
+      if (!ok) {
+         qWarning() << "Invalid stand-in daemon script line:" << line;
+         ret = false;
+      }
+   }
+
+   return ret;
+}
+
+///Set how many events of that type are emitted per second, 0 to disable
+void StandInDaemon::setRate(Event event, qreal perSecond)
+{
+   const int i = static_cast<int>(event);
+
+   m_lRates[i] = qMax<qreal>(0, perSecond);
+
+   m_lTimers[i]->stop();
+
+   if (m_IsRunning && m_lRates[i] > 0) {
+      m_lTimers[i]->setInterval(qMax(1, qRound(1000 / m_lRates[i])));
+      m_lTimers[i]->start();
+   }
+}
+
+void StandInDaemon::setAccountId(const QString& accountId)
+{
+   m_AccountId = accountId;
+}
+
+void StandInDaemon::start()
+{
+   if (m_AccountId.isEmpty()) {
+      const QStringList accounts = ConfigurationManager::instance().getAccountList();
+
+      if (!accounts.isEmpty())
+         m_AccountId = accounts.first();
+   }
+
+   m_IsRunning = true;
+
+   for (int i = 0; i < static_cast<int>(Event::COUNT__); i++)
+      setRate(static_cast<Event>(i), m_lRates[i]);
+}
+
+void StandInDaemon::stop()
+{
+   m_IsRunning = false;
+
+   for (QTimer* t : m_lTimers)
+      t->stop();
+}
+
+void StandInDaemon::slotIncomingCall()
+{
+   const std::string callId = StandIn::incomingCall(m_AccountId.toStdString(),
+      QStringLiteral("sip:standin%1@localhost").arg(++m_CallCounter).toStdString()
+   );
+
+   m_lCalls << QString::fromStdString(callId);
+}
+
+/**
+ * Move the oldest synthetic call to its next state, the calls go through
+ * INCOMING -> CURRENT -> HOLD -> CURRENT -> HUNGUP -> OVER
+ */
+void StandInDaemon::slotStateChange()
+{
+   static const QHash<int, const char*> sequence {
+      { 0, CallPrivate::StateChange::CURRENT },
+      { 1, CallPrivate::StateChange::HOLD    },
+      { 2, CallPrivate::StateChange::CURRENT },
+      { 3, CallPrivate::StateChange::HUNG_UP },
+      { 4, CallPrivate::StateChange::OVER    },
+   };
+
+   if (m_lCalls.isEmpty())
+      return;
+
+   const QString callId = m_lCalls.first();
+   const int     step   = m_hSteps[callId]++;
+
+   //Does nothing if the call was already hung up by the client
+   StandIn::setCallState(callId.toStdString(), sequence[step]);
+
+   if (step + 1 == sequence.size()) {
+      m_hSteps.remove(callId);
+      m_lCalls.removeFirst();
+   }
+   else
+      m_lCalls << m_lCalls.takeFirst();
+}
+
+void StandInDaemon::slotMessage()
+{
+   StandIn::accountMessage(m_AccountId.toStdString(),
+      QStringLiteral("sip:standin%1@localhost").arg(m_MessageCounter % 16).toStdString(),
+      {{ "text/plain", QStringLiteral("Stand-in message %1").arg(m_MessageCounter).toStdString() }}
+   );
+
+   m_MessageCounter++;
+}
+
+void StandInDaemon::slotPresence()
+{
+   StandIn::buddyNotification(m_AccountId.toStdString(),
+      QStringLiteral("sip:standin%1@localhost").arg(m_PresenceCounter % 16).toStdString(),
+      m_PresenceCounter % 2, std::string()
+   );
+
+   m_PresenceCounter++;
+}
+
+void StandInDaemon::slotVideo()
+{
+   if (m_IsDecoding)
+      StandIn::stopDecoding(STANDIN_VIDEO);
+   else
+      StandIn::startDecoding(STANDIN_VIDEO, 640, 480);
+
+   m_IsDecoding = !m_IsDecoding;
+}
+
+///Only reach the renderer once it registered its sink
+void StandInDaemon::slotFrame()
+{
+   if (m_IsDecoding)
+      StandIn::pushFrame(STANDIN_VIDEO);
+}
@@ -0,0 +1,89 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+class QTimer;
+
+//Ring
+#include <typedefs.h>
+
+/**
+ * Generate synthetic daemon events at configurable rates.
+ *
+ * The events go through the stand-in daemon (src/qtwrapper/standin), the
+ * fake DRing implementation the library is linked with when built with
+ * ENABLE_STANDIN_DAEMON. The CallManager, ConfigurationManager,
+ * PresenceManager and VideoManager interfaces then receive the callbacks
+ * and answer the queries (call details, accounts) like with a real daemon.
+ *
+ * This allows to load the models (calls, history, presence, renderers) in a
+ * reproducible way, offline and without a remote party.
+ *
+ * A script is a list of "<event> <per second>" lines, "account <id>" selects
+ * the account the events are attached to. Lines starting with # are ignored.
+ * The script path is read from the RING_STANDIN_SCRIPT environment variable.
+ */
+class StandInDaemon final : public QObject
+{
+   Q_OBJECT
+public:
+   enum class Event {
+      INCOMING_CALL, /*!< A new incoming call           */
+      STATE_CHANGE , /*!< The next state of a live call */
+      MESSAGE      , /*!< An account text message       */
+      PRESENCE     , /*!< A buddy presence change       */
+      VIDEO        , /*!< A decoder start or stop       */
+      FRAME        , /*!< A frame of the running decoder*/
+      COUNT__
+   };
+
+   static StandInDaemon& instance();
+
+   bool load   (const QString& path              );
+   void setRate(Event event, qreal perSecond     );
+   void setAccountId(const QString& accountId    );
+   void start  (                                 );
+   void stop   (                                 );
+
+private:
+   explicit StandInDaemon();
+
+   //Attributes
+   QTimer*     m_lTimers[static_cast<int>(Event::COUNT__)];
+   qreal       m_lRates [static_cast<int>(Event::COUNT__)];
+   QStringList m_lCalls          ;
+   QHash<QString,int> m_hSteps   ; ///< The next state of each call
+   QString     m_AccountId       ;
+   int         m_CallCounter     ;
+   int         m_MessageCounter  ;
+   int         m_PresenceCounter ;
+   bool        m_IsDecoding      ;
+   bool        m_IsRunning    ;
+
+private Q_SLOTS:
+   void slotIncomingCall();
+   void slotStateChange ();
+   void slotMessage     ();
+   void slotPresence    ();
+   void slotVideo       ();
+   void slotFrame       ();
+};
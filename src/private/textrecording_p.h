@@ -22,6 +22,9 @@
 #include <QtCore/QRegExp>
 #include <QtCore/QRegularExpression>
 
+//Std
+#include <functional>
+
 //Daemon
 #include <account_const.h>
 
@@ -46,6 +49,9 @@ namespace Media {
  */
 namespace Serializable {
 
+class Group;
+class Peers;
+
 class Payload {
 public:
    QString payload;
@@ -80,6 +86,8 @@ public:
    uint64_t                id        ;
    //Delivery Status
    Media::TextRecording::Status deliveryStatus;
+   ///The group this message belongs to
+   Group*                  group     {nullptr};
 
    static const QRegularExpression m_linkRegex;
 
@@ -122,10 +130,13 @@ public:
    QString nextGroupSha1;
    ///This is the group identifier in the file described by `nextGroupSha1`
    int nextGroupId;
+   ///The file this group belongs to
+   Peers* peers {nullptr};
    ///The account used for this conversation
 
-   void read (const QJsonObject &json, const QHash<QString,ContactMethod*> sha1s);
-   void write(QJsonObject       &json) const;
+   void read       (const QJsonObject &json, const QHash<QString,ContactMethod*> sha1s);
+   void write      (QJsonObject       &json) const;
+   void writeHeader(QJsonObject       &json) const;
 };
 
 class Peers {
@@ -142,14 +153,29 @@ public:
    ///This attribute store if the file has changed
    bool hasChanged;
 
+   ///If a snapshot of this file exist on the disk
+   bool isStored;
+
+   ///The number of journal records since the last snapshot (including pending ones)
+   int journalSize;
+
+   ///The journal records not yet appended to the disk
+   QByteArray journal;
+
    ///Keep a cache of the peers sha1
    QHash<QString,ContactMethod*> m_hSha1;
 
-   void read (const QJsonObject &json);
-   void write(QJsonObject       &json) const;
+   void read      (const QJsonObject &json);
+   void readGroups(const QJsonObject &json);
+   void write     (QJsonObject       &json) const;
+
+   //Journal
+   void journalGroup  (Group*   g);
+   void journalMessage(Message* m);
+   int  messageCount  () const;
 
 private:
-   Peers() : hasChanged(false) {}
+   Peers() : hasChanged(false),isStored(false),journalSize(0) {}
 };
 
 }
@@ -178,9 +204,21 @@ public:
    QAbstractItemModel*         m_pUnreadTextMessagesModel {nullptr};
    QHash<uint64_t, TextMessageNode*> m_hPendingMessages;
 
+   /**
+    * Conversations indexed at startup only know their peers and a summary.
+    * The messages are loaded by `m_fLoader` the first time they are needed
+    * and can be evicted again when the conversation goes cold.
+    */
+   bool                        m_IsLoaded           {true};
+   int                         m_MessageCount       {0};
+   std::function<QJsonObject(TextRecording*)> m_fLoader;
+
    //Helper
+   void load();
+   bool evict();
+   bool isInUse() const;
+   void reconstruct(const ContactMethod* cm);
    void insertNewMessage(const QMap<QString,QString>& message, ContactMethod* cm, Media::Media::Direction direction, uint64_t id = 0);
-   QHash<QByteArray,QByteArray> toJsons() const;
    void accountMessageStatusChanged(const uint64_t id, DRing::Account::MessageStates status);
    bool updateMessageStatus(Serializable::Message* m, TextRecording::Status status);
 
@@ -245,7 +283,14 @@ public:
    //Attributes
    Media::TextRecording* m_pRecording;
 
+   //Lazy loading
+   virtual bool canFetchMore(const QModelIndex& parent) const override;
+   virtual void fetchMore   (const QModelIndex& parent)       override;
+
    //Helper
    void addRowBegin();
    void addRowEnd();
+   void resetBegin();
+   void resetEnd();
+   bool isInUse(int proxies) const;
 };
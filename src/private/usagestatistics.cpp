@@ -0,0 +1,123 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "usagestatistics.h"
+
+//LibStdC++
+#include <algorithm>
+
+///Count a call, calls older than a trimester are ignored
+void UsageStatistics::add(time_t timestamp)
+{
+   const qint64 now = today();
+
+   if (m_lDays.isEmpty()) {
+      m_lDays.fill(0, TRIMESTER_DAYS);
+      m_Day = now;
+   }
+   else
+      rollover(now);
+
+   //Timestamps in the future (clock skew) are counted as today
+   const qint64 age = std::max<qint64>(0, now - timestamp / DAY_SECONDS);
+
+   if (age >= TRIMESTER_DAYS)
+      return;
+
+   m_lDays[(now - age) % TRIMESTER_DAYS]++;
+   m_TrimCount++;
+
+   if (age < WEEK_DAYS)
+      m_WeekCount++;
+}
+
+uint UsageStatistics::weekCount() const
+{
+   rollover(today());
+   return m_WeekCount;
+}
+
+uint UsageStatistics::trimCount() const
+{
+   rollover(today());
+   return m_TrimCount;
+}
+
+///Move the window to the current day, return true if the counters changed
+bool UsageStatistics::rollover() const
+{
+   return rollover(today());
+}
+
+bool UsageStatistics::rollover(qint64 day) const
+{
+   if (m_lDays.isEmpty() || day <= m_Day)
+      return false;
+
+   const uint week = m_WeekCount;
+   const uint trim = m_TrimCount;
+
+   if (day - m_Day >= TRIMESTER_DAYS) {
+      m_lDays.fill(0);
+      m_WeekCount = 0;
+      m_TrimCount = 0;
+   }
+   else {
+      for (qint64 d = m_Day + 1; d <= day; d++) {
+         m_WeekCount -= m_lDays[(d - WEEK_DAYS) % TRIMESTER_DAYS];
+
+         //The slot of the new day is the one leaving the trimester
+         uint& slot = m_lDays[d % TRIMESTER_DAYS];
+         m_TrimCount -= slot;
+         slot = 0;
+      }
+   }
+
+   m_Day = day;
+
+   return week != m_WeekCount || trim != m_TrimCount;
+}
+
+///Merge the histogram of a contact method into the one of its account
+UsageStatistics& UsageStatistics::operator+=(const UsageStatistics& other)
+{
+   if (other.m_lDays.isEmpty())
+      return *this;
+
+   const qint64 now = today();
+
+   if (m_lDays.isEmpty()) {
+      m_lDays.fill(0, TRIMESTER_DAYS);
+      m_Day = now;
+   }
+
+   rollover(now);
+   other.rollover(now);
+
+   for (int i = 0; i < TRIMESTER_DAYS; i++)
+      m_lDays[i] += other.m_lDays[i];
+
+   m_WeekCount += other.m_WeekCount;
+   m_TrimCount += other.m_TrimCount;
+
+   return *this;
+}
+
+qint64 UsageStatistics::today()
+{
+   return ::time(nullptr) / DAY_SECONDS;
+}
@@ -0,0 +1,61 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+#include <QtCore/QVector>
+
+//Std
+#include <time.h>
+
+/**
+ * Per day call histogram used for the week and trimester statistics.
+ *
+ * The days are kept in a ring buffer indexed by the UTC day number. The two
+ * counters are running sums updated when a call is added and when the
+ * oldest days leave their window, so the queries are O(1). The rollover
+ * happens lazily on the first access of a new day, it costs at most one
+ * step per elapsed day.
+ *
+ * The buffer is only allocated when the first call is added.
+ */
+class UsageStatistics final
+{
+public:
+   constexpr static const int    WEEK_DAYS      = 7       ;
+   constexpr static const int    TRIMESTER_DAYS = 7 * 15  ;
+   constexpr static const qint64 DAY_SECONDS    = 3600 * 24;
+
+   void add(time_t timestamp);
+
+   uint weekCount() const;
+   uint trimCount() const;
+
+   bool rollover() const;
+
+   UsageStatistics& operator+=(const UsageStatistics& other);
+
+   static qint64 today();
+
+private:
+   bool rollover(qint64 day) const;
+
+   mutable QVector<uint> m_lDays        ;
+   mutable qint64        m_Day       {0};
+   mutable uint          m_WeekCount {0};
+   mutable uint          m_TrimCount {0};
+};
@@ -25,6 +25,15 @@
 #include <QtCore/QUrl>
 #include <QtCore/QMimeData>
 #include <QtCore/QMutex>
+#include <QtCore/QQueue>
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
+#include <QtCore/QWaitCondition>
+#include <QtCore/QVector>
+
+//Std
+#include <cstring>
+#include <memory>
 
 //Ring
 #include "phonedirectorymodel.h"
@@ -33,6 +42,7 @@
 #include "globalinstances.h"
 #include "interfaces/pixmapmanipulatori.h"
 #include "personmodel.h"
+#include "private/phonedirectorymodel_p.h"
 
 /* https://www.ietf.org/rfc/rfc2045.txt
  * https://www.ietf.org/rfc/rfc2047.txt
@@ -60,10 +70,14 @@ struct VCardMapper;
 
 typedef void (VCardMapper:: *mapToProperty)(Person*, const QString&, const QByteArray&);
 
+/**
+ * Only scan() can run in parallel, the mapper itself sets the properties of
+ * Person objects and must be used by their thread. apply() touches shared
+ * state (the PhoneDirectoryModel), it is serialized and should be called once
+ * per batch.
+ */
 struct VCardMapper final {
 
-   QHash<QByteArray, mapToProperty> m_hHash;
-
    // Calling getNumber before the Contact is finalized will create duplicates
    struct GetNumberFuture {
       QByteArray uri;
@@ -74,15 +88,19 @@ struct VCardMapper final {
    QHash<Person*, QList<GetNumberFuture> > m_hDelayedCMInserts;
    static QMutex* m_pMutex;
 
-   VCardMapper() {
-      m_hHash[VCardUtils::Property::UID] = &VCardMapper::setUid;
-      m_hHash[VCardUtils::Property::NAME] = &VCardMapper::setNames;
-      m_hHash[VCardUtils::Property::FORMATTED_NAME] = &VCardMapper::setFormattedName;
-      m_hHash[VCardUtils::Property::EMAIL] = &VCardMapper::setEmail;
-      m_hHash[VCardUtils::Property::ORGANIZATION] = &VCardMapper::setOrganization;
-      m_hHash[VCardUtils::Property::TELEPHONE] = &VCardMapper::addContactMethod;
-      m_hHash[VCardUtils::Property::ADDRESS] = &VCardMapper::addAddress;
-      m_hHash[VCardUtils::Property::PHOTO] = &VCardMapper::setPhoto;
+   ///The property setters, shared by all mappers
+   static const QHash<QByteArray, mapToProperty>& setters() {
+      static const QHash<QByteArray, mapToProperty> hash {
+         { VCardUtils::Property::UID           , &VCardMapper::setUid           },
+         { VCardUtils::Property::NAME          , &VCardMapper::setNames         },
+         { VCardUtils::Property::FORMATTED_NAME, &VCardMapper::setFormattedName },
+         { VCardUtils::Property::EMAIL         , &VCardMapper::setEmail         },
+         { VCardUtils::Property::ORGANIZATION  , &VCardMapper::setOrganization  },
+         { VCardUtils::Property::TELEPHONE     , &VCardMapper::addContactMethod },
+         { VCardUtils::Property::ADDRESS       , &VCardMapper::addAddress       },
+         { VCardUtils::Property::PHOTO         , &VCardMapper::setPhoto         },
+      };
+      return hash;
    }
 
    void apply() {
@@ -90,6 +108,9 @@ struct VCardMapper final {
       // it is done at the end to make sure UID has been set and all CMs
       // are there at once not to mess PhoneDirectoryModel detection
 
+      if (m_hDelayedCMInserts.isEmpty())
+         return;
+
       QMutexLocker locker(m_pMutex);
 
       for (QHash<Person*, QList<GetNumberFuture>>::iterator i = m_hDelayedCMInserts.begin(); i != m_hDelayedCMInserts.end(); ++i) {
@@ -140,8 +161,8 @@ struct VCardMapper final {
          break;
       }
 
-      QVariant photo = GlobalInstances::pixmapManipulator().personPhoto(fn,type);
-      c->setPhoto(photo);
+      //The photo is decoded by the Person the first time it is displayed
+      c->setPhotoData(fn, QString::fromLatin1(type));
    }
 
    void addContactMethod(Person* c, const QString& key, const QByteArray& fn) {
@@ -189,36 +210,193 @@ struct VCardMapper final {
    }
 
    bool metacall(Person* c, const QByteArray& key, const QByteArray& value) {
-      const QStringList settings = QString(key).split(';');
-      if (settings.length() < 1)
-         return false;
+      //The parameters (after the first ';') are not part of the lookup
+      const int paramPos = key.indexOf(';');
+      const QByteArray name = QByteArray::fromRawData(key.constData(), paramPos == -1 ? key.size() : paramPos);
+
+      const mapToProperty setter = setters().value(name);
 
-      if (!m_hHash[settings[0].toLatin1()]) {
+      if (!setter) {
          if(key.contains(VCardUtils::Property::PHOTO)) {
             //key must contain additional attributes, we don't need them right now (ENCODING, TYPE...)
-            setPhoto(c, key, value);
+            setPhoto(c, QString::fromUtf8(key), value);
             return true;
          }
 
          if(key.contains(VCardUtils::Property::ADDRESS)) {
-            addAddress(c, key, value);
+            addAddress(c, QString::fromUtf8(key), value);
             return true;
          }
 
          if(key.contains(VCardUtils::Property::TELEPHONE)) {
-            addContactMethod(c, key, value);
+            addContactMethod(c, QString::fromUtf8(key), value);
             return true;
          }
 
          return false;
       }
-      (this->*(m_hHash[settings[0].toLatin1()]))(c,key,value);
+      (this->*setter)(c,QString::fromUtf8(key),value);
       return true;
    }
+
+   /**
+    * Split a vCard into its properties. The lines are scanned in place, keys
+    * are passed as views on `all` and only the (trimmed) values are copied,
+    * once. Folded values (lines starting with a space) are concatenated.
+    *
+    * It only touches its arguments, it is safe to use from any thread.
+    */
+   template<typename F>
+   static void scan(const QByteArray& all, F property) {
+      const char* data = all.constData();
+      const int   size = all.size();
+
+      int        keyBegin(-1), keyEnd(-1), valueBegin(-1), valueEnd(-1);
+      QByteArray folded;
+
+      //Same as QByteArray::trimmed()
+      const auto isSpace = [](char c) {
+         return c == ' ' || (c >= '\t' && c <= '\r');
+      };
+
+      const auto flush = [&]() {
+         if (keyEnd <= keyBegin)
+            return;
+
+         const QByteArray key = QByteArray::fromRawData(data + keyBegin, keyEnd - keyBegin);
+
+         if (folded.isEmpty()) {
+            while (valueBegin < valueEnd && isSpace(data[valueBegin  ])) valueBegin++;
+            while (valueEnd > valueBegin && isSpace(data[valueEnd - 1])) valueEnd--;
+            property(key, QByteArray(data + valueBegin, valueEnd - valueBegin));
+         }
+         else
+            property(key, folded.trimmed());
+
+         folded.clear();
+      };
+
+      for (int lineBegin = 0; lineBegin < size;) {
+         int lineEnd = all.indexOf('\n', lineBegin);
+         if (lineEnd == -1)
+            lineEnd = size;
+
+         //Ignore empty lines
+         if (lineEnd > lineBegin) {
+            //Some properties are over multiple lines
+            if (data[lineBegin] == ' ' && keyEnd > keyBegin) {
+               if (folded.isEmpty())
+                  folded = QByteArray(data + valueBegin, valueEnd - valueBegin);
+               folded.append(data + lineBegin + 1, lineEnd - lineBegin - 1);
+            }
+            else {
+               flush();
+
+               //Do not use split, URIs can have : in them
+               const char* colon  = static_cast<const char*>(memchr(data + lineBegin, ':', lineEnd - lineBegin));
+               const int   dblpt  = colon ? static_cast<int>(colon - data) : lineBegin - 1;
+
+               keyBegin   = lineBegin;
+               keyEnd     = qMax(lineBegin, dblpt);
+               valueBegin = dblpt + 1;
+               valueEnd   = lineEnd;
+            }
+         }
+
+         lineBegin = lineEnd + 1;
+      }
+
+      //The last property is always END:VCARD
+   }
+
+   ///Map the properties of a vCard, `p` must belong to the calling thread
+   void parse(Person* p, const QByteArray& all, QList<Account*>* accounts) {
+      scan(all, [this, p, accounts](const QByteArray& key, const QByteArray& value) {
+         //Link with accounts
+         if (accounts && key == VCardUtils::Property::X_RINGACCOUNT) {
+            Account* a = AccountModel::instance().getById(value,true);
+            if(!a)
+               qDebug() << "Could not find account: " << value;
+            else
+               (*accounts) << a;
+         }
+
+         metacall(p, key, value);
+      });
+   }
 };
 
 QMutex* VCardMapper::m_pMutex = new QMutex();
-static VCardMapper* vc_mapper = new VCardMapper;
+
+///The properties of a vCard file, parsed in a pool thread
+struct VCardData {
+   QString                                  path      ;
+   QVector< QPair<QByteArray, QByteArray> > properties;
+};
+
+///A slice of a directory parsed by a VCardLoadTask
+typedef QVector<VCardData> VCardBatch;
+
+///The parsed batches, ready to be merged by the loading thread
+struct VCardBatchQueue {
+   QMutex              mutex    ;
+   QWaitCondition      condition;
+   QQueue<VCardBatch*> batches  ;
+
+   void push(VCardBatch* batch) {
+      QMutexLocker locker(&mutex);
+      batches.enqueue(batch);
+      condition.wakeOne();
+   }
+
+   VCardBatch* pop() {
+      QMutexLocker locker(&mutex);
+      while (batches.isEmpty())
+         condition.wait(&mutex);
+      return batches.dequeue();
+   }
+};
+
+/**
+ * Read and split a slice of the vCard files. It only produces plain data,
+ * the Person objects are created by the loading thread.
+ */
+class VCardLoadTask final : public QRunnable
+{
+public:
+   ///Files parsed by each task, it is also the size of the merged batches
+   constexpr static const int BATCH_SIZE = 64;
+
+   VCardLoadTask(VCardBatchQueue* queue, const QStringList& paths) :
+      m_pQueue(queue), m_lPaths(paths) {}
+
+   virtual void run() override {
+      VCardBatch* batch = new VCardBatch();
+      batch->reserve(m_lPaths.size());
+
+      for (const QString& path : m_lPaths) {
+         VCardData data { path, {} };
+
+         QFile file(path);
+         if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            VCardMapper::scan(file.readAll(), [&data](const QByteArray& key, const QByteArray& value) {
+               //The key is a view on the file content
+               data.properties << qMakePair(QByteArray(key.constData(), key.size()), value);
+            });
+         }
+         else
+            qDebug() << "Error opening vcard: " << path;
+
+         *batch << data;
+      }
+
+      m_pQueue->push(batch);
+   }
+
+private:
+   VCardBatchQueue* m_pQueue;
+   QStringList      m_lPaths;
+};
 
 VCardUtils::VCardUtils()
 {
@@ -299,64 +477,74 @@ QList< Person* > VCardUtils::loadDir (const QUrl& path, bool& ok, QHash<const Pe
 {
    QList< Person* > ret;
 
-   QDir dir(path.toString());
-   if (!dir.exists())
-      ok = false;
-   else {
-      ok = true;
-      for (const QString& file : dir.entryList({"*.vcf"},QDir::Files)) {
-         Person* p = new Person();
-         mapToPerson(p,QUrl(dir.absoluteFilePath(file)));
-         ret << p;
-         paths[p] = dir.absoluteFilePath(file);
-      }
-   }
+   loadDir(path, ok, paths, [&ret](const QList<Person*>& batch) {
+      ret << batch;
+   });
 
    return ret;
 }
 
-bool VCardUtils::mapToPerson(Person* p, const QByteArray& all, QList<Account*>* accounts)
+/**
+ * Read and split the vCards over a thread pool. The batches are merged
+ * (Person objects and contact methods created, `callback` called) on the
+ * calling thread as soon as they are ready.
+ */
+void VCardUtils::loadDir(const QUrl& path, bool& ok, QHash<const Person*,QString>& paths, const std::function<void(const QList<Person*>&)>& callback)
 {
-   QByteArray previousKey,previousValue;
-   const QList<QByteArray> lines = all.split('\n');
-
-   foreach (const QByteArray& property, lines) {
-      //Ignore empty lines
-      if (property.size()) {
-         //Some properties are over multiple lines
-         if (property[0] == ' ' && previousKey.size()) {
-            previousValue += property.right(property.size()-1);
-         }
-         else {
-            if (previousKey.size())
-               vc_mapper->metacall(p,previousKey,previousValue.trimmed());
+   QDir dir(path.toString());
+   ok = dir.exists();
 
-            //Do not use split, URIs can have : in them
-            const int dblptPos = property.indexOf(':');
-            const QByteArray k(property.left(dblptPos)),v(property.right(property.size()-dblptPos-1));
+   if (!ok)
+      return;
 
-            //Link with accounts
-            if(k == VCardUtils::Property::X_RINGACCOUNT) {
-                  if (accounts) {
-                  Account* a = AccountModel::instance().getById(v.trimmed(),true);
-                  if(!a) {
-                     qDebug() << "Could not find account: " << v.trimmed();
-                     continue;
-                  }
-
-                  (*accounts) << a;
-               }
-            }
+   QStringList files = dir.entryList({"*.vcf"},QDir::Files);
 
-            previousKey   = k;
-            previousValue = v;
-         }
+   for (QString& file : files)
+      file = dir.absoluteFilePath(file);
+
+   //Notify the new numbers once the whole directory is loaded
+   PhoneDirectoryModelPrivate::BulkInsertion guard;
+
+   VCardBatchQueue queue;
+   QThreadPool     pool ;
+   int             tasks = 0;
+
+   for (int i = 0; i < files.size(); i += VCardLoadTask::BATCH_SIZE) {
+      pool.start(new VCardLoadTask(&queue, files.mid(i, VCardLoadTask::BATCH_SIZE)));
+      tasks++;
+   }
+
+   for (int i = 0; i < tasks; i++) {
+      std::unique_ptr<VCardBatch> batch(queue.pop());
+
+      VCardMapper    mapper ;
+      QList<Person*> persons;
+      persons.reserve(batch->size());
 
+      for (const VCardData& data : *batch) {
+         //The callback may run on a loader thread, the model owns the persons
+         Person* p = new Person();
+         p->moveToThread(PersonModel::instance().thread());
+
+         for (const auto& property : data.properties)
+            mapper.metacall(p, property.first, property.second);
+
+         paths[p] = data.path;
+         persons << p;
       }
 
+      mapper.apply();
+
+      callback(persons);
    }
+}
 
-   vc_mapper->apply();
+bool VCardUtils::mapToPerson(Person* p, const QByteArray& all, QList<Account*>* accounts)
+{
+   VCardMapper mapper;
+
+   mapper.parse(p, all, accounts);
+   mapper.apply();
 
    return true;
 }
@@ -380,6 +568,11 @@ Person* VCardUtils::mapToPerson(const QHash<QByteArray, QByteArray>& vCard, QLis
     auto existingPerson = PersonModel::instance().getPersonByUid(vCard[Property::UID]);
     auto personMapped = existingPerson == nullptr ? new Person() : existingPerson;
 
+    if (!existingPerson)
+        personMapped->moveToThread(PersonModel::instance().thread());
+
+    VCardMapper mapper;
+
     QHashIterator<QByteArray, QByteArray> it(vCard);
     while (it.hasNext()) {
         it.next();
@@ -393,10 +586,10 @@ Person* VCardUtils::mapToPerson(const QHash<QByteArray, QByteArray>& vCard, QLis
                 (*accounts) << acc;
            }
         }
-        vc_mapper->metacall(personMapped, it.key(), it.value().trimmed());
+        mapper.metacall(personMapped, it.key(), it.value().trimmed());
     }
 
-    vc_mapper->apply();
+    mapper.apply();
     return personMapped;
 }
 
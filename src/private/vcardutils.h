@@ -21,6 +21,9 @@
 #include <QStringList>
 #include "person.h"
 
+//Std
+#include <functional>
+
 class VCardUtils
 {
 public:
@@ -78,6 +81,7 @@ public:
 
    //Loading
    static QList<Person*> loadDir(const QUrl& path, bool& ok, QHash<const Person*, QString>& paths);
+   static void loadDir(const QUrl& path, bool& ok, QHash<const Person*, QString>& paths, const std::function<void(const QList<Person*>&)>& callback);
 
    //Mapping
    static bool mapToPerson(Person* p, const QUrl& url, QList<Account*>* accounts = nullptr);
@@ -0,0 +1,130 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "callbackdispatcher.h"
+
+//Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QEvent>
+#include <QtCore/QThread>
+
+//Std
+#include <unordered_map>
+#include <vector>
+
+static const QEvent::Type DISPATCH_EVENT = static_cast<QEvent::Type>(QEvent::registerEventType());
+
+CallbackDispatcher::CallbackDispatcher() : QObject(), m_Scheduled(false)
+{
+   //The first callback can come from a daemon thread
+   if (QCoreApplication::instance())
+      moveToThread(QCoreApplication::instance()->thread());
+}
+
+CallbackDispatcher::~CallbackDispatcher()
+{
+   while (Node* n = m_Queue.pop())
+      delete n;
+}
+
+CallbackDispatcher& CallbackDispatcher::instance()
+{
+   static auto dispatcher = new CallbackDispatcher();
+   return *dispatcher;
+}
+
+void CallbackDispatcher::post(std::function<void()>&& task)
+{
+   Node* n = new Node();
+   n->task = std::move(task);
+
+   m_Queue.push(n);
+   wake();
+}
+
+void CallbackDispatcher::post(std::function<void()>&& task, const std::string& key, const std::string& value)
+{
+   Node* n  = new Node();
+   n->task  = std::move(task);
+   n->key   = key;
+   n->value = value;
+
+   m_Queue.push(n);
+   wake();
+}
+
+///Must be set from the main thread
+void CallbackDispatcher::setBatchHandler(std::function<void()>&& handler)
+{
+   m_BatchHandler = std::move(handler);
+}
+
+///Only post an event when the queue wasn't already scheduled to be drained
+void CallbackDispatcher::wake()
+{
+   if (!m_Scheduled.exchange(true, std::memory_order_acq_rel))
+      QCoreApplication::postEvent(this, new QEvent(DISPATCH_EVENT));
+}
+
+void CallbackDispatcher::drain()
+{
+   //Reset first, anything pushed from now on will wake the loop again
+   m_Scheduled.store(false, std::memory_order_release);
+
+   std::vector<Node*> batch;
+
+   while (Node* n = m_Queue.pop())
+      batch.push_back(n);
+
+   //A producer was interrupted in the middle of push(), come back later
+   if (!m_Queue.isEmpty())
+      wake();
+
+   std::unordered_map<std::string, const std::string*> lastValues;
+
+   for (Node* n : batch) {
+      bool skip = false;
+
+      if (!n->key.empty()) {
+         auto it = lastValues.find(n->key);
+
+         skip = it != lastValues.end() && *it->second == n->value;
+
+         if (!skip)
+            lastValues[n->key] = &n->value;
+      }
+
+      if (!skip)
+         n->task();
+   }
+
+   for (Node* n : batch)
+      delete n;
+
+   if (m_BatchHandler && !batch.empty())
+      m_BatchHandler();
+}
+
+bool CallbackDispatcher::event(QEvent* e)
+{
+   if (e->type() == DISPATCH_EVENT) {
+      drain();
+      return true;
+   }
+
+   return QObject::event(e);
+}
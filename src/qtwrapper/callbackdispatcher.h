@@ -0,0 +1,76 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QObject>
+
+//Ring
+#include "private/mpscqueue.h"
+
+//Std
+#include <atomic>
+#include <functional>
+#include <string>
+
+/**
+ * Forward the daemon callbacks to the main thread.
+ *
+ * The callbacks can be invoked from any daemon thread. They are pushed into
+ * a lock-free multiple producers, single consumer queue and the main event
+ * loop is woken up with a single posted event per batch, instead of one
+ * timer per callback. The queue is then drained at once.
+ *
+ * Tasks posted with a key and a value are coalesced: when the previous task
+ * of the same batch with that key carried the same value, it is dropped.
+ * This is used to collapse the repeated call StateChange events.
+ *
+ * The batch handler, if any, is called on the main thread after each batch.
+ */
+class CallbackDispatcher final : public QObject
+{
+public:
+   static CallbackDispatcher& instance();
+
+   void post(std::function<void()>&& task);
+   void post(std::function<void()>&& task, const std::string& key, const std::string& value);
+   void setBatchHandler(std::function<void()>&& handler);
+
+protected:
+   virtual bool event(QEvent* e) override;
+
+private:
+   explicit CallbackDispatcher();
+   virtual ~CallbackDispatcher();
+
+   struct Node {
+      std::atomic<Node*>    next ;
+      std::function<void()> task ;
+      std::string           key  ;
+      std::string           value;
+   };
+
+   //Helpers
+   void wake (       );
+   void drain(       );
+
+   //Attributes
+   MpscQueue<Node>    m_Queue     ;
+   std::atomic<bool>  m_Scheduled ;
+   std::function<void()> m_BatchHandler;
+};
@@ -21,6 +21,7 @@
 #include "callmanager.h"
 #include "presencemanager.h"
 #include "configurationmanager.h"
+#include "callbackdispatcher.h"
 #ifdef ENABLE_VIDEO
  #include "videomanager.h"
 #endif //ENABLE_VIDEO
@@ -43,8 +44,19 @@ InstanceManagerInterface::InstanceManagerInterface() : m_pTimer(nullptr)
    using DRing::VideoSignal;
 #endif
 
+   //The daemon still expects to be polled for its own internal events. It is
+   //polled after each batch of callbacks and once more when the timer
+   //expires. The timer is single shot and rearmed by the next push into the
+   //callback queue, so the process doesn't wake up while the queue is empty.
    m_pTimer = new QTimer(this);
    m_pTimer->setInterval(50);
+   m_pTimer->setSingleShot(true);
+
+   //Created from the main thread, the daemon callbacks are forwarded to it
+   CallbackDispatcher::instance().setBatchHandler([this]() {
+      pollEvents();
+      m_pTimer->start();
+   });
 #ifdef Q_OS_WIN
    connect(m_pTimer,SIGNAL(timeout()),this,SLOT(pollEvents()));
 #else
@@ -0,0 +1,288 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "standin.h"
+#include "standin_p.h"
+
+//Ring
+#include <callmanager_interface.h>
+
+/*
+ * The client requests change the call state like a peer answering right
+ * away would. There is no conference support.
+ */
+namespace DRing {
+
+using StandIn::state;
+namespace CallState = StandIn::CallState;
+
+static bool changeState(const std::string& callID, const char* callState)
+{
+   {
+      std::lock_guard<std::mutex> lk(state().mutex);
+
+      if (!state().calls.count(callID))
+         return false;
+   }
+
+   StandIn::setCallState(callID, callState);
+
+   return true;
+}
+
+std::string placeCall(const std::string& accountID, const std::string& to)
+{
+   const std::string callId = StandIn::createCall(accountID, to, StandIn::CallDirection::OUTGOING, CallState::CONNECTING);
+
+   StandIn::emitSignal<CallSignal::StateChange>(callId, std::string(CallState::CONNECTING), 0);
+   StandIn::setCallState(callId, CallState::RINGING);
+
+   return callId;
+}
+
+bool refuse(const std::string& callID)
+{
+   return changeState(callID, CallState::HUNG_UP) && changeState(callID, CallState::OVER);
+}
+
+bool accept(const std::string& callID)
+{
+   return changeState(callID, CallState::CURRENT);
+}
+
+bool hangUp(const std::string& callID)
+{
+   return changeState(callID, CallState::HUNG_UP) && changeState(callID, CallState::OVER);
+}
+
+bool hold(const std::string& callID)
+{
+   return changeState(callID, CallState::HOLD);
+}
+
+bool unhold(const std::string& callID)
+{
+   return changeState(callID, CallState::CURRENT);
+}
+
+bool muteLocalMedia(const std::string& callid, const std::string& mediaType, bool mute)
+{
+   (void) mediaType;
+   (void) mute;
+   std::lock_guard<std::mutex> lk(state().mutex);
+   return state().calls.count(callid);
+}
+
+bool transfer(const std::string& callID, const std::string& to)
+{
+   (void) to;
+   return hangUp(callID);
+}
+
+bool attendedTransfer(const std::string& transferID, const std::string& targetID)
+{
+   (void) targetID;
+   return hangUp(transferID);
+}
+
+std::map<std::string, std::string> getCallDetails(const std::string& callID)
+{
+   std::lock_guard<std::mutex> lk(state().mutex);
+
+   const auto it = state().calls.find(callID);
+
+   return it == state().calls.end() ? std::map<std::string, std::string>() : it->second;
+}
+
+std::vector<std::string> getCallList()
+{
+   std::lock_guard<std::mutex> lk(state().mutex);
+
+   std::vector<std::string> ret;
+   ret.reserve(state().calls.size());
+
+   for (const auto& c : state().calls)
+      ret.push_back(c.first);
+
+   return ret;
+}
+
+bool joinParticipant(const std::string& sel_callID, const std::string& drag_callID)
+{
+   (void) sel_callID;
+   (void) drag_callID;
+   return false;
+}
+
+void createConfFromParticipantList(const std::vector<std::string>& participants)
+{
+   (void) participants;
+}
+
+bool isConferenceParticipant(const std::string& call_id)
+{
+   (void) call_id;
+   return false;
+}
+
+bool addParticipant(const std::string& callID, const std::string& confID)
+{
+   (void) callID;
+   (void) confID;
+   return false;
+}
+
+bool addMainParticipant(const std::string& confID)
+{
+   (void) confID;
+   return false;
+}
+
+bool detachParticipant(const std::string& callID)
+{
+   (void) callID;
+   return false;
+}
+
+bool joinConference(const std::string& sel_confID, const std::string& drag_confID)
+{
+   (void) sel_confID;
+   (void) drag_confID;
+   return false;
+}
+
+bool hangUpConference(const std::string& confID)
+{
+   (void) confID;
+   return false;
+}
+
+bool holdConference(const std::string& confID)
+{
+   (void) confID;
+   return false;
+}
+
+bool unholdConference(const std::string& confID)
+{
+   (void) confID;
+   return false;
+}
+
+std::vector<std::string> getConferenceList()
+{
+   return {};
+}
+
+std::vector<std::string> getParticipantList(const std::string& confID)
+{
+   (void) confID;
+   return {};
+}
+
+std::vector<std::string> getDisplayNames(const std::string& confID)
+{
+   (void) confID;
+   return {};
+}
+
+std::string getConferenceId(const std::string& callID)
+{
+   (void) callID;
+   return {};
+}
+
+std::map<std::string, std::string> getConferenceDetails(const std::string& callID)
+{
+   (void) callID;
+   return {};
+}
+
+bool startRecordedFilePlayback(const std::string& filepath)
+{
+   (void) filepath;
+   return false;
+}
+
+void stopRecordedFilePlayback(const std::string& filepath)
+{
+   (void) filepath;
+}
+
+bool toggleRecording(const std::string& callID)
+{
+   (void) callID;
+   return false;
+}
+
+void recordPlaybackSeek(double value)
+{
+   (void) value;
+}
+
+bool getIsRecording(const std::string& callID)
+{
+   (void) callID;
+   return false;
+}
+
+void playDTMF(const std::string& key)
+{
+   (void) key;
+}
+
+void startTone(int32_t start, int32_t type)
+{
+   (void) start;
+   (void) type;
+}
+
+void setSASVerified(const std::string& callID)
+{
+   (void) callID;
+}
+
+void resetSASVerified(const std::string& callID)
+{
+   (void) callID;
+}
+
+void setConfirmGoClear(const std::string& callID)
+{
+   (void) callID;
+}
+
+void requestGoClear(const std::string& callID)
+{
+   (void) callID;
+}
+
+void acceptEnrollment(const std::string& callID, bool accepted)
+{
+   (void) callID;
+   (void) accepted;
+}
+
+void sendTextMessage(const std::string& callID, const std::map<std::string, std::string>& messages, const std::string& from, bool isMixed)
+{
+   (void) callID;
+   (void) messages;
+   (void) from;
+   (void) isMixed;
+}
+
+}
@@ -0,0 +1,528 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "standin.h"
+#include "standin_p.h"
+
+//Std
+#include <algorithm>
+
+//Ring
+#include <configurationmanager_interface.h>
+
+/*
+ * Only the accounts and the messages have a state, the audio, codec,
+ * certificate and network queries return empty or default values.
+ */
+namespace DRing {
+
+using StandIn::state;
+
+std::map<std::string, std::string> getAccountDetails(const std::string& accountID)
+{
+   std::lock_guard<std::mutex> lk(state().mutex);
+
+   const auto it = state().accounts.find(accountID);
+
+   return it == state().accounts.end() ? std::map<std::string, std::string>() : it->second;
+}
+
+std::map<std::string, std::string> getVolatileAccountDetails(const std::string& accountID)
+{
+   std::lock_guard<std::mutex> lk(state().mutex);
+
+   const auto it = state().volatiles.find(accountID);
+
+   return it == state().volatiles.end() ? std::map<std::string, std::string>() : it->second;
+}
+
+void setAccountDetails(const std::string& accountID, const std::map<std::string, std::string>& details)
+{
+   {
+      std::lock_guard<std::mutex> lk(state().mutex);
+
+      const auto it = state().accounts.find(accountID);
+
+      if (it == state().accounts.end())
+         return;
+
+      for (const auto& d : details)
+         it->second[d.first] = d.second;
+   }
+
+   StandIn::emitSignal<ConfigurationSignal::AccountsChanged>();
+}
+
+std::map<std::string, std::string> getAccountTemplate(const std::string& accountType)
+{
+   (void) accountType;
+   return {};
+}
+
+std::string addAccount(const std::map<std::string, std::string>& details)
+{
+   std::string accountId;
+
+   {
+      std::lock_guard<std::mutex> lk(state().mutex);
+      accountId = "standin" + std::to_string(state().accounts.size());
+   }
+
+   StandIn::addAccount(accountId, details);
+
+   return accountId;
+}
+
+void removeAccount(const std::string& accountID)
+{
+   {
+      std::lock_guard<std::mutex> lk(state().mutex);
+
+      auto& order = state().accountOrder;
+
+      order.erase(std::remove(order.begin(), order.end(), accountID), order.end());
+      state().accounts .erase(accountID);
+      state().volatiles.erase(accountID);
+   }
+
+   StandIn::emitSignal<ConfigurationSignal::AccountsChanged>();
+}
+
+std::vector<std::string> getAccountList()
+{
+   std::lock_guard<std::mutex> lk(state().mutex);
+   return state().accountOrder;
+}
+
+void sendRegister(const std::string& accountID, bool enable)
+{
+   (void) accountID;
+   (void) enable;
+}
+
+void registerAllAccounts()
+{
+}
+
+void setAccountsOrder(const std::string& order)
+{
+   (void) order;
+}
+
+///The messages are always sent
+uint64_t sendAccountTextMessage(const std::string& accountID, const std::string& to, const std::map<std::string, std::string>& payloads)
+{
+   (void) accountID;
+   (void) to;
+   (void) payloads;
+
+   std::lock_guard<std::mutex> lk(state().mutex);
+   return ++state().messageCounter;
+}
+
+int getMessageStatus(uint64_t id)
+{
+   (void) id;
+   return 2; // SENT
+}
+
+int exportAccounts(std::vector<std::string> accountIDs, std::string filepath, std::string password)
+{
+   (void) accountIDs;
+   (void) filepath;
+   (void) password;
+   return 1;
+}
+
+int importAccounts(std::string archivePath, std::string password)
+{
+   (void) archivePath;
+   (void) password;
+   return 1;
+}
+
+std::vector<std::map<std::string, std::string>> getCredentials(const std::string& accountID)
+{
+   (void) accountID;
+   return {};
+}
+
+void setCredentials(const std::string& accountID, const std::vector<std::map<std::string, std::string>>& details)
+{
+   (void) accountID;
+   (void) details;
+}
+
+std::vector<unsigned> getCodecList()
+{
+   return {};
+}
+
+std::vector<unsigned> getActiveCodecList(const std::string& accountID)
+{
+   (void) accountID;
+   return {};
+}
+
+void setActiveCodecList(const std::string& accountID, const std::vector<unsigned>& list)
+{
+   (void) accountID;
+   (void) list;
+}
+
+std::map<std::string, std::string> getCodecDetails(const std::string& accountID, const unsigned& codecId)
+{
+   (void) accountID;
+   (void) codecId;
+   return {};
+}
+
+bool setCodecDetails(const std::string& accountID, const unsigned& codecId, const std::map<std::string, std::string>& details)
+{
+   (void) accountID;
+   (void) codecId;
+   (void) details;
+   return false;
+}
+
+std::map<std::string, std::string> getTlsDefaultSettings()
+{
+   return {};
+}
+
+std::vector<std::string> getSupportedTlsMethod()
+{
+   return {};
+}
+
+std::vector<std::string> getSupportedCiphers(const std::string& accountID)
+{
+   (void) accountID;
+   return {};
+}
+
+std::map<std::string, std::string> validateCertificate(const std::string& accountId, const std::string& certificate)
+{
+   (void) accountId;
+   (void) certificate;
+   return {};
+}
+
+std::map<std::string, std::string> validateCertificatePath(const std::string& accountId, const std::string& certificatePath, const std::string& privateKey, const std::string& privateKeyPassword, const std::string& caList)
+{
+   (void) accountId;
+   (void) certificatePath;
+   (void) privateKey;
+   (void) privateKeyPassword;
+   (void) caList;
+   return {};
+}
+
+std::map<std::string, std::string> getCertificateDetails(const std::string& certificate)
+{
+   (void) certificate;
+   return {};
+}
+
+std::map<std::string, std::string> getCertificateDetailsPath(const std::string& certificatePath, const std::string& privateKey, const std::string& privateKeyPassword)
+{
+   (void) certificatePath;
+   (void) privateKey;
+   (void) privateKeyPassword;
+   return {};
+}
+
+std::vector<std::string> getPinnedCertificates()
+{
+   return {};
+}
+
+std::vector<std::string> pinCertificate(const std::vector<uint8_t>& certificate, bool local)
+{
+   (void) certificate;
+   (void) local;
+   return {};
+}
+
+bool unpinCertificate(const std::string& certId)
+{
+   (void) certId;
+   return false;
+}
+
+void pinCertificatePath(const std::string& path)
+{
+   (void) path;
+}
+
+unsigned unpinCertificatePath(const std::string& path)
+{
+   (void) path;
+   return 0;
+}
+
+bool pinRemoteCertificate(const std::string& accountId, const std::string& certId)
+{
+   (void) accountId;
+   (void) certId;
+   return false;
+}
+
+bool setCertificateStatus(const std::string& account, const std::string& certId, const std::string& status)
+{
+   (void) account;
+   (void) certId;
+   (void) status;
+   return false;
+}
+
+std::vector<std::string> getCertificatesByStatus(const std::string& account, const std::string& status)
+{
+   (void) account;
+   (void) status;
+   return {};
+}
+
+std::map<std::string, std::string> getTrustRequests(const std::string& accountId)
+{
+   (void) accountId;
+   return {};
+}
+
+bool acceptTrustRequest(const std::string& accountId, const std::string& from)
+{
+   (void) accountId;
+   (void) from;
+   return false;
+}
+
+bool discardTrustRequest(const std::string& accountId, const std::string& from)
+{
+   (void) accountId;
+   (void) from;
+   return false;
+}
+
+void sendTrustRequest(const std::string& accountId, const std::string& to, const std::vector<uint8_t>& payload)
+{
+   (void) accountId;
+   (void) to;
+   (void) payload;
+}
+
+std::vector<std::string> getAudioPluginList()
+{
+   return {};
+}
+
+void setAudioPlugin(const std::string& audioPlugin)
+{
+   (void) audioPlugin;
+}
+
+std::vector<std::string> getAudioOutputDeviceList()
+{
+   return {};
+}
+
+std::vector<std::string> getAudioInputDeviceList()
+{
+   return {};
+}
+
+void setAudioOutputDevice(int32_t index)
+{
+   (void) index;
+}
+
+void setAudioInputDevice(int32_t index)
+{
+   (void) index;
+}
+
+void setAudioRingtoneDevice(int32_t index)
+{
+   (void) index;
+}
+
+std::vector<std::string> getCurrentAudioDevicesIndex()
+{
+   return {};
+}
+
+int32_t getAudioInputDeviceIndex(const std::string& name)
+{
+   (void) name;
+   return -1;
+}
+
+int32_t getAudioOutputDeviceIndex(const std::string& name)
+{
+   (void) name;
+   return -1;
+}
+
+std::string getCurrentAudioOutputPlugin()
+{
+   return {};
+}
+
+bool getNoiseSuppressState()
+{
+   return false;
+}
+
+void setNoiseSuppressState(bool state)
+{
+   (void) state;
+}
+
+bool isAgcEnabled()
+{
+   return false;
+}
+
+void setAgcState(bool enabled)
+{
+   (void) enabled;
+}
+
+void muteDtmf(bool mute)
+{
+   (void) mute;
+}
+
+bool isDtmfMuted()
+{
+   return false;
+}
+
+bool isCaptureMuted()
+{
+   return false;
+}
+
+void muteCapture(bool mute)
+{
+   (void) mute;
+}
+
+bool isPlaybackMuted()
+{
+   return false;
+}
+
+void mutePlayback(bool mute)
+{
+   (void) mute;
+}
+
+std::string getAudioManager()
+{
+   return {};
+}
+
+bool setAudioManager(const std::string& api)
+{
+   (void) api;
+   return false;
+}
+
+int isIax2Enabled()
+{
+   return 0;
+}
+
+std::string getRecordPath()
+{
+   return {};
+}
+
+void setRecordPath(const std::string& recPath)
+{
+   (void) recPath;
+}
+
+bool getIsAlwaysRecording()
+{
+   return false;
+}
+
+void setIsAlwaysRecording(bool rec)
+{
+   (void) rec;
+}
+
+void setHistoryLimit(int32_t days)
+{
+   (void) days;
+}
+
+int32_t getHistoryLimit()
+{
+   return 0;
+}
+
+std::map<std::string, std::string> getHookSettings()
+{
+   return {};
+}
+
+void setHookSettings(const std::map<std::string, std::string>& settings)
+{
+   (void) settings;
+}
+
+std::string getAddrFromInterfaceName(const std::string& interface)
+{
+   (void) interface;
+   return "127.0.0.1";
+}
+
+std::vector<std::string> getAllIpInterface()
+{
+   return { "127.0.0.1" };
+}
+
+std::vector<std::string> getAllIpInterfaceByName()
+{
+   return { "lo" };
+}
+
+std::map<std::string, std::string> getShortcuts()
+{
+   return {};
+}
+
+void setShortcuts(const std::map<std::string, std::string>& shortcutsMap)
+{
+   (void) shortcutsMap;
+}
+
+void setVolume(const std::string& device, double value)
+{
+   (void) device;
+   (void) value;
+}
+
+double getVolume(const std::string& device)
+{
+   (void) device;
+   return 1.0;
+}
+
+}
@@ -0,0 +1,253 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "standin.h"
+#include "standin_p.h"
+
+//Std
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+
+//Ring
+#include <account_const.h>
+#include <call_const.h>
+#include <callmanager_interface.h>
+#include <configurationmanager_interface.h>
+#include <presencemanager_interface.h>
+
+namespace StandIn {
+
+State::State() : callCounter(0), messageCounter(0)
+{
+   //A registered SIP account is always available
+   accountOrder.push_back("standin");
+
+   accounts["standin"] = {
+      { DRing::Account::ConfProperties::ALIAS    , "Stand-in"                       },
+      { DRing::Account::ConfProperties::TYPE     , DRing::Account::ProtocolNames::SIP},
+      { DRing::Account::ConfProperties::ENABLED  , "true"                           },
+      { DRing::Account::ConfProperties::USERNAME , "standin"                        },
+      { DRing::Account::ConfProperties::HOSTNAME , "localhost"                      },
+   };
+
+   volatiles["standin"] = {
+      { DRing::Account::VolatileProperties::Registration::STATUS, DRing::Account::States::REGISTERED },
+   };
+}
+
+State& state()
+{
+   static State s;
+   return s;
+}
+
+void registerHandlers(const std::map<std::string, std::shared_ptr<DRing::CallbackWrapperBase> >& handlers)
+{
+   std::lock_guard<std::mutex> lk(state().mutex);
+
+   for (const auto& h : handlers)
+      state().handlers[h.first] = h.second;
+}
+
+std::string createCall(const std::string& accountId, const std::string& peer, const char* type, const std::string& callState)
+{
+   std::lock_guard<std::mutex> lk(state().mutex);
+
+   const std::string callId = "standin-" + std::to_string(++state().callCounter);
+
+   state().calls[callId] = {
+      { DRing::Call::Details::CALL_TYPE      , type                             },
+      { DRing::Call::Details::PEER_NUMBER    , peer                             },
+      { DRing::Call::Details::DISPLAY_NAME   , peer                             },
+      { DRing::Call::Details::CALL_STATE     , callState                        },
+      { DRing::Call::Details::CONF_ID        , ""                               },
+      { DRing::Call::Details::TIMESTAMP_START, std::to_string(std::time(nullptr))},
+      { DRing::Call::Details::ACCOUNTID      , accountId                        },
+      { DRing::Call::Details::VIDEO_SOURCE   , ""                               },
+   };
+
+   return callId;
+}
+
+void addAccount(const std::string& accountId, const std::map<std::string, std::string>& details)
+{
+   {
+      std::lock_guard<std::mutex> lk(state().mutex);
+
+      auto& order = state().accountOrder;
+
+      if (std::find(order.begin(), order.end(), accountId) == order.end())
+         order.push_back(accountId);
+
+      state().accounts [accountId] = details;
+      state().volatiles[accountId] = {
+         { DRing::Account::VolatileProperties::Registration::STATUS, DRing::Account::States::REGISTERED },
+      };
+   }
+
+   emitSignal<DRing::ConfigurationSignal::AccountsChanged>();
+}
+
+std::string incomingCall(const std::string& accountId, const std::string& from)
+{
+   const std::string callId = createCall(accountId, from, CallDirection::INCOMING, CallState::INCOMING);
+
+   emitSignal<DRing::CallSignal::IncomingCall>(accountId, callId, from);
+   emitSignal<DRing::CallSignal::StateChange >(callId, std::string(CallState::INCOMING), 0);
+
+   return callId;
+}
+
+void setCallState(const std::string& callId, const std::string& callState)
+{
+   {
+      std::lock_guard<std::mutex> lk(state().mutex);
+
+      const auto it = state().calls.find(callId);
+
+      if (it == state().calls.end())
+         return;
+
+      if (callState == CallState::OVER)
+         state().calls.erase(it);
+      else
+         it->second[DRing::Call::Details::CALL_STATE] = callState;
+   }
+
+   emitSignal<DRing::CallSignal::StateChange>(callId, callState, 0);
+}
+
+void accountMessage(const std::string& accountId, const std::string& from, const std::map<std::string, std::string>& payloads)
+{
+   emitSignal<DRing::ConfigurationSignal::IncomingAccountMessage>(accountId, from, payloads);
+}
+
+void buddyNotification(const std::string& accountId, const std::string& uri, bool status, const std::string& lineStatus)
+{
+   {
+      std::lock_guard<std::mutex> lk(state().mutex);
+      state().subscriptions[accountId][uri] = status;
+   }
+
+   emitSignal<DRing::PresenceSignal::NewBuddyNotification>(accountId, uri, status, lineStatus);
+}
+
+void startDecoding(const std::string& id, int width, int height)
+{
+   {
+      std::lock_guard<std::mutex> lk(state().mutex);
+      state().decoders[id] = std::make_pair(width, height);
+   }
+
+   emitSignal<DRing::VideoSignal::DecodingStarted>(id, std::string(), width, height, false);
+}
+
+void stopDecoding(const std::string& id)
+{
+   {
+      std::lock_guard<std::mutex> lk(state().mutex);
+
+      if (!state().decoders.erase(id))
+         return;
+   }
+
+   emitSignal<DRing::VideoSignal::DecodingStopped>(id, std::string(), false);
+}
+
+///Fill a BGRA frame with a value changing at each frame
+bool pushFrame(const std::string& id)
+{
+   DRing::SinkTarget target;
+   std::size_t       size;
+
+   {
+      std::lock_guard<std::mutex> lk(state().mutex);
+
+      const auto decoder = state().decoders.find(id);
+      const auto sink    = state().sinks   .find(id);
+
+      if (decoder == state().decoders.end() || sink == state().sinks.end())
+         return false;
+
+      target = sink->second;
+      size   = static_cast<std::size_t>(decoder->second.first) * decoder->second.second * 4;
+   }
+
+   if (!(target.pull && target.push))
+      return false;
+
+   auto buffer = target.pull(size);
+
+   if (!(buffer && buffer->ptr))
+      return false;
+
+   static unsigned char value = 0;
+   std::memset(buffer->ptr, value++, std::min(size, buffer->ptrSize));
+
+   target.push(std::move(buffer));
+
+   return true;
+}
+
+}
+
+namespace DRing {
+
+bool init(enum InitFlag flags) noexcept
+{
+   (void) flags;
+   StandIn::state();
+   return true;
+}
+
+bool start(const std::string& config_file) noexcept
+{
+   (void) config_file;
+   return true;
+}
+
+void fini() noexcept
+{
+}
+
+///There is no internal event, all the callbacks are invoked directly
+void pollEvents() noexcept
+{
+}
+
+void registerCallHandlers(const std::map<std::string, std::shared_ptr<CallbackWrapperBase>>& handlers)
+{
+   StandIn::registerHandlers(handlers);
+}
+
+void registerConfHandlers(const std::map<std::string, std::shared_ptr<CallbackWrapperBase>>& handlers)
+{
+   StandIn::registerHandlers(handlers);
+}
+
+void registerPresHandlers(const std::map<std::string, std::shared_ptr<CallbackWrapperBase>>& handlers)
+{
+   StandIn::registerHandlers(handlers);
+}
+
+void registerVideoHandlers(const std::map<std::string, std::shared_ptr<CallbackWrapperBase>>& handlers)
+{
+   StandIn::registerHandlers(handlers);
+}
+
+}
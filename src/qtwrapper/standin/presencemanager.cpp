@@ -0,0 +1,81 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "standin_p.h"
+
+//Ring
+#include <presencemanager_interface.h>
+
+namespace DRing {
+
+using StandIn::state;
+
+void publish(const std::string& accountID, bool status, const std::string& note)
+{
+   (void) accountID;
+   (void) status;
+   (void) note;
+}
+
+void answerServerRequest(const std::string& uri, bool flag)
+{
+   (void) uri;
+   (void) flag;
+}
+
+void subscribeBuddy(const std::string& accountID, const std::string& uri, bool flag)
+{
+   {
+      std::lock_guard<std::mutex> lk(state().mutex);
+
+      auto& buddies = state().subscriptions[accountID];
+
+      if (flag)
+         buddies.insert(std::make_pair(uri, false));
+      else
+         buddies.erase(uri);
+   }
+
+   if (flag)
+      StandIn::emitSignal<PresenceSignal::SubscriptionStateChanged>(accountID, uri, true);
+}
+
+///Same keys as presence_const.h
+std::vector<std::map<std::string, std::string>> getSubscriptions(const std::string& accountID)
+{
+   std::lock_guard<std::mutex> lk(state().mutex);
+
+   std::vector<std::map<std::string, std::string>> ret;
+
+   for (const auto& buddy : state().subscriptions[accountID]) {
+      ret.push_back({
+         { "Buddy"     , buddy.first                        },
+         { "Status"    , buddy.second ? "Online" : "Offline"},
+         { "LineStatus", ""                                 },
+      });
+   }
+
+   return ret;
+}
+
+void setSubscriptions(const std::string& accountID, const std::vector<std::string>& uris)
+{
+   for (const std::string& uri : uris)
+      subscribeBuddy(accountID, uri, true);
+}
+
+}
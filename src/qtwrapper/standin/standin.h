@@ -0,0 +1,61 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Std
+#include <map>
+#include <string>
+
+/**
+ * Control interface of the stand-in daemon.
+ *
+ * The stand-in daemon is a fake implementation of the DRing API the
+ * qtwrapper is linked with instead of the real daemon library when built
+ * with ENABLE_STANDIN_DAEMON. It keeps the accounts, calls, subscriptions
+ * and decoders in memory and answers the queries from that state, so the
+ * models see the same details as with a real daemon.
+ *
+ * The functions below change that state and invoke the registered
+ * callbacks like the real daemon does, they can be called from any thread.
+ * There is no network, audio or camera.
+ */
+namespace StandIn {
+
+///Add or replace an account, it is registered right away
+void addAccount(const std::string& accountId, const std::map<std::string, std::string>& details);
+
+///Create an incoming call on the account, return its id
+std::string incomingCall(const std::string& accountId, const std::string& from);
+
+///Move a call to another state ("CURRENT", "HOLD", ...), it is removed once "OVER"
+void setCallState(const std::string& callId, const std::string& state);
+
+///Receive an account text message
+void accountMessage(const std::string& accountId, const std::string& from, const std::map<std::string, std::string>& payloads);
+
+///Change the presence status of a buddy
+void buddyNotification(const std::string& accountId, const std::string& uri, bool status, const std::string& lineStatus);
+
+///Start or stop a decoder, the frames are sent to the sink registered for the id
+void startDecoding(const std::string& id, int width, int height);
+void stopDecoding (const std::string& id                        );
+
+///Push one frame to the decoder sink, return false when nothing is listening
+bool pushFrame(const std::string& id);
+
+}
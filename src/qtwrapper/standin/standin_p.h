@@ -0,0 +1,102 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Std
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//Ring
+#include <dring.h>
+#include <videomanager_interface.h>
+
+namespace StandIn {
+
+typedef std::map<std::string, std::string> Details;
+
+///The state names of the StateChange signal, as CallPrivate::StateChange
+namespace CallState {
+   constexpr static const char* INCOMING   = "INCOMING"  ;
+   constexpr static const char* CONNECTING = "CONNECTING";
+   constexpr static const char* RINGING    = "RINGING"   ;
+   constexpr static const char* CURRENT    = "CURRENT"   ;
+   constexpr static const char* HOLD       = "HOLD"      ;
+   constexpr static const char* HUNG_UP    = "HUNGUP"    ;
+   constexpr static const char* OVER       = "OVER"      ;
+}
+
+///The call directions, as CallPrivate::CallDirection
+namespace CallDirection {
+   constexpr static const char* INCOMING = "0";
+   constexpr static const char* OUTGOING = "1";
+}
+
+///In memory state of the stand-in daemon
+struct State {
+   State();
+
+   std::mutex                                                           mutex         ;
+   std::map<std::string, std::shared_ptr<DRing::CallbackWrapperBase> >  handlers      ;
+   std::vector<std::string>                                             accountOrder  ;
+   std::map<std::string, Details>                                       accounts      ;
+   std::map<std::string, Details>                                       volatiles     ;
+   std::map<std::string, Details>                                       calls         ;
+   std::map<std::string, std::map<std::string, bool> >                  subscriptions ;
+   std::map<std::string, std::pair<int, int> >                          decoders      ;
+   std::map<std::string, DRing::SinkTarget>                             sinks         ;
+   unsigned                                                             callCounter   ;
+   uint64_t                                                             messageCounter;
+};
+
+State& state();
+
+void registerHandlers(const std::map<std::string, std::shared_ptr<DRing::CallbackWrapperBase> >& handlers);
+
+///Create a call in the given state, return its id
+std::string createCall(const std::string& accountId, const std::string& peer, const char* type, const std::string& callState);
+
+/**
+ * Invoke the callback registered for a signal, as the daemon does. It is
+ * never called with the state mutex held, the callbacks can query the
+ * daemon.
+ */
+template<typename Ts, typename... Args>
+void emitSignal(Args... args)
+{
+   std::shared_ptr<DRing::CallbackWrapperBase> handler;
+
+   {
+      std::lock_guard<std::mutex> lk(state().mutex);
+
+      const auto it = state().handlers.find(Ts::name);
+
+      if (it == state().handlers.end())
+         return;
+
+      handler = it->second;
+   }
+
+   if (auto cb = *DRing::CallbackWrapper<typename Ts::cb_type>(handler))
+      cb(args...);
+}
+
+}
@@ -0,0 +1,94 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "standin_p.h"
+
+//Ring
+#include <videomanager_interface.h>
+
+/*
+ * There is no camera, only the decoders started by StandIn::startDecoding()
+ * produce frames.
+ */
+namespace DRing {
+
+using StandIn::state;
+
+std::vector<std::string> getDeviceList()
+{
+   return {};
+}
+
+VideoCapabilities getCapabilities(const std::string& name)
+{
+   (void) name;
+   return {};
+}
+
+std::map<std::string, std::string> getSettings(const std::string& name)
+{
+   (void) name;
+   return {};
+}
+
+void applySettings(const std::string& name, const std::map<std::string, std::string>& settings)
+{
+   (void) name;
+   (void) settings;
+}
+
+void setDefaultDevice(const std::string& name)
+{
+   (void) name;
+}
+
+std::string getDefaultDevice()
+{
+   return {};
+}
+
+void startCamera()
+{
+}
+
+void stopCamera()
+{
+}
+
+bool hasCameraStarted()
+{
+   return false;
+}
+
+bool switchInput(const std::string& resource)
+{
+   (void) resource;
+   return true;
+}
+
+///An empty target unregister the sink
+void registerSinkTarget(const std::string& sinkId, const SinkTarget& target)
+{
+   std::lock_guard<std::mutex> lk(state().mutex);
+
+   if (target.pull)
+      state().sinks[sinkId] = target;
+   else
+      state().sinks.erase(sinkId);
+}
+
+}
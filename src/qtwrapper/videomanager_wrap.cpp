@@ -17,6 +17,7 @@
  *   along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
  *****************************************************************************/
  #include "videomanager_wrap.h"
+ #include "callbackdispatcher.h"
 
 VideoManagerInterface::VideoManagerInterface()
 {
@@ -60,21 +61,21 @@ m_pParent(parent)
 
 void VideoManagerSignalProxy::slotDeviceEvent()
 {
-    QTimer::singleShot(0, [=] {
+    CallbackDispatcher::instance().post([=] {
         emit m_pParent->deviceEvent();
     });
 }
 
 void VideoManagerSignalProxy::slotStartedDecoding(const QString &id, const QString &shmPath, int width, int height, bool isMixer)
 {
-    QTimer::singleShot(0, [=] {
+    CallbackDispatcher::instance().post([=] {
         emit m_pParent->startedDecoding(id,shmPath,width,height,isMixer);
     });
 }
 
 void VideoManagerSignalProxy::slotStoppedDecoding(const QString &id, const QString &shmPath, bool isMixer)
 {
-    QTimer::singleShot(0, [=] {
+    CallbackDispatcher::instance().post([=] {
         emit m_pParent->stoppedDecoding(id,shmPath,isMixer);
     });
 }
@@ -37,6 +37,7 @@
 #include <categorizedhistorymodel.h>
 #include <media/recordingmodel.h>
 #include <media/textrecording.h>
+#include "private/orderstatistictree.h"
 
 struct CallGroup
 {
@@ -60,7 +61,6 @@ struct RecentViewNode
    };
 
    //Constructor
-   explicit RecentViewNode();
    RecentViewNode(Call* c, RecentModelPrivate* model);
    RecentViewNode(const Person *p, RecentModelPrivate* model);
    RecentViewNode(ContactMethod *cm, RecentModelPrivate* model);
@@ -112,12 +112,11 @@ public:
    RecentModelPrivate(RecentModel* p);
 
    /*
-   * m_lTopLevelReverted hold the elements in the reverse order of
-   * QAbstractItemModel::index. This cause most of the energy to be
-   * in the bottom half of the vector, preventing std::move every time
-   * someone is contacted
+   * m_lTopLevel hold the top level nodes sorted by last used time. The
+   * children rows are stored in m_Index, the top level ones are computed
+   * by the tree, see row()
    */
-   QList<RecentViewNode*>                m_lTopLevelReverted;
+   OrderStatisticTree<RecentViewNode>    m_lTopLevel        ;
    QHash<const Person*,RecentViewNode*>  m_hPersonsToNodes  ;
    QHash<ContactMethod*,RecentViewNode*> m_hCMsToNodes      ;
    QHash<Call*,RecentViewNode*>          m_hCallsToNodes    ;
@@ -133,6 +132,7 @@ public:
    void            moveCallNode  (RecentViewNode* destination, RecentViewNode* callNode);
    void            removeCall    (RecentViewNode* callNode               );
    void            selectNode    (RecentViewNode* node                   )  const;
+   int             row           (const RecentViewNode* node             )  const;
 
 private:
    RecentModel* q_ptr;
@@ -196,7 +196,7 @@ RecentModel::getParticipantNumber(Call *call) const
 
 void RecentModelPrivate::selectNode(RecentViewNode* node) const
 {
-   const auto idx = q_ptr->createIndex(node->m_Index, 0, node->m_pParent);
+   const auto idx = q_ptr->createIndex(row(node), 0, node->m_pParent);
 
    q_ptr->selectionModel()->setCurrentIndex(idx, QItemSelectionModel::ClearAndSelect);
 }
@@ -246,17 +246,12 @@ RecentModel::RecentModel(QObject* parent) : QAbstractItemModel(parent), d_ptr(ne
 
 RecentModel::~RecentModel()
 {
-   for (RecentViewNode* n : d_ptr->m_lTopLevelReverted)
-      delete n;
+   for (int i = 0; i < d_ptr->m_lTopLevel.size(); i++)
+      delete d_ptr->m_lTopLevel.at(i);
 
    delete d_ptr;
 }
 
-RecentViewNode::RecentViewNode()
-{
-
-}
-
 RecentViewNode::RecentViewNode(Call* c, RecentModelPrivate *model)
 {
     m_pModel            = model                     ;
@@ -359,11 +354,11 @@ RecentModel::getIndex(Call *call) const
 {
     // first check if it is a conference
     if (auto confNode = d_ptr->m_hConfToNodes.value(call))
-        return index(confNode->m_Index, 0);
+        return index(d_ptr->row(confNode), 0);
 
     if (auto callNode = d_ptr->m_hCallsToNodes.value(call)) {
         if (callNode->m_pParent)
-            return index(callNode->m_Index, 0, index(callNode->m_pParent->m_Index, 0));
+            return index(callNode->m_Index, 0, index(d_ptr->row(callNode->m_pParent), 0));
     }
 
     return {};
@@ -378,7 +373,7 @@ RecentModel::getIndex(Person *p) const
 {
     if (d_ptr->m_hPersonsToNodes.contains(p)) {
         if (auto node = d_ptr->m_hPersonsToNodes.value(p))
-            return index(node->m_Index, 0);
+            return index(d_ptr->row(node), 0);
     }
 
     return {};
@@ -393,7 +388,7 @@ RecentModel::getIndex(ContactMethod *cm) const
 {
     if (d_ptr->m_hCMsToNodes.contains(cm)) {
         if (auto node = d_ptr->m_hCMsToNodes.value(cm))
-            return index(node->m_Index, 0);
+            return index(d_ptr->row(node), 0);
     }
 
     return {};
@@ -543,7 +538,7 @@ QVariant RecentModel::data( const QModelIndex& index, int role ) const
 int RecentModel::rowCount( const QModelIndex& parent ) const
 {
    if (!parent.isValid())
-      return d_ptr->m_lTopLevelReverted.size();
+      return d_ptr->m_lTopLevel.size();
 
    RecentViewNode* node = static_cast<RecentViewNode*>(parent.internalPointer());
    return node->m_lChildren.size();
@@ -570,13 +565,13 @@ QModelIndex RecentModel::parent( const QModelIndex& index ) const
    if (!node->m_pParent)
       return QModelIndex();
 
-   return createIndex(node->m_pParent->m_Index, 0, node->m_pParent);
+   return createIndex(d_ptr->row(node->m_pParent), 0, node->m_pParent);
 }
 
 QModelIndex RecentModel::index( int row, int column, const QModelIndex& parent) const
 {
-   if (!parent.isValid() && row >= 0 && row < d_ptr->m_lTopLevelReverted.size() && !column)
-      return createIndex(row, 0, d_ptr->m_lTopLevelReverted[d_ptr->m_lTopLevelReverted.size() - 1 - row]);
+   if (!parent.isValid() && row >= 0 && row < d_ptr->m_lTopLevel.size() && !column)
+      return createIndex(row, 0, d_ptr->m_lTopLevel.at(row));
 
    if (!parent.isValid())
       return QModelIndex();
@@ -597,98 +592,62 @@ QVariant RecentModel::headerData( int section, Qt::Orientation orientation, int
    return QVariant();
 }
 
+///Return the row of a node, top level ones are computed in O(log n)
+int RecentModelPrivate::row(const RecentViewNode* node) const
+{
+   return node->m_pParent ? node->m_Index : m_lTopLevel.rank(node);
+}
+
 /*
  * Move rows around to keep the person/contactmethods ordered
- *
- * Further optimization:
- *  * Invert m_Index to avoid the O(N) loop when adding an item
  */
 void RecentModelPrivate::insertNode(RecentViewNode* n, time_t t, bool isNew)
 {
-   //Don't bother with the sorted insertion and indexes housekeeping
-   if (m_lTopLevelReverted.isEmpty()) {
-      q_ptr->beginInsertRows(QModelIndex(),0,0);
-      m_lTopLevelReverted << n;
-      q_ptr->endInsertRows();
-      return;
-   }
-
    //Compute the bounds, this is needed to use beginMoveRows
-   int newPos = 0;
-
-   if (m_lTopLevelReverted.last()->lastUsed() > t) {
-      //NOTE std::lower_bound need the "value" argument to be the same type as the iterator
-      //this use the m_Index field to hold the time_t
-      static RecentViewNode fake;
-      fake.m_Index = static_cast<long int>(t);
-
-      //NOTE Using std::lower_bound is officially supported on QList on all platforms
-      auto lower = std::lower_bound(m_lTopLevelReverted.begin(), m_lTopLevelReverted.end(), &fake,
-      [t](const RecentViewNode* a, const RecentViewNode* t2) -> bool {
-         return a->lastUsed() < t2->m_Index;
-      });
-
-      // the value pointed by the iterator returned by this function may also
-      // be equivalent to val, and not only greater
-      if (!isNew && n->m_Index == (*lower)->m_Index) {
-         newPos = (*lower)->m_Index;
-      } else
-         newPos = (*lower)->m_Index+1;
-   }
+   const int newPos = isNew ? m_lTopLevel.position(t) : m_lTopLevel.position(n, t);
 
    //Begin the transaction
    if (!isNew) {
-      if (newPos == n->m_Index)
-         return; //Nothing to do
-      if (not q_ptr->beginMoveRows(QModelIndex(), n->m_Index, n->m_Index, QModelIndex(), newPos)) {
-          qWarning() << "RecentModel: Invalid move detected index : " << n->m_Index
-                     << "newPos: " << newPos << "size: " << m_lTopLevelReverted.size();
+      const int oldPos = m_lTopLevel.rank(n);
+
+      //Only the key changes
+      if (newPos == oldPos) {
+         m_lTopLevel.remove(n);
+         m_lTopLevel.insert(n, t);
+         return;
+      }
+
+      //Qt expects the destination row before the move
+      if (not q_ptr->beginMoveRows(QModelIndex(), oldPos, oldPos, QModelIndex(), newPos > oldPos ? newPos + 1 : newPos)) {
+          qWarning() << "RecentModel: Invalid move detected index : " << oldPos
+                     << "newPos: " << newPos << "size: " << m_lTopLevel.size();
           return;
       }
-      m_lTopLevelReverted.removeAt(m_lTopLevelReverted.size()-1-n->m_Index);
+      m_lTopLevel.remove(n);
    }
    else
       q_ptr->beginInsertRows(QModelIndex(),newPos,newPos);
 
    //Apply the transaction
-   m_lTopLevelReverted.insert(m_lTopLevelReverted.size() - newPos,n);
-   for (int i = 0 ; i < m_lTopLevelReverted.size(); ++i) {
-      m_lTopLevelReverted[i]->m_Index = m_lTopLevelReverted.size() - 1 - i;
-   }
+   m_lTopLevel.insert(n, t);
 
    //Notify that the transaction is complete
    if (!isNew)
       q_ptr->endMoveRows();
    else
       q_ptr->endInsertRows();
-
-#if 0
-    //Uncomment if there is issues
-    qDebug() << "\n\nList:" << m_lTopLevelReverted.size() << isNew;
-    for (int i = 0; i<m_lTopLevelReverted.size();i++) {
-        qDebug() << "|||" << m_lTopLevelReverted[i]->lastUsed() << m_lTopLevelReverted[i]->m_Index << q_ptr->data(q_ptr->index(m_lTopLevelReverted.size()-1-i,0),Qt::DisplayRole);
-        for (auto child : m_lTopLevelReverted[i]->m_lChildren) {
-            qDebug() << "|||" << "|||" << child << child->m_uContent.m_pCall->formattedName();
-        }
-     }
-#endif
 }
 
 void RecentModelPrivate::removeNode(RecentViewNode* n)
 {
-   const int idx  = n->m_Index;
+   const int idx = m_lTopLevel.rank(n);
 
    q_ptr->beginRemoveRows(QModelIndex(), idx, idx);
 
-   m_lTopLevelReverted.removeOne(n);
+   m_lTopLevel.remove(n);
 
    delete n;
 
-   // update all indices after this one
-   for (int i = m_lTopLevelReverted.size() - 1 - idx; i >= 0; --i) {
-      --m_lTopLevelReverted[i]->m_Index;
-   }
-
    q_ptr->endRemoveRows();
 }
 
@@ -777,7 +736,7 @@ RecentModelPrivate::insertCallNode(RecentViewNode *parent, RecentViewNode* callN
     callNode->m_pParent = parent;
     callNode->m_Index = parent->m_lChildren.size();
 
-    auto parentIdx = q_ptr->index(parent->m_Index,0);
+    auto parentIdx = q_ptr->index(row(parent),0);
 
     q_ptr->beginInsertRows(parentIdx, callNode->m_Index, callNode->m_Index);
     parent->m_lChildren.append(callNode);
@@ -817,7 +776,7 @@ RecentModelPrivate::moveCallNode(RecentViewNode* destination, RecentViewNode* ca
     }
 
     auto parentNode = callNode->m_pParent;
-    auto parent = q_ptr->index(parentNode->m_Index, 0);
+    auto parent = q_ptr->index(row(parentNode), 0);
     const auto removedIndex = callNode->m_Index;
 
     q_ptr->beginRemoveRows(parent, removedIndex, removedIndex);
@@ -833,7 +792,7 @@ RecentModelPrivate::moveCallNode(RecentViewNode* destination, RecentViewNode* ca
 
     callNode->m_pParent = destination;
     callNode->m_Index = destination->m_lChildren.size();
-    auto destIdx = q_ptr->index(destination->m_Index, 0);
+    auto destIdx = q_ptr->index(row(destination), 0);
     q_ptr->beginInsertRows(destIdx, callNode->m_Index, callNode->m_Index);
     destination->m_lChildren.append(callNode);
     q_ptr->endInsertRows();
@@ -859,7 +818,7 @@ RecentModelPrivate::removeCall(RecentViewNode* callNode)
 
     // if it was in the RecentModel, then we need to emit rowsRemoved
     if (auto parentNode = callNode->m_pParent) {
-        auto parent = q_ptr->index(parentNode->m_Index, 0);
+        auto parent = q_ptr->index(row(parentNode), 0);
         const auto removedIndex = callNode->m_Index;
 
         q_ptr->beginRemoveRows(parent, removedIndex, removedIndex);
@@ -931,7 +890,7 @@ RecentModelPrivate::slotChanged(RecentViewNode *node)
         case RecentViewNode::Type::CONTACT_METHOD:
         case RecentViewNode::Type::CONFERENCE:
         {
-            auto idx = q_ptr->index(node->m_Index, 0);
+            auto idx = q_ptr->index(row(node), 0);
             emit q_ptr->dataChanged(idx, idx);
         }
         break;
@@ -939,7 +898,7 @@ RecentModelPrivate::slotChanged(RecentViewNode *node)
         {
             // make sure the Call has a parent, else try to find one
             if (node->m_pParent) {
-                auto parent = q_ptr->index(node->m_pParent->m_Index, 0);
+                auto parent = q_ptr->index(row(node->m_pParent), 0);
                 auto idx = q_ptr->index(node->m_Index, 0, parent);
                 emit q_ptr->dataChanged(parent, parent);
                 emit q_ptr->dataChanged(idx, idx);
@@ -50,7 +50,7 @@ const QString SecurityEvaluationModelPrivate::messages[enum_class_size<SecurityE
 static const QString s1 = QObject::tr("Your certificate is expired, please contact your system administrator.");
 static const QString s2 = QObject::tr("Your certificate is self signed. This break the chain of trust.");
 
-const TypedStateMachine< SecurityEvaluationModel::SecurityLevel , SecurityEvaluationModel::AccountSecurityChecks >
+constexpr TypedStateMachine< SecurityEvaluationModel::SecurityLevel , SecurityEvaluationModel::AccountSecurityChecks >
 SecurityEvaluationModelPrivate::maximumSecurityLevel = {{
    /* SRTP_ENABLED                     */ SecurityEvaluationModel::SecurityLevel::NONE        ,
    /* TLS_ENABLED                      */ SecurityEvaluationModel::SecurityLevel::NONE        ,
@@ -63,7 +63,7 @@ SecurityEvaluationModelPrivate::maximumSecurityLevel = {{
    /* NOT_MISSING_AUTHORITY            */ SecurityEvaluationModel::SecurityLevel::NONE        , //This won't work
 }};
 
-const TypedStateMachine< SecurityEvaluationModel::Severity , SecurityEvaluationModel::AccountSecurityChecks >
+constexpr TypedStateMachine< SecurityEvaluationModel::Severity , SecurityEvaluationModel::AccountSecurityChecks >
 SecurityEvaluationModelPrivate::flawSeverity = {{
    /* SRTP_ENABLED                      */ SecurityEvaluationModel::Severity::ISSUE           ,
    /* TLS_ENABLED                       */ SecurityEvaluationModel::Severity::ISSUE           ,
@@ -76,7 +76,7 @@ SecurityEvaluationModelPrivate::flawSeverity = {{
    /* NOT_MISSING_AUTHORITY             */ SecurityEvaluationModel::Severity::ERROR           ,
 }};
 
-const TypedStateMachine< SecurityEvaluationModel::SecurityLevel , Certificate::Checks > SecurityEvaluationModelPrivate::maximumCertificateSecurityLevel = {{
+constexpr TypedStateMachine< SecurityEvaluationModel::SecurityLevel , Certificate::Checks > SecurityEvaluationModelPrivate::maximumCertificateSecurityLevel = {{
    /* HAS_PRIVATE_KEY                   */ SecurityEvaluationModel::SecurityLevel::NONE       ,
    /* EXPIRED                           */ SecurityEvaluationModel::SecurityLevel::MEDIUM     ,
    /* STRONG_SIGNING                    */ SecurityEvaluationModel::SecurityLevel::WEAK       ,
@@ -100,7 +100,7 @@ const TypedStateMachine< SecurityEvaluationModel::SecurityLevel , Certificate::C
    /* ACTIVATED                         */ SecurityEvaluationModel::SecurityLevel::MEDIUM     , //TODO figure out of the impact of this
 }};
 
-static const Matrix1D<Certificate::Checks, bool> relevantWithoutPrivateKey = {
+static constexpr Matrix1D<Certificate::Checks, bool> relevantWithoutPrivateKey = {
    { Certificate::Checks::HAS_PRIVATE_KEY                  , false },
    { Certificate::Checks::EXPIRED                          , true  },
    { Certificate::Checks::STRONG_SIGNING                   , true  },
@@ -124,7 +124,7 @@ static const Matrix1D<Certificate::Checks, bool> relevantWithoutPrivateKey = {
    { Certificate::Checks::ACTIVATED                        , true  },
 };
 
-const TypedStateMachine< SecurityEvaluationModel::Severity      , Certificate::Checks > SecurityEvaluationModelPrivate::certificateFlawSeverity = {{
+constexpr TypedStateMachine< SecurityEvaluationModel::Severity      , Certificate::Checks > SecurityEvaluationModelPrivate::certificateFlawSeverity = {{
    /* HAS_PRIVATE_KEY                   */ SecurityEvaluationModel::Severity::ERROR           ,
    /* EXPIRED                           */ SecurityEvaluationModel::Severity::WARNING         ,
    /* STRONG_SIGNING                    */ SecurityEvaluationModel::Severity::ISSUE           ,
@@ -273,7 +273,7 @@ private:
 constexpr const short CombinaisonProxyModel::sizes[];
 
 ///Create a callback map for signals to avoid a large switch(){} in the code
-static const Matrix1D<SecurityEvaluationModel::Severity, void(SecurityEvaluationModel::*)()> m_lSignalMap = {{
+static constexpr Matrix1D<SecurityEvaluationModel::Severity, void(SecurityEvaluationModel::*)()> m_lSignalMap = {{
    /* UNSUPPORTED   */ nullptr                                           ,
    /* INFORMATION   */ &SecurityEvaluationModel::informationCountChanged ,
    /* WARN1NG       */ &SecurityEvaluationModel::warningCountChanged     ,
@@ -20,8 +20,13 @@
 #include "private/matrixutils.h"
 
 #include <QRegularExpression>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QSharedData>
 
-class URIPrivate
+//Std
+#include <algorithm>
+
+class URIPrivate : public QSharedData
 {
 public:
    ///Strings associated with SchemeType
@@ -41,42 +46,66 @@ public:
       constexpr static const char TAG      [] = "tag"      ;
    };
 
+   ///Purge the unused interned entries of a shard past this size
+   constexpr static const int INTERN_LIMIT  = 512;
+
+   ///Number of independently locked interning tables
+   constexpr static const int INTERN_SHARD_BITS = 4;
+   constexpr static const int INTERN_SHARDS     = 1 << INTERN_SHARD_BITS;
+
+   ///A string and its hash, it is computed once to select the shard and for its table
+   struct InternKey {
+      QString string;
+      uint    hash  ;
+
+      bool operator==(const InternKey& other) const {
+         return hash == other.hash && string == other.string;
+      }
+
+      friend uint qHash(const InternKey& key, uint seed) {
+         return qHash(key.hash, seed);
+      }
+   };
+
+   ///An interning table, the lookups only take the read lock
+   struct InternShard {
+      QReadWriteLock                                               lock ;
+      QHash<InternKey, QExplicitlySharedDataPointer<URIPrivate> > table;
+      int                                                          limit;
+   };
+
    //Constructor
-   URIPrivate(URI* uri);
-   void commonCopyConstructor(const URI& o);
+   explicit URIPrivate(const QString& uri);
 
    //Attributes
    QString           m_ExtHostname ;
    QString           m_Userinfo    ;
-   QStringList       m_lAttributes ;
    QString           m_Stripped    ;
    QString           m_Hostname2   ;
    QByteArray        m_Tag         ;
    URI::SchemeType   m_HeaderType  ;
    URI::Transport    m_Transport   ;
-   bool              m_hasChevrons ;
-   bool              m_Parsed      ;
    bool              m_HasAt       ;
    URI::ProtocolHint m_ProtocolHint;
-   bool              m_HintParsed  ;
-   bool              m_IsHNParsed  ;
    int               m_Port        ;
+   uint              m_Hash        ;
 
    //Helper
    static QString strip(const QString& uri, URI::SchemeType& scheme);
+   static QExplicitlySharedDataPointer<URIPrivate> intern(const QString& uri);
+   static QExplicitlySharedDataPointer<URIPrivate> empty();
    void parse();
    void parseHostname();
+   URI::ProtocolHint computeProtocolHint() const;
    static bool checkIp(const QString& str, bool &isHash, const URI::SchemeType& scheme);
    URI::Transport nameToTransport(const QByteArray& name);
    void parseAttribute(const QByteArray& extHn, const int start, const int pos);
-private:
-   URI* q_ptr;
 };
 
 constexpr const char  URIPrivate::Constants::TRANSPORT[];
 constexpr const char  URIPrivate::Constants::TAG      [];
 
-const Matrix1D<URI::Transport, const char*> URIPrivate::transportNames = {{
+constexpr Matrix1D<URI::Transport, const char*> URIPrivate::transportNames = {{
    /*NOT_SET*/ "NOT_SET",
    /*TLS    */ "TLS"    ,
    /*tls    */ "tls"    ,
@@ -90,7 +119,7 @@ const Matrix1D<URI::Transport, const char*> URIPrivate::transportNames = {{
    /*dtls   */ "dtls"   ,
 }};
 
-const Matrix1D<URI::SchemeType, const char*> URIPrivate::schemeNames = {{
+constexpr Matrix1D<URI::SchemeType, const char*> URIPrivate::schemeNames = {{
    /*NONE = */ ""     ,
    /*SIP  = */ "sip:" ,
    /*SIPS = */ "sips:",
@@ -108,63 +137,113 @@ const QRegularExpression URIPrivate::endWhitespaceMatcher = QRegularExpression(
                                                    URIPrivate::whitespaceCharClass + "$",
                                                    QRegularExpression::UseUnicodePropertiesOption);
 
-URIPrivate::URIPrivate(URI* uri) : m_Parsed(false),m_HeaderType(URI::SchemeType::NONE),q_ptr(uri),
-m_hasChevrons(false),m_HasAt(false),m_ProtocolHint(URI::ProtocolHint::SIP_OTHER),m_HintParsed(false),
-m_IsHNParsed(false),m_Port(-1),m_Transport(URI::Transport::NOT_SET)
+///Parse everything once, the data is shared and never modified afterward
+URIPrivate::URIPrivate(const QString& uri) : m_HeaderType(URI::SchemeType::NONE),
+m_Transport(URI::Transport::NOT_SET),m_HasAt(false),m_ProtocolHint(URI::ProtocolHint::SIP_OTHER),
+m_Port(-1)
+{
+   m_Stripped = strip(uri, m_HeaderType);
+   parse();
+   parseHostname();
+   m_ProtocolHint = computeProtocolHint();
+   m_Hash         = qHash(m_Stripped);
+}
+
+/**
+ * Return the shared data for this string, parse it only if it has not been
+ * seen yet.
+ *
+ * The strings are spread over INTERN_SHARDS tables. Finding an existing entry
+ * only takes the read lock of its table, so the lookups done on the number
+ * resolution hot path run concurrently and never wait on each other. The
+ * reference is taken before the lock is released, a purge cannot free it.
+ *
+ * Each table keeps a reference on its entries. When one grows past its
+ * limit, the entries no longer used by any URI are dropped.
+ */
+QExplicitlySharedDataPointer<URIPrivate> URIPrivate::intern(const QString& uri)
+{
+   static InternShard shards[INTERN_SHARDS];
+
+   const InternKey key { uri, qHash(uri) };
+
+   //The top bits select the shard, the tables use the whole hash
+   InternShard& shard = shards[key.hash >> (32 - INTERN_SHARD_BITS)];
+
+   {
+      QReadLocker locker(&shard.lock);
+
+      const auto it = shard.table.constFind(key);
+
+      if (it != shard.table.constEnd())
+         return *it;
+   }
+
+   QWriteLocker locker(&shard.lock);
+
+   //It may have been added while the lock was released
+   const auto it = shard.table.constFind(key);
+
+   if (it != shard.table.constEnd())
+      return *it;
+
+   if (shard.table.size() >= std::max(INTERN_LIMIT, shard.limit)) {
+      //Only the table hold a reference, no URI can get it back without the lock
+      for (auto i = shard.table.begin(); i != shard.table.end();) {
+         if ((*i)->ref.load() == 1)
+            i = shard.table.erase(i);
+         else
+            ++i;
+      }
+
+      shard.limit = std::max(INTERN_LIMIT, shard.table.size() * 2);
+   }
+
+   const QExplicitlySharedDataPointer<URIPrivate> d(new URIPrivate(uri));
+   shard.table.insert(key, d);
+
+   return d;
+}
+
+QExplicitlySharedDataPointer<URIPrivate> URIPrivate::empty()
 {
+   static const QExplicitlySharedDataPointer<URIPrivate> e(new URIPrivate(QString()));
+   return e;
 }
 
 ///Default constructor
-URI::URI() : QString(), d_ptr(new URIPrivate(this))
+URI::URI() : QString(), d_ptr(URIPrivate::empty())
 {
 
 }
 
 ///Constructor
-URI::URI(const QString& other) : URI()
+URI::URI(const QString& other) : QString(), d_ptr(other.isEmpty() ? URIPrivate::empty() : URIPrivate::intern(other))
 {
-   d_ptr->m_Stripped              = URIPrivate::strip(other,d_ptr->m_HeaderType);
-   (*static_cast<QString*>(this)) = d_ptr->m_Stripped                           ;
+   (*static_cast<QString*>(this)) = d_ptr->m_Stripped;
 }
 
 ///Copy constructor
-URI::URI(const URI& o) : URI()
+URI::URI(const URI& o) : QString(o), d_ptr(o.d_ptr)
 {
-   d_ptr->commonCopyConstructor(o);
 }
 
 ///Destructor
 URI::~URI()
 {
-   (*static_cast<QString*>(this)) = QString();
-   d_ptr->m_Stripped = QString();
-//    delete d_ptr;
 }
 
-void URIPrivate::commonCopyConstructor(const URI& o)
+/// Copy operator, the parsed data is shared
+URI& URI::operator=(const URI& o)
 {
-   //TODO see if a copy on write kind of algo could be used for this
-   m_Parsed       = o.d_ptr->m_Parsed      ;
-   m_HintParsed   = o.d_ptr->m_HintParsed  ;
-   m_ExtHostname  = o.d_ptr->m_ExtHostname ;
-   m_HasAt        = o.d_ptr->m_HasAt       ;
-   m_ProtocolHint = o.d_ptr->m_ProtocolHint;
-   m_HeaderType   = o.d_ptr->m_HeaderType  ;
-   m_Userinfo     = o.d_ptr->m_Userinfo    ;
-   m_Stripped     = o.d_ptr->m_Stripped    ;
-   m_IsHNParsed   = o.d_ptr->m_IsHNParsed  ;
-   m_Port         = o.d_ptr->m_Port        ;
-   m_Transport    = o.d_ptr->m_Transport   ;
-   m_Tag          = o.d_ptr->m_Tag         ;
-
-   (*static_cast<QString*>(q_ptr)) = o.d_ptr->m_Stripped;
+   (*static_cast<QString*>(this)) = o;
+   d_ptr = o.d_ptr;
+   return (*this);
 }
 
-/// Copy operator, make sure the cache is also copied
-URI& URI::operator=(const URI& o)
+uint qHash(const URI& uri, uint seed)
 {
-   d_ptr->commonCopyConstructor(o);
-   return (*this);
+   return qHash(uri.d_ptr->m_Hash, seed);
 }
 
 ///Strip out <sip:****> from the URI
@@ -230,8 +309,6 @@ QString URIPrivate::strip(const QString& uri, URI::SchemeType& scheme)
  */
 QString URI::hostname() const
 {
-   if (!d_ptr->m_Parsed)
-      const_cast<URI*>(this)->d_ptr->parse();
    return d_ptr->m_ExtHostname;
 }
 
@@ -242,8 +319,6 @@ QString URI::hostname() const
  */
 bool URI::hasHostname() const
 {
-   if (!d_ptr->m_Parsed)
-      const_cast<URI*>(this)->d_ptr->parse();
    return !d_ptr->m_ExtHostname.isEmpty();
 }
 
@@ -253,9 +328,6 @@ bool URI::hasHostname() const
  */
 bool URI::hasPort() const
 {
-   if (!d_ptr->m_IsHNParsed) {
-      d_ptr->parseHostname();
-   }
    return d_ptr->m_Port != -1;
 }
 
@@ -264,9 +336,6 @@ bool URI::hasPort() const
  */
 int  URI::port() const
 {
-   if (!d_ptr->m_IsHNParsed) {
-      d_ptr->parseHostname();
-   }
    return d_ptr->m_Port;
 }
 
@@ -275,8 +344,6 @@ int  URI::port() const
  */
 URI::SchemeType URI::schemeType() const
 {
-   if (!d_ptr->m_Parsed)
-      const_cast<URI*>(this)->d_ptr->parse();
    return d_ptr->m_HeaderType;
 }
 
@@ -334,42 +401,38 @@ bool URIPrivate::checkIp(const QString& str, bool &isHash, const URI::SchemeType
 /**
  * This method return an hint to guess the protocol that could be used to call
  * this URI. It is a quick guess, not something that should be trusted
- *
- * @warning, this method is O(N) when called for the first time on an URI
  */
 URI::ProtocolHint URI::protocolHint() const
 {
-   if (!d_ptr->m_Parsed)
-      const_cast<URI*>(this)->d_ptr->parse();
-
-   if (!d_ptr->m_HintParsed) {
-      bool isHash = d_ptr->m_Userinfo.size() == 40;
-      d_ptr->m_ProtocolHint = \
-        (
-         //Step one    : Check IAX protocol, is has already been detected at this point
-         d_ptr->m_HeaderType == URI::SchemeType::IAX2 || d_ptr->m_HeaderType == URI::SchemeType::IAX
-            ? URI::ProtocolHint::IAX
-
-      : (
-         //Step two  : check IP
-         URIPrivate::checkIp(d_ptr->m_Userinfo,isHash,d_ptr->m_HeaderType) ? URI::ProtocolHint::IP
-
-      : (
-         //Step three    : Check RING protocol, is has already been detected at this point
-         (d_ptr->m_HeaderType == URI::SchemeType::RING && isHash) || (isHash && d_ptr->m_Userinfo.size() == 40)
-            ? URI::ProtocolHint::RING
-
-      : (
-         //Step four   : Differentiate between ***@*** and *** type URIs
-         d_ptr->m_HasAt ? URI::ProtocolHint::SIP_HOST : URI::ProtocolHint::SIP_OTHER
-
-        ))));
-
-        d_ptr->m_HintParsed = true;
-   }
    return d_ptr->m_ProtocolHint;
 }
 
+///O(N), computed once when the URI is interned
+URI::ProtocolHint URIPrivate::computeProtocolHint() const
+{
+   bool isHash = m_Userinfo.size() == 40;
+   return \
+     (
+      //Step one    : Check IAX protocol, is has already been detected at this point
+      m_HeaderType == URI::SchemeType::IAX2 || m_HeaderType == URI::SchemeType::IAX
+         ? URI::ProtocolHint::IAX
+
+   : (
+      //Step two  : check IP
+      URIPrivate::checkIp(m_Userinfo,isHash,m_HeaderType) ? URI::ProtocolHint::IP
+
+   : (
+      //Step three    : Check RING protocol, is has already been detected at this point
+      (m_HeaderType == URI::SchemeType::RING && isHash) || (isHash && m_Userinfo.size() == 40)
+         ? URI::ProtocolHint::RING
+
+   : (
+      //Step four   : Differentiate between ***@*** and *** type URIs
+      m_HasAt ? URI::ProtocolHint::SIP_HOST : URI::ProtocolHint::SIP_OTHER
+
+     ))));
+}
+
 ///Convert the transport name to a string
 URI::Transport URIPrivate::nameToTransport(const QByteArray& name)
 {
@@ -398,19 +461,18 @@ URI::Transport URIPrivate::nameToTransport(const QByteArray& name)
    return URI::Transport::NOT_SET   ;
 }
 
-///Keep a cache of the values to avoid re-parsing them
+///Split the userinfo and hostname
 void URIPrivate::parse()
 {
-   //FIXME the indexOf is done twice, the second time could be avoided
-   if (q_ptr->indexOf('@') != -1) {
-      const QStringList split = q_ptr->split('@');
+   const int at = m_Stripped.indexOf('@');
+
+   if (at != -1) {
       m_HasAt       = true;
-      m_ExtHostname = split[1];
-      m_Userinfo    = split[0];
-      m_Parsed      = true;
+      m_Userinfo    = m_Stripped.left(at);
+      m_ExtHostname = m_Stripped.mid(at + 1).section('@', 0, 0);
    }
    else
-      m_Userinfo = (*q_ptr);
+      m_Userinfo = m_Stripped;
 }
 
 void URIPrivate::parseAttribute(const QByteArray& extHn, const int start, const int pos)
@@ -430,17 +492,14 @@ void URIPrivate::parseAttribute(const QByteArray& extHn, const int start, const
 ///Extract the hostname, port and attributes
 void URIPrivate::parseHostname()
 {
-   if (!m_Parsed)
-      parse();
-
-   const QByteArray extHn = q_ptr->hostname().toLatin1();
+   const QByteArray extHn = m_ExtHostname.toLatin1();
    int length(extHn.size()), start(0);
    bool inAttributes = false;
 
    URI::Section section = URI::Section::HOSTNAME;
 
    // in case no port, attributes, etc are provided
-   m_Hostname2 = q_ptr->hostname();
+   m_Hostname2 = m_ExtHostname;
 
    for (int i = 0; i < length; i++) {
       const char c = extHn[i];
@@ -496,8 +555,6 @@ void URIPrivate::parseHostname()
 
    ///Get the remaining attribute
    parseAttribute(extHn, start, length-1);
-
-   m_IsHNParsed = true;
 }
 
 /**
@@ -507,8 +564,6 @@ void URIPrivate::parseHostname()
  */
 QString URI::userinfo() const
 {
-   if (!d_ptr->m_Parsed)
-      const_cast<URI*>(this)->d_ptr->parse();
    return d_ptr->m_Userinfo;
 }
 
@@ -520,10 +575,6 @@ QString URI::userinfo() const
  */
 QString URI::format(FlagPack<URI::Section> sections) const
 {
-   if (!d_ptr->m_IsHNParsed) {
-      d_ptr->parseHostname();
-   }
-
    QString ret;
 
    if (sections & URI::Section::CHEVRONS)
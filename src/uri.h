@@ -20,6 +20,7 @@
 #include "typedefs.h"
 
 #include <QStringList>
+#include <QtCore/QExplicitlySharedDataPointer>
 
 class URIPrivate;
 class QDataStream;
@@ -74,10 +75,16 @@ class QDataStream;
     *    such as "name;v=1.1" to indicate a reference to version 1.1 of
     *    "name", whereas another might use a segment such as "name,1.1" to
     *    indicate the same. "
+    *
+    * The parsed sections are immutable and interned: constructing an URI from
+    * a string already seen reuse the same data and copying an URI only bump a
+    * reference count. The string itself must not be modified in place, the
+    * sections would no longer match.
     */
 class LIB_EXPORT URI : public QString
 {
    friend class URIPrivate;
+   friend LIB_EXPORT uint qHash(const URI& uri, uint seed);
 public:
 
    ///Default constructor
@@ -195,10 +202,13 @@ public:
    URI& operator=(const URI&);
 
 private:
-   const QScopedPointer<URIPrivate> d_ptr;
+   QExplicitlySharedDataPointer<URIPrivate> d_ptr;
 };
 Q_DECLARE_METATYPE(URI)
 
+///Use the hash computed when the URI was parsed
+LIB_EXPORT uint qHash(const URI& uri, uint seed = 0);
+
 Q_DECLARE_METATYPE(URI::ProtocolHint)
 
 DECLARE_ENUM_FLAGS(URI::Section)
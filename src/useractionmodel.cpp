@@ -17,6 +17,10 @@
  ***************************************************************************/
 #include "useractionmodel.h"
 
+//Std
+#include <algorithm>
+#include <iterator>
+
 //Qt
 #include <QtCore/QItemSelection>
 #include <QtCore/QSortFilterProxyModel>
@@ -79,20 +83,50 @@ public:
 
    static const Matrix2D< UAM::Action, SelectionState, UAM::ActionStatfulnessLevel > actionStatefulness;
 
+   ///One bit per action
+   typedef quint32 ActionMask;
+   static_assert(enum_class_size<UAM::Action>() <= 32, "The actions no longer fit in an ActionMask");
+
+   /**
+    * The availability matrices folded into one action mask per state. Reading
+    * the matrices cell by cell for every selected item is too slow, so this
+    * is computed once and the selection is reduced with bitwise operations.
+    */
+   struct ActionMasks {
+      ActionMasks();
+
+      ActionMask byCallState   [ enum_class_size< Call::State                >() ];
+      ActionMask byRegistration[ enum_class_size< Account::RegistrationState >() ];
+      ActionMask bySelection   [ enum_class_size< SelectionState             >() ];
+      ActionMask byProtocol    [ enum_class_size< Account::Protocol          >() ];
+      ActionMask byObjectType  [ enum_class_size< Ring::ObjectType           >() ];
+      bool     (*person        [ enum_class_size< UAM::Action                >() ])(const Person*       );
+      bool     (*contactMethod [ enum_class_size< UAM::Action                >() ])(const ContactMethod*);
+      ActionMask personCallbacks       ;
+      ActionMask contactMethodCallbacks;
+      ActionMask heterogenous          ;
+      ActionMask stateful              ;
+   };
+   static const ActionMasks& masks();
+
+   static constexpr ActionMask bit(UAM::Action action) {
+      return ActionMask(1) << static_cast<int>(action);
+   }
 
    //Helpers
-   bool updateAction         (UAM::Action action                          );
-   bool updateByCall         (UAM::Action action, const Call* c           );
-   bool updateByContactMethod(UAM::Action action, const ContactMethod* cm );
-   bool updateByAccount      (UAM::Action action, const Account* a        );
-   bool updateByPerson       (UAM::Action action, const Person* p         );
-   void updateCheckMask      (int& ret, UAM::Action action, const Call* c );
+   ActionMask maskByCall         (const Call* c          , const Account* fallback                ) const;
+   ActionMask maskByContactMethod(const ContactMethod* cm, const Account* fallback, ActionMask cand) const;
+   ActionMask maskByAccount      (const Account* a                                                ) const;
+   ActionMask maskByPerson       (const Person* p        , ActionMask cand                        ) const;
+   ActionMask checkedByCall      (const Call* c                                                   ) const;
+   ActionMask updateLabels       (const Call* c                                                   );
 
    //Attributes
    Call*                                  m_pCall              ;
    UserActionModelMode                    m_Mode               ;
    SelectionState                         m_SelectionState     ;
-   TypedStateMachine< bool, UAM::Action>  m_CurrentActions     ;
+   ActionMask                             m_CurrentActions  {0};
+   ActionMask                             m_ContextMask        ;
    Matrix1D< UAM::Action, Qt::CheckState> m_CurrentActionsState;
    Matrix1D< UAM::Action, QString>        m_ActionNames        ;
    ActiveUserActionModel*                 m_pActiveModel       ;
@@ -120,7 +154,7 @@ public Q_SLOTS:
 #define UAMA UserActionModel::Action
 #define CS Call::State
 //Enabled actions
-static EnumClassReordering<Call::State> co = {
+static constexpr EnumClassReordering<Call::State> co = {
    CS::NEW            , /* >----------|                                                                                                                       */
    CS::INCOMING       , /* -----------|-------|                                                                                                               */
    CS::RINGING        , /* -----------|-------|-------|                                                                                                       */
@@ -140,7 +174,7 @@ static EnumClassReordering<Call::State> co = {
    CS::CONNECTED      , /* -----------|-------|-------|------|-----|-------|------|------|-----|-------|------|-----|------|------|-------|------|-----|      */
 };                      /*            |       |       |      |     |       |      |      |     |       |      |     |      |      |       |      |     |      */
                         /*            \/      \/      \/     \/    \/      \/     \/     \/    \/      \/     \/    \/     \/     \/      \/     \/    \/     */
-const Matrix2D< UAM::Action, Call::State, bool > UserActionModelPrivate::availableActionMap = {
+constexpr Matrix2D< UAM::Action, Call::State, bool > UserActionModelPrivate::availableActionMap = {
  { UAMA::ACCEPT            , {{co, { false, true  , false, false, true , false, false, false, false, false, false, false, false, false, false, false, false }}}},
  { UAMA::HOLD              , {{co, { false, false , false, true , false, true , false, false, false, false, false, false, true , false, false, false, false }}}},
  { UAMA::MUTE_AUDIO        , {{co, { false, false , true , true , false, false, false, false, false, false, false, false, false, false, false, false, false }}}},
@@ -169,7 +203,7 @@ const Matrix2D< UAM::Action, Call::State, bool > UserActionModelPrivate::availab
  * Assuming a call is in progress, the communication can still be valid if the account is down, however,
  * this will impact the available actions
  */
-const Matrix2D< UAMA, Account::RegistrationState, bool > UserActionModelPrivate::availableAccountActionMap = {
+constexpr Matrix2D< UAMA, Account::RegistrationState, bool > UserActionModelPrivate::availableAccountActionMap = {
    /*                             READY  UNREGISTERED  TRYING    ERROR   */
    { UAMA::ACCEPT            , {{ true ,    false,     false,    false  }}},
    { UAMA::HOLD              , {{ true ,    false,     false,    false  }}},
@@ -199,7 +233,7 @@ const Matrix2D< UAMA, Account::RegistrationState, bool > UserActionModelPrivate:
 /**
  * This matrix define if an option is available depending on the number of selection elements
  */
-const Matrix2D< UAMA, UserActionModelPrivate::SelectionState, bool > UserActionModelPrivate::multi_call_options = {
+constexpr Matrix2D< UAMA, UserActionModelPrivate::SelectionState, bool > UserActionModelPrivate::multi_call_options = {
    /*                             NONE   UNIQUE   MULTI  */
    { UAMA::ACCEPT            , {{ false,  true ,  true  }}},
    { UAMA::HOLD              , {{ false,  true ,  false }}},
@@ -229,7 +263,7 @@ const Matrix2D< UAMA, UserActionModelPrivate::SelectionState, bool > UserActionM
 /**
  * This matrix define if an option is available when multiple elements with mismatching CheckState are selected
  */
-const Matrix1D< UAMA, bool > UserActionModelPrivate::heterogenous_call_options = {
+constexpr Matrix1D< UAMA, bool > UserActionModelPrivate::heterogenous_call_options = {
    { UAMA::ACCEPT            , true  }, /* N/A                                       */
    { UAMA::HOLD              , false }, /* Do not allow to set a state               */
    { UAMA::MUTE_AUDIO        , true  }, /* Force mute on all calls                   */
@@ -258,7 +292,7 @@ const Matrix1D< UAMA, bool > UserActionModelPrivate::heterogenous_call_options =
 /**
  * This matrix allow to enable/disable actions depending on the call protocol
  */
-const Matrix2D< UAMA, Account::Protocol, bool > UserActionModelPrivate::availableProtocolActions = {
+constexpr Matrix2D< UAMA, Account::Protocol, bool > UserActionModelPrivate::availableProtocolActions = {
    /*                              SIP    IAX    DHT   */
    { UAMA::ACCEPT            , {{ true , true , true  }}},
    { UAMA::HOLD              , {{ true , true , true  }}},
@@ -293,7 +327,7 @@ const Matrix2D< UAMA, Account::Protocol, bool > UserActionModelPrivate::availabl
  * called "TRISTATE".
  */
 #define ST UserActionModel::ActionStatfulnessLevel::
-const Matrix2D< UAMA, UserActionModelPrivate::SelectionState, UserActionModel::ActionStatfulnessLevel > UserActionModelPrivate::actionStatefulness = {
+constexpr Matrix2D< UAMA, UserActionModelPrivate::SelectionState, UserActionModel::ActionStatfulnessLevel > UserActionModelPrivate::actionStatefulness = {
    /*                                NONE          UNIQUE             MULTI       */
    { UAMA::ACCEPT            , {{ ST UNISTATE,  ST UNISTATE     ,  ST UNISTATE  }}},
    { UAMA::HOLD              , {{ ST UNISTATE,  ST CHECKABLE    ,  ST TRISTATE  }}},
@@ -392,7 +426,7 @@ const Matrix1D< UAMA, FlagPack<UAM::Asset>> UserActionModelPrivate::availableByA
 /**
  * Different objects type have access to a different subset of actions
  */
-const Matrix2D< UAMA, Ring::ObjectType , bool  > UserActionModelPrivate::availableObjectActions = {
+constexpr Matrix2D< UAMA, Ring::ObjectType , bool  > UserActionModelPrivate::availableObjectActions = {
    /*                            Person ContactMethod  Call    Media  Certificate */
    { UAMA::ACCEPT            , {{ false,    false,     true ,  false,    false   }}},
    { UAMA::HOLD              , {{ false,    false,     true ,  true ,    false   }}},
@@ -503,8 +537,13 @@ const Matrix1D< UAM::Action, bool(*)(const ContactMethod*)> UserActionModelPriva
 #undef CM_CB
 
 UserActionModelPrivate::UserActionModelPrivate(UserActionModel* parent, const FlagPack<UAM::Context>& c) : QObject(parent),q_ptr(parent),
-m_pCall(nullptr), m_pActiveModel(nullptr), m_fContext(c)
+m_pCall(nullptr), m_ContextMask(0), m_pActiveModel(nullptr), m_fContext(c)
 {
+   for (const UAM::Action action : EnumIterator<UAM::Action>()) {
+      if (actionContext[action] & m_fContext)
+         m_ContextMask |= bit(action);
+   }
+
    //Init the default names
    m_ActionNames = {
       { UAMA::ACCEPT            , QObject::tr("Accept"                 )},
@@ -653,7 +692,7 @@ Qt::ItemFlags UserActionModel::flags(const QModelIndex& idx ) const
 
    UserActionModel::Action action = static_cast<UserActionModel::Action>(idx.row());
 
-   return (d_ptr->m_CurrentActions[action] ? (Qt::ItemIsEnabled | Qt::ItemIsSelectable) : Qt::NoItemFlags)
+   return ((d_ptr->m_CurrentActions & d_ptr->bit(action)) ? (Qt::ItemIsEnabled | Qt::ItemIsSelectable) : Qt::NoItemFlags)
       | (d_ptr->actionStatefulness[action][d_ptr->m_SelectionState] != UserActionModel::ActionStatfulnessLevel::UNISTATE
       ? Qt::ItemIsUserCheckable : Qt::NoItemFlags);
 }
@@ -669,7 +708,7 @@ bool UserActionModel::setData(const QModelIndex& index, const QVariant &value, i
 
 bool UserActionModel::isActionEnabled( UserActionModel::Action action ) const
 {
-   return d_ptr->availableActionMap[action][d_ptr->m_pCall->state()];
+   return d_ptr->masks().byCallState[static_cast<int>(d_ptr->m_pCall->state())] & d_ptr->bit(action);
 }
 
 void UserActionModelPrivate::slotStateChanged()
@@ -677,270 +716,340 @@ void UserActionModelPrivate::slotStateChanged()
    emit q_ptr->actionStateChanged();
 }
 
-void UserActionModelPrivate::updateCheckMask(int& ret, UserActionModel::Action action, const Call* c)
+UserActionModelPrivate::ActionMasks::ActionMasks() :
+personCallbacks(0), contactMethodCallbacks(0), heterogenous(0),
+stateful(
+   bit( UserActionModel::Action::HOLD            ) |
+   bit( UserActionModel::Action::MUTE_AUDIO      ) |
+   bit( UserActionModel::Action::MUTE_VIDEO      ) |
+   bit( UserActionModel::Action::SERVER_TRANSFER ) |
+   bit( UserActionModel::Action::RECORD          )
+)
+{
+   std::fill(std::begin(byCallState   ), std::end(byCallState   ), 0);
+   std::fill(std::begin(byRegistration), std::end(byRegistration), 0);
+   std::fill(std::begin(bySelection   ), std::end(bySelection   ), 0);
+   std::fill(std::begin(byProtocol    ), std::end(byProtocol    ), 0);
+   std::fill(std::begin(byObjectType  ), std::end(byObjectType  ), 0);
+
+   for (const UserActionModel::Action action : EnumIterator<UserActionModel::Action>()) {
+      const ActionMask b = bit(action);
+
+      for (const Call::State st : EnumIterator<Call::State>())
+         byCallState[static_cast<int>(st)] |= availableActionMap[action][st] ? b : 0;
+
+      for (const Account::RegistrationState st : EnumIterator<Account::RegistrationState>())
+         byRegistration[static_cast<int>(st)] |= availableAccountActionMap[action][st] ? b : 0;
+
+      for (const SelectionState st : EnumIterator<SelectionState>())
+         bySelection[static_cast<int>(st)] |= multi_call_options[action][st] ? b : 0;
+
+      for (const Account::Protocol proto : EnumIterator<Account::Protocol>())
+         byProtocol[static_cast<int>(proto)] |= availableProtocolActions[action][proto] ? b : 0;
+
+      for (const Ring::ObjectType t : EnumIterator<Ring::ObjectType>())
+         byObjectType[static_cast<int>(t)] |= availableObjectActions[action][t] ? b : 0;
+
+      person       [static_cast<int>(action)] = personActionAvailability[action];
+      contactMethod[static_cast<int>(action)] = cmActionAvailability    [action];
+
+      personCallbacks        |= person       [static_cast<int>(action)] ? b : 0;
+      contactMethodCallbacks |= contactMethod[static_cast<int>(action)] ? b : 0;
+      heterogenous           |= heterogenous_call_options[action]       ? b : 0;
+   }
+}
+
+const UserActionModelPrivate::ActionMasks& UserActionModelPrivate::masks()
+{
+   static const ActionMasks m;
+   return m;
+}
+
+UserActionModelPrivate::ActionMask UserActionModelPrivate::maskByAccount(const Account* a) const
+{
+   if (!a)
+      return 0;
+
+   return masks().byRegistration[ static_cast<int>(a->registrationState()) ]
+        & masks().byProtocol    [ static_cast<int>(a->protocol()         ) ];
+}
+
+UserActionModelPrivate::ActionMask UserActionModelPrivate::maskByCall(const Call* c, const Account* fallback) const
+{
+   if (!c)
+      return 0;
+
+   return masks().byCallState[ static_cast<int>(c->state()         ) ]
+        & masks().bySelection[ static_cast<int>(m_SelectionState   ) ]
+        & m_ContextMask
+        & maskByAccount(c->account() ? c->account() : fallback);
+}
+
+///Only the candidate actions callbacks are evaluated
+UserActionModelPrivate::ActionMask UserActionModelPrivate::maskByContactMethod(const ContactMethod* cm, const Account* fallback, ActionMask cand) const
+{
+   if (!cm)
+      return 0;
+
+   ActionMask ret = maskByAccount(cm->account() ? cm->account() : fallback);
+
+   for (const UserActionModel::Action action : EnumIterator<UserActionModel::Action>()) {
+      if ((ret & cand & masks().contactMethodCallbacks & bit(action)) && !masks().contactMethod[static_cast<int>(action)](cm))
+         ret &= ~bit(action);
+   }
+
+   return ret;
+}
+
+UserActionModelPrivate::ActionMask UserActionModelPrivate::maskByPerson(const Person* p, ActionMask cand) const
+{
+   if (!p)
+      return 0;
+
+   ActionMask ret = ~ActionMask(0);
+
+   for (const UserActionModel::Action action : EnumIterator<UserActionModel::Action>()) {
+      if ((cand & masks().personCallbacks & bit(action)) && !masks().person[static_cast<int>(action)](p))
+         ret &= ~bit(action);
+   }
+
+   return ret;
+}
+
+///The stateful actions currently checked for that call
+UserActionModelPrivate::ActionMask UserActionModelPrivate::checkedByCall(const Call* c) const
 {
    //TODO c will be nullptr if the selection is a person or a contact method
    //there is still a need to update the check mask, but it is less relevant
    //so it can wait for later. This will cause some weird issues with the
    //recent model
    if (!c)
-      return;
+      return 0;
 
-   switch(action) {
-      case UserActionModel::Action::ACCEPT          :
-         ret += 0;
-         break;
-      case UserActionModel::Action::HOLD            :
-         ret += c->state() == Call::State::HOLD? 100 : 1;
-         break;
-      case UserActionModel::Action::MUTE_AUDIO      : {
-         auto a = c->firstMedia<Media::Audio>(Media::Media::Direction::OUT);
-         ret += a && a->state() == Media::Media::State::MUTED ? 100 : 1;
-         }
-         break;
-      case UserActionModel::Action::MUTE_VIDEO      : {
-         auto v = c->firstMedia<Media::Video>(Media::Media::Direction::OUT);
-         ret += v && v->state() == Media::Media::State::MUTED ? 100 : 1;
-         }
-         break;
-      case UserActionModel::Action::SERVER_TRANSFER :
-         ret += c->state() == Call::State::TRANSFERRED? 100 : 1;
-         break;
-      case UserActionModel::Action::RECORD          :
-         ret += c->isRecording(Media::Media::Type::AUDIO,Media::Media::Direction::OUT) ? 100 : 1;
-         break;
-      case UserActionModel::Action::HANGUP          :
-         ret += 0;
-         break;
-      case UserActionModel::Action::JOIN            :
-         ret += 0;
-         break;
-      case UserActionModel::Action::ADD_NEW         :
-         ret += 0;
-         break;
-      case UserActionModel::Action::TOGGLE_VIDEO      :
-      case UserActionModel::Action::ADD_CONTACT       :
-      case UserActionModel::Action::ADD_TO_CONTACT    :
-      case UserActionModel::Action::DELETE_CONTACT    :
-      case UserActionModel::Action::EMAIL_CONTACT     :
-      case UserActionModel::Action::COPY_CONTACT      :
-      case UserActionModel::Action::BOOKMARK          :
-      case UserActionModel::Action::VIEW_CHAT_HISTORY :
-      case UserActionModel::Action::ADD_CONTACT_METHOD:
-      case UserActionModel::Action::CALL_CONTACT      :
-      case UserActionModel::Action::EDIT_CONTACT      :
-      case UserActionModel::Action::REMOVE_HISTORY    :
-      case UserActionModel::Action::COUNT__:
-         break;
-   };
+   ActionMask ret = 0;
+
+   if (c->state() == Call::State::HOLD)
+      ret |= bit(UserActionModel::Action::HOLD);
+
+   if (c->state() == Call::State::TRANSFERRED)
+      ret |= bit(UserActionModel::Action::SERVER_TRANSFER);
+
+   auto a = c->firstMedia<Media::Audio>(Media::Media::Direction::OUT);
+   if (a && a->state() == Media::Media::State::MUTED)
+      ret |= bit(UserActionModel::Action::MUTE_AUDIO);
+
+   auto v = c->firstMedia<Media::Video>(Media::Media::Direction::OUT);
+   if (v && v->state() == Media::Media::State::MUTED)
+      ret |= bit(UserActionModel::Action::MUTE_VIDEO);
+
+   if (c->isRecording(Media::Media::Type::AUDIO,Media::Media::Direction::OUT))
+      ret |= bit(UserActionModel::Action::RECORD);
+
+   return ret;
+}
+
+///Update the labels depending on the call state, return those that changed
+UserActionModelPrivate::ActionMask UserActionModelPrivate::updateLabels(const Call* c)
+{
+   if (!c)
+      return 0;
+
+   QString accept, hold, hangup;
 
    //Avoid the noise
    #pragma GCC diagnostic push
    #pragma GCC diagnostic ignored "-Wswitch-enum"
-   //Update the labels
-   switch (action) {
-      case UserActionModel::Action::ACCEPT          :
-         switch(c->state()) {
-            case Call::State::DIALING        :
-               m_ActionNames.setAt(UserActionModel::Action::ACCEPT, QObject::tr("Call"));
-               break;
-            default:
-               m_ActionNames.setAt(UserActionModel::Action::ACCEPT,  QObject::tr("Accept"));
-               break;
-         }
+   switch(c->state()) {
+      case Call::State::DIALING        :
+         accept = QObject::tr("Call");
          break;
-      case UserActionModel::Action::HOLD            :
-         switch(c->state()) {
-            case Call::State::HOLD           :
-            case Call::State::CONFERENCE_HOLD:
-            case Call::State::TRANSF_HOLD    :
-               m_ActionNames.setAt(UserActionModel::Action::HOLD, QObject::tr("Unhold"));
-               break;
-            default:
-               m_ActionNames.setAt(UserActionModel::Action::HOLD, QObject::tr("Hold"));
-               break;
-         }
+      default:
+         accept = QObject::tr("Accept");
          break;
-      case UserActionModel::Action::HANGUP          :
-         switch(c->state()) {
-            case Call::State::DIALING        :
-            case Call::State::NEW            :
-               m_ActionNames.setAt(UserActionModel::Action::HANGUP, QObject::tr("Cancel"));
-               break;
-            case Call::State::FAILURE        :
-            case Call::State::ERROR          :
-            case Call::State::COUNT__        :
-            case Call::State::INITIALIZATION :
-            case Call::State::BUSY           :
-               m_ActionNames.setAt(UserActionModel::Action::HANGUP, QObject::tr("Remove"));
-               break;
-            default:
-               m_ActionNames.setAt(UserActionModel::Action::HANGUP, QObject::tr("Hangup"));
-               break;
-         }
+   }
+
+   switch(c->state()) {
+      case Call::State::HOLD           :
+      case Call::State::CONFERENCE_HOLD:
+      case Call::State::TRANSF_HOLD    :
+         hold = QObject::tr("Unhold");
+         break;
+      default:
+         hold = QObject::tr("Hold");
+         break;
+   }
+
+   switch(c->state()) {
+      case Call::State::DIALING        :
+      case Call::State::NEW            :
+         hangup = QObject::tr("Cancel");
          break;
-      case UserActionModel::Action::JOIN            :
-      case UserActionModel::Action::ADD_NEW         :
-      case UserActionModel::Action::COUNT__         :
-      case UserActionModel::Action::MUTE_AUDIO      :
-      case UserActionModel::Action::MUTE_VIDEO      :
-      case UserActionModel::Action::SERVER_TRANSFER :
-      case UserActionModel::Action::RECORD          :
-      case UserActionModel::Action::TOGGLE_VIDEO      :
-      case UserActionModel::Action::ADD_CONTACT       :
-      case UserActionModel::Action::ADD_TO_CONTACT    :
-      case UserActionModel::Action::DELETE_CONTACT    :
-      case UserActionModel::Action::EMAIL_CONTACT     :
-      case UserActionModel::Action::COPY_CONTACT      :
-      case UserActionModel::Action::BOOKMARK          :
-      case UserActionModel::Action::VIEW_CHAT_HISTORY :
-      case UserActionModel::Action::ADD_CONTACT_METHOD:
-      case UserActionModel::Action::CALL_CONTACT      :
-      case UserActionModel::Action::EDIT_CONTACT      :
-      case UserActionModel::Action::REMOVE_HISTORY    :
+      case Call::State::FAILURE        :
+      case Call::State::ERROR          :
+      case Call::State::COUNT__        :
+      case Call::State::INITIALIZATION :
+      case Call::State::BUSY           :
+         hangup = QObject::tr("Remove");
+         break;
+      default:
+         hangup = QObject::tr("Hangup");
          break;
    }
    #pragma GCC diagnostic pop
-}
 
-bool UserActionModelPrivate::updateByCall(UserActionModel::Action action, const Call* c)
-{
-   if (!c)
-      return false;
-   Account* a = c->account() ? c->account() : AvailableAccountModel::instance().currentDefaultAccount();
-
-   return (
-      availableActionMap        [action] [c->state()             ] &&
-      multi_call_options        [action] [m_SelectionState       ] &&
-      actionContext             [action] & m_fContext              &&
-      updateByAccount(action, a)
-   );
-}
+   ActionMask ret = 0;
 
-bool UserActionModelPrivate::updateByAccount(UserActionModel::Action action, const Account* a)
-{
-   if (!a)
-      return false;
-   return (
-      availableAccountActionMap [action] [a->registrationState() ] &&
-      availableProtocolActions  [action] [a->protocol()          ] //
-   );
-}
+   const QPair<UserActionModel::Action, QString> labels[] = {
+      { UserActionModel::Action::ACCEPT, accept },
+      { UserActionModel::Action::HOLD  , hold   },
+      { UserActionModel::Action::HANGUP, hangup },
+   };
 
-bool UserActionModelPrivate::updateByContactMethod(UserActionModel::Action action, const ContactMethod* cm)
-{
-   if (!cm)
-      return false;
-   Account* a = cm->account() ? cm->account() : AvailableAccountModel::instance().currentDefaultAccount();
+   for (const auto& label : labels) {
+      if (m_ActionNames[label.first] != label.second) {
+         m_ActionNames.setAt(label.first, label.second);
+         ret |= bit(label.first);
+      }
+   }
 
-   return updateByAccount(action, a) && (
-      (!cmActionAvailability[action]) || cmActionAvailability[action](cm)
-   );
+   return ret;
 }
 
-bool UserActionModelPrivate::updateByPerson(UserActionModel::Action action, const Person* p)
+/**
+ * Reduce the selection in a single pass. Each item removes the actions it
+ * doesn't support from the mask, so all actions are evaluated at once and
+ * the per item callbacks are skipped for actions already disabled.
+ */
+void UserActionModelPrivate::updateActions()
 {
-   return (!personActionAvailability[action]) || personActionAvailability[action](p);
-}
+   const Account*       fallback  = AvailableAccountModel::instance().currentDefaultAccount();
+   const SelectionState oldSelection = m_SelectionState;
+
+   ActionMask enabled(0), checked(0), unchecked(0);
+   const Call* labelCall = nullptr;
 
-bool UserActionModelPrivate::updateAction(UserActionModel::Action action)
-{
-   int state = 0;
    switch(m_Mode) {
       case UserActionModelMode::CALL:
-         updateCheckMask(state,action,m_pCall);
-         m_CurrentActionsState.setAt(action,  state / 100 ? Qt::Checked : Qt::Unchecked);
-
-         return updateByCall(action, m_pCall);
+         enabled   = maskByCall(m_pCall, fallback);
+         checked   = checkedByCall(m_pCall) & masks().stateful;
+         labelCall = m_pCall;
+         break;
       case UserActionModelMode::GENERIC: {
-         bool ret = true;
+         QModelIndexList selected;
+
+         if (m_pSelectionModel) {
+            selected = m_pSelectionModel->selectedRows();
+
+            if (selected.isEmpty() && m_pSelectionModel->currentIndex().isValid())
+               selected << m_pSelectionModel->currentIndex();
+         }
 
          m_SelectionState = m_pSelectionModel ? (
-            m_pSelectionModel->selectedRows().size() > 1 ?
+            selected.size() > 1 ?
                SelectionState::MULTI :
                SelectionState::UNIQUE
          ) : SelectionState::NONE ;
 
-         //Aggregate and reduce the action state for each selected calls
-         if (m_pSelectionModel && (m_pSelectionModel->selectedRows().size() || m_pSelectionModel->currentIndex().isValid())) {
-
-            auto selected = m_pSelectionModel->selectedRows();
-
-            if (selected.isEmpty() && m_pSelectionModel->currentIndex().isValid())
-               selected << m_pSelectionModel->currentIndex();
-
-            foreach (const QModelIndex& idx, selected) {
+         if (selected.isEmpty()) {
+            enabled = masks().bySelection[static_cast<int>(SelectionState::NONE)]
+               & (fallback ? masks().byRegistration[static_cast<int>(fallback->registrationState())] : 0);
+            break;
+         }
 
-               const QVariant objTv = idx.data(static_cast<int>(Ring::Role::ObjectType));
+         enabled = ~ActionMask(0);
 
-               //Be sure the model support the UAM abstraction
-               if (!objTv.canConvert<Ring::ObjectType>()) {
-                  qWarning() << "Cannot determine object type";
-                  continue;
-               }
+         //Aggregate and reduce the action state for each selected items
+         for (const QModelIndex& idx : selected) {
 
-               const auto objT =  qvariant_cast<Ring::ObjectType>(objTv);
+            //There is no point in doing further checks
+            if (!enabled)
+               break;
 
-               ret &= availableObjectActions[action][objT];
+            const QVariant objTv = idx.data(static_cast<int>(Ring::Role::ObjectType));
 
-               //There is no point in doing further checks
-               if (!ret) {
-                  continue;
-               }
+            //Be sure the model support the UAM abstraction
+            if (!objTv.canConvert<Ring::ObjectType>()) {
+               qWarning() << "Cannot determine object type";
+               continue;
+            }
 
-               switch(objT) {
-                  case Ring::ObjectType::Person         : {
+            const auto objT = qvariant_cast<Ring::ObjectType>(objTv);
 
-                     const auto p = qvariant_cast<Person*>(idx.data(static_cast<int>(Ring::Role::Object)));
+            enabled &= masks().byObjectType[static_cast<int>(objT)];
 
-                     ret &= updateByPerson( action, p );
+            if (!enabled)
+               continue;
 
-                     break;
-                  }
-                  case Ring::ObjectType::ContactMethod  : {
+            const QVariant obj = idx.data(static_cast<int>(Ring::Role::Object));
 
-                     const auto cm = qvariant_cast<ContactMethod*>(idx.data(static_cast<int>(Ring::Role::Object)));
+            switch(objT) {
+               case Ring::ObjectType::Person         :
+                  enabled &= maskByPerson( qvariant_cast<Person*>(obj), enabled );
+                  break;
+               case Ring::ObjectType::ContactMethod  :
+                  enabled &= maskByContactMethod( qvariant_cast<ContactMethod*>(obj), fallback, enabled );
+                  break;
+               case Ring::ObjectType::Call           : {
+                  const auto c = qvariant_cast<Call*>(obj);
 
-                     ret &= updateByContactMethod( action, cm );
+                  //The check state only account for the actions still enabled
+                  const ActionMask stateful = enabled & masks().stateful;
+                  const ActionMask isChecked = checkedByCall(c);
 
-                     break;
+                  if (c) {
+                     checked   |=  isChecked & stateful;
+                     unchecked |= ~isChecked & stateful;
+                     labelCall  = c;
                   }
-                  case Ring::ObjectType::Call           : {
 
-                     const auto c = qvariant_cast<Call*>(idx.data(static_cast<int>(Ring::Role::Object)));
-
-                     ret &= updateByCall( action, c );
-
-                     updateCheckMask( state ,action, c ); //TODO abstract this out
-
-                     break;
-                  }
-                  case Ring::ObjectType::Media          : //TODO
-                  case Ring::ObjectType::Certificate    : //TODO
-                  case Ring::ObjectType::COUNT__        :
-                     break;
+                  enabled &= maskByCall( c, fallback );
+                  break;
                }
+               case Ring::ObjectType::Media          : //TODO
+               case Ring::ObjectType::Certificate    : //TODO
+               case Ring::ObjectType::COUNT__        :
+                  break;
             }
          }
-         else {
-            Account* a = AvailableAccountModel::instance().currentDefaultAccount();
-            ret = multi_call_options[action][UserActionModelPrivate::SelectionState::NONE]
-               && (a?availableAccountActionMap[action][a->registrationState()]:false);
-         }
 
          //Detect if the multiple selection has mismatching item states, disable it if necessary
-         m_CurrentActionsState.setAt(action, (state % 100 && state / 100) ? Qt::PartiallyChecked : (state / 100 ? Qt::Checked : Qt::Unchecked));
-         return ret && (m_CurrentActionsState[action] != Qt::PartiallyChecked || heterogenous_call_options[action]);
+         enabled &= ~(checked & unchecked) | masks().heterogenous;
+         break;
       }
    };
-   return false;
-}
 
-void UserActionModelPrivate::updateActions()
-{
-   for (UserActionModel::Action action : EnumIterator<UserActionModel::Action>())
-      m_CurrentActions[action] = updateAction(action);
-   emit q_ptr->dataChanged(q_ptr->index(0,0),q_ptr->index(enum_class_size<UserActionModel::Action>()-1,0));
+   const ActionMask partial = checked & unchecked;
+
+   //Only notify the rows that actually changed
+   ActionMask changed = (enabled ^ m_CurrentActions) | updateLabels(labelCall);
+
+   m_CurrentActions = enabled;
+
+   for (const UserActionModel::Action action : EnumIterator<UserActionModel::Action>()) {
+      const Qt::CheckState st = (partial & bit(action)) ? Qt::PartiallyChecked :
+         ((checked & bit(action)) ? Qt::Checked : Qt::Unchecked);
+
+      if (m_CurrentActionsState[action] != st) {
+         m_CurrentActionsState.setAt(action, st);
+         changed |= bit(action);
+      }
+   }
+
+   //The statefulness, and thus the flags, depends on the selection
+   if (oldSelection != m_SelectionState)
+      changed = ~ActionMask(0);
+
+   for (int first = 0; first < enum_class_size<UserActionModel::Action>(); first++) {
+      if (!(changed & (ActionMask(1) << first)))
+         continue;
+
+      int last = first;
+      while (last+1 < enum_class_size<UserActionModel::Action>() && (changed & (ActionMask(1) << (last+1))))
+         last++;
+
+      emit q_ptr->dataChanged(q_ptr->index(first,0), q_ptr->index(last,0));
+      first = last;
+   }
 }
 
 uint UserActionModel::relativeIndex( UserActionModel::Action action ) const